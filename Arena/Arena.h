@@ -0,0 +1,119 @@
+//
+//  Arena.h
+//
+//
+//  Bump allocator over one contiguous block: every buffer of a stream (the
+//  window and peak arrays of its FLWT, the buffers of its PSOLAs, the median
+//  buffer) comes out of a single block, so creating the stream costs one
+//  allocation, destroying it one free, and its state sits on adjacent
+//  cache lines instead of wherever the heap put each array.
+//
+//
+
+#ifndef ____Arena__
+#define ____Arena__
+
+#include <stddef.h>
+#include <new>
+#if __cplusplus >= 201103L
+#include <type_traits>
+#endif
+
+// Every allocation starts on its own cache line, so two objects sharing a
+//  block (e.g. the FLWT of one thread and the PSOLA of another) never share
+//  a line. The device has no cache and may define it as small as 2.
+#ifndef ARENA_ALIGNMENT
+#define ARENA_ALIGNMENT     64
+#endif
+
+/**
+ * @brief      Bump allocator over one contiguous, ARENA_ALIGNMENT aligned block.
+ *
+ * @details    Allocations are never freed one by one: reset() or the
+ *             destruction of the arena gives the whole block back at once,
+ *             and whatever was built in it must not be used afterwards. The
+ *             objects built in an arena (BasicFLWT, BasicPSOLA) size it with
+ *             their getArenaSize().
+ *
+ * Note the following example code:
+ * @code
+ *    Arena arena(FLWT::getArenaSize(6, 512) + PSOLA::getArenaSize(512));
+ *    FLWT flwt(6, 512, arena);
+ *    PSOLA psola(512, arena);
+ * @endcode
+ */
+class Arena {
+public:
+    // Allocates a block of size bytes
+    Arena(size_t size) {
+        _memory = new char[size + ARENA_ALIGNMENT - 1];
+        _block = align(_memory);
+        _size = size;
+        _used = 0;
+    }
+    // Uses a block owned by the caller (e.g. a static array on the device); its
+    //  first bytes may be skipped to align it
+    Arena(void* block, size_t size) {
+        _memory = 0;
+        _block = align((char*)block);
+        size_t skipped = _block - (char*)block;
+        _size = (size > skipped) ? size - skipped : 0;
+        _used = 0;
+    }
+    ~Arena() { delete[] _memory; }
+    // size bytes on a new cache line, or 0 if the block is full
+    void* allocate(size_t size) {
+        size = roundUp(size);
+        // Error Handle
+        if (size > _size - _used) {
+            return 0;
+        }
+        void* p = _block + _used;
+        _used += size;
+        return p;
+    }
+    // Room for n Ts, or 0 if the block is full. Like new T[n], nothing is
+    //  written for plain types (their owner initializes them); only a T with
+    //  a constructor of its own is built
+    template<class T> T* allocateArray(int n) {
+        T* p = (T*)allocate(sizeOfArray<T>(n));
+#if __cplusplus >= 201103L
+        if (std::is_trivially_default_constructible<T>::value) {
+            return p;
+        }
+#endif
+        if (p) {
+            for (int i = 0; i < n; i++) {
+                new (p + i) T;
+            }
+        }
+        return p;
+    }
+    // Forgets every allocation (nothing is destroyed)
+    void reset() { _used = 0; }
+    size_t getSize() const { return _size; }
+    size_t getUsed() const { return _used; }
+    size_t getRemaining() const { return _size - _used; }
+    const void* getBlock() const { return _block; }
+    // Space an allocation of size bytes takes in an arena
+    static size_t roundUp(size_t size) {
+        return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    }
+    template<class T> static size_t sizeOfArray(int n) {
+        return roundUp((n > 0) ? n*sizeof(T) : 0);
+    }
+
+private:
+    // Not copyable: the copy would free the block twice
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+    static char* align(char* p) {
+        return p + ((ARENA_ALIGNMENT - (size_t)p % ARENA_ALIGNMENT) % ARENA_ALIGNMENT);
+    }
+    char* _memory;      // owned block, 0 if the caller's
+    char* _block;       // first aligned byte
+    size_t _size;
+    size_t _used;
+};
+
+#endif /* defined(____Arena__) */
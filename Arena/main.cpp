@@ -0,0 +1,133 @@
+//
+//  main.cpp
+//
+//
+//  Builds the FLWT and the two PSOLAs of many streams on the heap and in one
+//  arena block per stream, checks that both give the same pitches and
+//  samples, that an arena too small falls back to the heap, and times the
+//  creation and destruction of the streams both ways.
+//  Build: g++ -std=c++11 -O2 -I. -I../FLWT -I../PSOLA -I../FixedPoint -I../Profiler -I../CostModel main.cpp
+//         ../FLWT/FLWT.cpp ../PSOLA/PSOLA.cpp
+//  Usage: a.out [streams]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "Arena.h"
+#include "FLWT.h"
+#include "PSOLA.h"
+#include <iostream>
+#include <chrono>
+
+using namespace std;
+
+const int blockLength = 512;
+const int levels = 6;
+const long fs = 16000;
+const int blocks = 8;
+const int defaultStreams = 4096;
+
+// What a stream holds: a FLWT and a PSOLA per channel
+struct HeapStream {
+    FLWT flwt;
+    PSOLA left;
+    PSOLA right;
+    HeapStream() : flwt(levels, blockLength), left(blockLength), right(blockLength) {}
+};
+
+struct ArenaStream {
+    Arena arena;
+    FLWT flwt;
+    PSOLA left;
+    PSOLA right;
+    ArenaStream() : arena(getSize()), flwt(levels, blockLength, arena), left(blockLength, arena),
+                    right(blockLength, arena) {}
+    static size_t getSize() { return FLWT::getArenaSize(levels, blockLength) + 2*PSOLA::getArenaSize(blockLength); }
+};
+
+// A block of a 220 Hz voice gliding up
+void makeBlock(int b, int* block) {
+    for (int i = 0; i < blockLength; i++) {
+        double t = (double)(b*blockLength + i)/fs;
+        double f = 220*(1 + 0.05*t);
+        block[i] = (int)(8000*sin(2*M_PI*f*t) + 3000*sin(4*M_PI*f*t));
+    }
+}
+
+template<class Stream> long run(Stream& stream, int* outputs) {
+    int block[blockLength];
+    long pitches = 0;
+    for (int b = 0; b < blocks; b++) {
+        makeBlock(b, block);
+        float pitch = stream.flwt.getPitchWithMedian5(block, blockLength, fs);
+        pitches = pitches*31 + (long)(pitch*100);
+        stream.left.pitchCorrect(block, fs, pitch, pitch*1.06f);
+        stream.right.pitchCorrect(block, fs, pitch, pitch*0.94f);
+        for (int i = 0; i < blockLength; i++) {
+            outputs[b*blockLength + i] = block[i];
+        }
+    }
+    return pitches;
+}
+
+int main(int argc, char** argv) {
+    cout<<endl<<"Arena Testing: "<<endl<<endl;
+    int streams = (argc > 1) ? atoi(argv[1]) : defaultStreams;
+    if (streams < 1) {
+        streams = defaultStreams;
+    }
+    int failures = 0;
+    printf("one stream: %lu bytes in one block (ARENA_ALIGNMENT %d)\n", (unsigned long)ArenaStream::getSize(),
+           ARENA_ALIGNMENT);
+
+    // Same outputs on the heap, in an arena, and in an arena with only room for
+    //  the FLWT (the PSOLAs fall back to the heap)
+    static int heapOutputs[blocks*blockLength], arenaOutputs[blocks*blockLength], smallOutputs[blocks*blockLength];
+    HeapStream heap;
+    ArenaStream inArena;
+    long heapPitches = run(heap, heapOutputs);
+    long arenaPitches = run(inArena, arenaOutputs);
+    Arena small(PSOLA::getArenaSize(blockLength));
+    FLWT smallFLWT(levels, blockLength, small);
+    PSOLA smallLeft(blockLength, small);
+    PSOLA smallRight(blockLength, small);
+    struct { FLWT& flwt; PSOLA& left; PSOLA& right; } fallback = {smallFLWT, smallLeft, smallRight};
+    long smallPitches = run(fallback, smallOutputs);
+    bool same = heapPitches == arenaPitches && heapPitches == smallPitches;
+    for (int i = 0; i < blocks*blockLength; i++) {
+        same = same && heapOutputs[i] == arenaOutputs[i] && heapOutputs[i] == smallOutputs[i];
+    }
+    printf("heap, arena and arena too small: %s\n", same ? "same pitches and samples" : "DIFFERENT  FAIL");
+    failures += !same;
+    bool used = inArena.arena.getUsed() == ArenaStream::getSize() && small.getUsed() == FLWT::getArenaSize(levels, blockLength);
+    printf("arena used: %lu of %lu bytes, small arena: %lu of %lu  %s\n", (unsigned long)inArena.arena.getUsed(),
+           (unsigned long)inArena.arena.getSize(), (unsigned long)small.getUsed(), (unsigned long)small.getSize(),
+           used ? "ok" : "FAIL");
+    failures += !used;
+
+    // Creation and destruction of many streams
+    HeapStream** heapStreams = new HeapStream*[streams];
+    ArenaStream** arenaStreams = new ArenaStream*[streams];
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int s = 0; s < streams; s++) {
+        heapStreams[s] = new HeapStream;
+    }
+    for (int s = 0; s < streams; s++) {
+        delete heapStreams[s];
+    }
+    double heapSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    start = chrono::steady_clock::now();
+    for (int s = 0; s < streams; s++) {
+        arenaStreams[s] = new ArenaStream;
+    }
+    for (int s = 0; s < streams; s++) {
+        delete arenaStreams[s];
+    }
+    double arenaSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    printf("%d streams created and destroyed: heap %.2f us (15 allocations), arena %.2f us (2 allocations) each\n",
+           streams, 1e6*heapSeconds/streams, 1e6*arenaSeconds/streams);
+    delete[] heapStreams;
+    delete[] arenaStreams;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,151 @@
+/**
+ *   @mainpage Lock-Free Audio Block Ring
+ *
+ *   \section desc_sec Description
+ *   A single-producer/single-consumer queue of stereo audio blocks that lets
+ *      the DMA interrupt hand buffers to a processing loop (and take the
+ *      results back) without ever waiting on it. The interrupt only copies a
+ *      block in or out of the ring, so a slow frame in the processing loop
+ *      no longer delays the next DMA transfer.
+ *
+ *  @n Each index is written by one side only, so no locks are needed. On the
+ *      C5535 the interrupt and loop() share one core and volatile indices are
+ *      enough; on a host with C++11 the indices are atomics with
+ *      acquire/release ordering so the ring also works between threads.
+ *
+ *  @n The ring counts overruns (the producer found it full) and underruns
+ *      (the consumer found it empty). Together with the depth and the number
+ *      of blocks primed at start-up, they show how much latency buys how
+ *      much processing headroom: each primed block adds one block of latency
+ *      and lets one block take one period longer to process.
+ *
+ *  \section contents_sec Table of Contents
+ *    AudioRing.cpp
+ *
+ *    AudioRing.h
+ *
+ */
+
+/**
+ *  @file AudioRing.cpp
+ *  @brief Source file for AudioRing
+ *  @file AudioRing.h
+ *  @brief Header file for AudioRing
+ */
+
+#include "AudioRing.h"
+
+/** ==============================================================================
+ * @brief       Allocates the ring.
+ *
+ * @details     One extra slot is allocated so that a full ring can be told
+ *              apart from an empty one without a shared counter.
+ *
+ * @param       depth           Number of blocks the ring can hold
+ * @param       blockLength     Samples per channel in a block
+ * ================================================================================
+ */
+AudioRing::AudioRing(int depth, int blockLength) {
+    // Error Handle
+    if (depth < 1) {
+        depth = DEFAULT_RING_DEPTH;
+    }
+    _slots = depth + 1;
+    _blockLength = blockLength;
+    _data = new int[_slots*2*blockLength]();
+    RING_STORE(_head, 0);
+    RING_STORE(_tail, 0);
+    _overruns = 0;
+    _underruns = 0;
+}
+
+/** Standard destructor */
+AudioRing::~AudioRing() {
+    delete[] _data;
+}
+
+/** ====================================================
+ * @brief       Returns the next free block (producer side).
+ *
+ * @details     The left channel is the first blockLength samples, the right
+ *              channel the next blockLength. The block is only visible to
+ *              the consumer after AudioRing::commitWrite().
+ *
+ * @return      Pointer to the block, or 0 if the ring is full
+ * ======================================================
+ */
+int* AudioRing::writeSlot() {
+    int head = RING_LOAD(_head);
+    if (next(head) == RING_LOAD(_tail)) {
+        _overruns++;
+        return 0;
+    }
+    return _data + head*2*_blockLength;
+}
+
+/** Publishes the block returned by AudioRing::writeSlot() */
+void AudioRing::commitWrite() {
+    RING_STORE(_head, next(RING_LOAD(_head)));
+}
+
+/** ====================================================
+ * @brief       Returns the oldest block (consumer side).
+ *
+ * @details     The block stays valid until AudioRing::commitRead().
+ *
+ * @return      Pointer to the block, or 0 if the ring is empty
+ * ======================================================
+ */
+int* AudioRing::readSlot() {
+    int tail = RING_LOAD(_tail);
+    if (tail == RING_LOAD(_head)) {
+        _underruns++;
+        return 0;
+    }
+    return _data + tail*2*_blockLength;
+}
+
+/** Releases the block returned by AudioRing::readSlot() */
+void AudioRing::commitRead() {
+    RING_STORE(_tail, next(RING_LOAD(_tail)));
+}
+
+/** ====================================================
+ * @brief       Queues blocks of silence (producer side).
+ *
+ * @param       blocks      Number of blocks to queue
+ *
+ * @return      Number of blocks queued (limited by the free space)
+ * ======================================================
+ */
+int AudioRing::prime(int blocks) {
+    int queued = 0;
+    while (queued < blocks && space() > 0) {
+        int* block = writeSlot();
+        for (int i = 0; i < 2*_blockLength; i++) {
+            block[i] = 0;
+        }
+        commitWrite();
+        queued++;
+    }
+    return queued;
+}
+
+/** Empties the ring and clears the counters (only while neither side is using it) */
+void AudioRing::reset() {
+    RING_STORE(_head, 0);
+    RING_STORE(_tail, 0);
+    _overruns = 0;
+    _underruns = 0;
+}
+
+/** Number of blocks waiting to be read */
+int AudioRing::count() const {
+    int n = RING_LOAD(_head) - RING_LOAD(_tail);
+    return (n < 0) ? n + _slots : n;
+}
+
+/** Number of blocks that can be written */
+int AudioRing::space() const {
+    return _slots - 1 - count();
+}
@@ -0,0 +1,60 @@
+//
+//  AudioRing.h
+//
+//
+//  Single-producer/single-consumer lock-free queue of stereo audio blocks.
+//
+//
+
+#ifndef ____AudioRing__
+#define ____AudioRing__
+
+#include <stdio.h>
+
+#if __cplusplus >= 201103L
+#include <atomic>
+typedef std::atomic<int> RingIndex;
+#define RING_LOAD(index)            (index).load(std::memory_order_acquire)
+#define RING_STORE(index, value)    (index).store((value), std::memory_order_release)
+#else
+// One core: the ISR and loop() only need the compiler to not cache the indices
+typedef volatile int RingIndex;
+#define RING_LOAD(index)            (index)
+#define RING_STORE(index, value)    ((index) = (value))
+#endif
+
+#define DEFAULT_RING_DEPTH  2
+
+class AudioRing {
+public:
+    // depth = number of blocks the ring can hold, blockLength = samples per channel
+    AudioRing(int depth, int blockLength);
+    ~AudioRing();
+    // Producer: block to fill (left, then right) or 0 if the ring is full (counts an overrun)
+    int* writeSlot();
+    void commitWrite();
+    // Consumer: oldest block (left, then right) or 0 if the ring is empty (counts an underrun)
+    int* readSlot();
+    void commitRead();
+    // Queues blocks of silence, e.g. to buy the consumer some latency up front
+    int prime(int blocks);
+    void reset();
+    int count() const;
+    int space() const;
+    int getDepth() const { return _slots - 1; }
+    int getBlockLength() const { return _blockLength; }
+    long getOverruns() const { return _overruns; }
+    long getUnderruns() const { return _underruns; }
+
+private:
+    int next(int index) const { return (index + 1 == _slots) ? 0 : index + 1; }
+    int* _data;
+    int _slots;
+    int _blockLength;
+    RingIndex _head;    // written by the producer only
+    RingIndex _tail;    // written by the consumer only
+    volatile long _overruns;
+    volatile long _underruns;
+};
+
+#endif /* defined(____AudioRing__) */
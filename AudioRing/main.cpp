@@ -0,0 +1,52 @@
+//
+//  main.cpp
+//
+//
+//  Pushes numbered blocks from one thread to another through the ring.
+//  Build: g++ -std=c++11 -pthread main.cpp AudioRing.cpp
+//
+
+#include <stdio.h>
+#include "AudioRing.h"
+#include <iostream>
+#include <thread>
+
+using namespace std;
+
+int blockLength = 512;
+int numBlocks = 100000;
+
+int main() {
+    cout<<endl<<"AudioRing Testing: "<<endl<<endl;
+    AudioRing ring(4, blockLength);
+    long errors = 0;
+    thread consumer([&]() {
+        int expected = 0;
+        while (expected < numBlocks) {
+            if (ring.count() == 0) {
+                this_thread::yield();
+                continue;
+            }
+            int* block = ring.readSlot();
+            if (block[0] != expected || block[2*blockLength - 1] != expected) {
+                errors++;
+            }
+            ring.commitRead();
+            expected++;
+        }
+    });
+    for (int n = 0; n < numBlocks; n++) {
+        int* block;
+        while ((block = ring.writeSlot()) == 0) {
+            this_thread::yield();
+        }
+        for (int i = 0; i < 2*blockLength; i++) {
+            block[i] = n;
+        }
+        ring.commitWrite();
+    }
+    consumer.join();
+    cout << "blocks = " << numBlocks << ", out of order = " << errors
+         << ", producer found the ring full " << ring.getOverruns() << " times" << endl << endl;
+    return 0;
+}
@@ -0,0 +1,315 @@
+/**
+ *   @mainpage DSP Shield Audio Simulator
+ *
+ *   \section desc_sec Description
+ *   Runs a sketch's DMA interrupt service routine on a Linux host. This file
+ *      implements the parts of AudioClass (Audio_new.h) that the sketches use
+ *      on top of plain memory: the codec input and output ping-pong buffers
+ *      (audioInLeft[2], audioOutLeft[2], ...), activeInBuf/activeOutBuf and
+ *      the interrupt that is attached with AudioC.attachIntr().
+ *
+ *  @n A timer thread plays a WAV file into the input buffers at the codec
+ *      sampling rate selected with AudioC.setupCodec(), raises the read and
+ *      write DMA interrupts in the same order as the hardware and records
+ *      what the codec would have played. The time spent in the read
+ *      interrupt, which is where the sketch calls processData(), is compared
+ *      against the buffer period to count deadline misses and to build a
+ *      histogram of the slack that was left.
+ *
+ *  \section contents_sec Table of Contents
+ *    AudioSim.cpp
+ *
+ *    AudioSim.h
+ *
+ */
+
+/**
+ *  @file AudioSim.cpp
+ *  @brief Source file for AudioSim and the host AudioClass
+ *  @file AudioSim.h
+ *  @brief Header file for AudioSim
+ */
+
+#include "AudioSim.h"
+#include "core.h"
+#include "OLED.h"
+#include "Audio_new.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <string.h>
+
+#define WAV_READ_FRAMES         4096
+#define DEFAULT_SAMPLE_RATE     SAMPLING_RATE_48_KHZ
+
+typedef std::chrono::steady_clock Clock;
+
+// Globals the sketches expect from the core libraries ==================
+
+AudioClass AudioC;
+DMAClass DMA;
+SerialClass Serial;
+OLEDClass disp;
+
+static Clock::time_point startTime = Clock::now();
+
+unsigned long micros() {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - startTime).count();
+}
+
+void OLEDClass::print(const char* text) {
+    if (verbose) {
+        fprintf(stderr, "[OLED] %s\n", text);
+    }
+}
+
+// Simulated codec state ==================
+
+static void (*simIsr)(void) = 0;
+static long simSampleRate = DEFAULT_SAMPLE_RATE;
+static int simBufferLength = I2S_DMA_BUF_LEN;
+
+// AudioClass =============================
+
+int AudioClass::Audio(int process, int adc_buffer_size, int dac_buffer_size) {
+    (void)process;
+    (void)dac_buffer_size;
+    simBufferLength = adc_buffer_size;
+    for (int i = 0; i < 2; i++) {
+        audioInLeft[i] = new Uint16[simBufferLength]();
+        audioInRight[i] = new Uint16[simBufferLength]();
+        audioOutLeft[i] = new Uint16[simBufferLength]();
+        audioOutRight[i] = new Uint16[simBufferLength]();
+    }
+    activeInBuf = 0;
+    activeOutBuf = 0;
+    return 0;
+}
+
+void AudioClass::attachIntr(AudioIsr function) {
+    simIsr = function;
+}
+
+void AudioClass::detachIntr(void) {
+    simIsr = 0;
+}
+
+void AudioClass::isrDma(void) {
+    // Acknowledge the interrupt
+    DMA.setInterruptStatus(0);
+}
+
+int AudioClass::setupCodec(long samplingRate, int adcProcessingBlock, int dacProcessingBlock) {
+    (void)adcProcessingBlock;
+    (void)dacProcessingBlock;
+    simSampleRate = samplingRate;
+    return 0;
+}
+
+int AudioClass::setSamplingRate(long samplingRate) {
+    simSampleRate = samplingRate;
+    return 0;
+}
+
+int AudioClass::setInputGain(int lgain, int rgain) {
+    (void)lgain;
+    (void)rgain;
+    return 0;
+}
+
+int AudioClass::setOutputVolume(int volume) {
+    (void)volume;
+    return 0;
+}
+
+AudioClass::~AudioClass(void) {
+    if (!audioInLeft[0]) {
+        return;
+    }
+    for (int i = 0; i < 2; i++) {
+        delete[] audioInLeft[i];
+        delete[] audioInRight[i];
+        delete[] audioOutLeft[i];
+        delete[] audioOutRight[i];
+    }
+}
+
+// AudioSim ===============================
+
+AudioSim::AudioSim() {
+    _loop = 0;
+}
+
+long AudioSim::getSampleRate() {
+    return simSampleRate;
+}
+
+int AudioSim::getBufferLength() {
+    return simBufferLength;
+}
+
+/** ====================================================
+ * @brief       Plays a WAV file through the attached DMA ISR.
+ *
+ * @details     For every buffer period the timer thread
+ *              <ol>
+ *                 <li> fills audioInLeft/Right[activeInBuf] with the next
+ *                      input samples (linearly resampled to the codec rate)
+ *                 <li> raises the DMA read interrupt and times the ISR
+ *                 <li> swaps the output buffers, records the one that the
+ *                      codec starts playing and raises the DMA write interrupt
+ *              </ol>
+ *              In real time mode the interrupts are raised at the codec rate,
+ *              so an ISR that overruns delays the next interrupt exactly as
+ *              it would on the board.
+ *
+ *              If a loop function was set with AudioSim::setLoop(), it runs
+ *              in its own thread next to the interrupts in real time mode.
+ *              Otherwise it is called once after every read interrupt and its
+ *              time is added to the processing time of that buffer, which is
+ *              how long a sketch that defers its processing to loop() needs
+ *              per buffer.
+ *
+ * @param       input       WAV file to play (read from its current position)
+ * @param       output      Where to record the codec output (may be 0)
+ * @param       realTime    Pace the interrupts at the sampling rate
+ * @param       stats       Filled with the deadline accounting of the run
+ *
+ * @return      0 on success, -1 if no ISR is attached
+ * ======================================================
+ */
+int AudioSim::run(WavReader& input, WavWriter* output, bool realTime, AudioSimStats& stats) {
+    memset(&stats, 0, sizeof(stats));
+    if (!simIsr || !AudioC.audioInLeft[0]) {
+        return -1;
+    }
+    const int len = simBufferLength;
+    stats.sampleRate = simSampleRate;
+    stats.periodUs = 1e6*len/simSampleRate;
+
+    std::atomic<bool> running(true);
+    std::thread background;
+    if (_loop && realTime) {
+        background = std::thread([&]() {
+            while (running.load(std::memory_order_acquire)) {
+                _loop();
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    std::thread timer([&]() {
+        int* wavLeft = new int[WAV_READ_FRAMES + 1];
+        int* wavRight = new int[WAV_READ_FRAMES + 1];
+        int* outLeft = new int[len];
+        int* outRight = new int[len];
+        int wavFrames = 0;
+        // Position in the input, in input frames relative to wavLeft[0]
+        double position = 0.0;
+        double step = (double)input.getSampleRate()/simSampleRate;
+        bool done = false;
+        Clock::duration period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::micro>(stats.periodUs));
+        Clock::time_point next = Clock::now();
+
+        while (!done) {
+            // The DMA fills the other input buffer while the ISR works on this one
+            AudioC.activeInBuf = AudioC.activeInBuf ? 0 : 1;
+            Uint16* inLeft = AudioC.audioInLeft[AudioC.activeInBuf];
+            Uint16* inRight = AudioC.audioInRight[AudioC.activeInBuf];
+            for (int i = 0; i < len; i++) {
+                // Keep two input frames around the read position
+                while ((int)position + 1 >= wavFrames && !done) {
+                    int keep = 0;
+                    if (wavFrames > 0) {
+                        wavLeft[0] = wavLeft[wavFrames - 1];
+                        wavRight[0] = wavRight[wavFrames - 1];
+                        position -= wavFrames - 1;
+                        keep = 1;
+                    }
+                    int got = input.read(wavLeft + keep, wavRight + keep, WAV_READ_FRAMES);
+                    wavFrames = keep + got;
+                    done = (got == 0);
+                }
+                if (done) {
+                    inLeft[i] = 0;
+                    inRight[i] = 0;
+                    continue;
+                }
+                int index = (int)position;
+                double frac = position - index;
+                inLeft[i] = (Uint16)(short)(wavLeft[index] + frac*(wavLeft[index + 1] - wavLeft[index]));
+                inRight[i] = (Uint16)(short)(wavRight[index] + frac*(wavRight[index + 1] - wavRight[index]));
+                position += step;
+            }
+
+            if (realTime) {
+                Clock::time_point now = Clock::now();
+                if (now > next + period/10) {
+                    stats.lateStarts++;
+                    next = now;
+                } else {
+                    std::this_thread::sleep_until(next);
+                }
+                next += period;
+            }
+
+            // Read interrupt: the sketch copies the input and processes it
+            DMA.setInterruptStatus(1 << DMA_CHAN_ReadR);
+            Clock::time_point start = Clock::now();
+            simIsr();
+            if (_loop && !realTime) {
+                _loop();
+            }
+            double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+            stats.buffers++;
+            stats.totalUs += us;
+            if (us > stats.worstUs) {
+                stats.worstUs = us;
+            }
+            double slack = stats.periodUs - us;
+            int bin = 0;
+            if (slack < 0) {
+                stats.deadlineMisses++;
+            } else {
+                bin = 1 + (int)(10*slack/stats.periodUs);
+                if (bin >= AUDIO_SIM_SLACK_BINS) {
+                    bin = AUDIO_SIM_SLACK_BINS - 1;
+                }
+            }
+            stats.slackHistogram[bin]++;
+
+            // Write interrupt: the codec starts playing the other output buffer
+            AudioC.activeOutBuf = AudioC.activeOutBuf ? 0 : 1;
+            if (output) {
+                copyShortBuf(AudioC.audioOutLeft[AudioC.activeOutBuf], outLeft, len);
+                copyShortBuf(AudioC.audioOutRight[AudioC.activeOutBuf], outRight, len);
+                output->write(outLeft, outRight, len);
+            }
+            DMA.setInterruptStatus(1 << DMA_CHAN_WriteR);
+            simIsr();
+        }
+        delete[] wavLeft;
+        delete[] wavRight;
+        delete[] outLeft;
+        delete[] outRight;
+    });
+    timer.join();
+    running.store(false, std::memory_order_release);
+    if (background.joinable()) {
+        background.join();
+    }
+    return 0;
+}
+
+/** Prints the deadline accounting of a run */
+void AudioSim::printStats(const char* name, const AudioSimStats& stats) {
+    printf("%-14s fs=%6ld period=%8.1fus buffers=%6ld mean=%8.1fus worst=%8.1fus misses=%ld late=%ld\n",
+           name, stats.sampleRate, stats.periodUs, stats.buffers,
+           stats.buffers ? stats.totalUs/stats.buffers : 0.0, stats.worstUs,
+           stats.deadlineMisses, stats.lateStarts);
+    printf("%-14s slack: miss=%ld", "", stats.slackHistogram[0]);
+    for (int bin = 1; bin < AUDIO_SIM_SLACK_BINS; bin++) {
+        printf(" %d%%=%ld", (bin - 1)*10, stats.slackHistogram[bin]);
+    }
+    printf("\n");
+}
@@ -0,0 +1,45 @@
+//
+//  AudioSim.h
+//
+//
+//  Host stand-in for the DSP Shield audio path (AudioClass + DMA ISR).
+//
+//
+
+#ifndef ____AudioSim__
+#define ____AudioSim__
+
+#include "WavFile.h"
+
+/** Bin 0 counts deadline misses, bin n counts buffers with (n-1)*10% to n*10% of the period left over */
+#define AUDIO_SIM_SLACK_BINS    11
+
+struct AudioSimStats {
+    long sampleRate;        // codec sampling rate during the run
+    double periodUs;        // time between two DMA interrupts
+    long buffers;           // buffers processed
+    long deadlineMisses;    // buffers that took longer than periodUs
+    long lateStarts;        // interrupts raised late because the previous one overran (real time only)
+    double totalUs;         // processing time of all buffers
+    double worstUs;         // longest processing time
+    long slackHistogram[AUDIO_SIM_SLACK_BINS];
+};
+
+class AudioSim {
+public:
+    AudioSim();
+    // Plays input through the ISR attached to AudioC, returns 0 on success.
+    // realTime = false raises the interrupts back to back instead of at the sampling rate.
+    int run(WavReader& input, WavWriter* output, bool realTime, AudioSimStats& stats);
+    static void printStats(const char* name, const AudioSimStats& stats);
+    // Main loop of the sketch (e.g. loop()), run next to the interrupts during run()
+    void setLoop(void (*loopFunction)(void)) { _loop = loopFunction; }
+    // Codec sampling rate last set through AudioC.setupCodec()
+    static long getSampleRate();
+    static int getBufferLength();
+
+private:
+    void (*_loop)(void);
+};
+
+#endif /* defined(____AudioSim__) */
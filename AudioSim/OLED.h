@@ -0,0 +1,24 @@
+//
+//  OLED.h
+//
+//
+//  Host stand-in for the DSP Shield OLED library: prints to stderr when
+//  AudioSim is run verbosely, otherwise does nothing.
+//
+
+#ifndef ____AudioSim_OLED__
+#define ____AudioSim_OLED__
+
+class OLEDClass {
+public:
+    OLEDClass() : verbose(false) {}
+    void oledInit() {}
+    void clear() {}
+    void flip() {}
+    void setline(int) {}
+    void print(const char* text);
+    bool verbose;
+};
+extern OLEDClass disp;
+
+#endif /* defined(____AudioSim_OLED__) */
@@ -0,0 +1,81 @@
+//
+//  core.h
+//
+//
+//  Host stand-in for the DSP Shield core header. Only what the sketches
+//  and Audio_new.h use is declared here; it is only on the include path
+//  of the AudioSim build, never on the device.
+//
+
+#ifndef ____AudioSim_core__
+#define ____AudioSim_core__
+
+#include <stdio.h>
+
+typedef unsigned short  Uint16;
+typedef unsigned int    Uint32;
+typedef short           Int16;
+typedef int             Int32;
+
+#ifndef TRUE
+#define TRUE    1
+#endif
+#ifndef FALSE
+#define FALSE   0
+#endif
+
+#define HIGH    1
+#define LOW     0
+#define OUTPUT  1
+#define INPUT   0
+#define LED0    0
+#define LED1    1
+#define LED2    2
+
+#define CSL_DMA_CHAN4   4
+#define CSL_DMA_CHAN5   5
+#define CSL_DMA_CHAN6   6
+#define CSL_DMA_CHAN7   7
+
+// The C55x interrupt keyword has no meaning on the host
+#define interrupt
+
+/** DMA controller: only the interrupt flags the ISR looks at */
+class DMAClass {
+public:
+    DMAClass() : _ifr(0) {}
+    Uint16 getInterruptStatus() { return _ifr; }
+    // Used by the simulator to raise a channel interrupt
+    void setInterruptStatus(Uint16 ifr) { _ifr = ifr; }
+private:
+    volatile Uint16 _ifr;
+};
+extern DMAClass DMA;
+
+/** Serial port: output is discarded and nothing is ever received */
+class SerialClass {
+public:
+    void begin(long) {}
+    void setTimeout(long) {}
+    int available() { return 0; }
+    int readBytes(char*, int) { return 0; }
+    int write(const char*, int len) { return len; }
+    int print(const char*) { return 0; }
+    int println(const char*) { return 0; }
+};
+extern SerialClass Serial;
+
+// Codec samples are 16 bits; int is wider on the host, so sign extend on the
+//  way in and wrap on the way out like the 16-bit int of the C5535 would
+inline void copyShortBuf(const Uint16* src, int* dst, int len) {
+    for (int i = 0; i < len; i++) dst[i] = (short)src[i];
+}
+inline void copyShortBuf(const int* src, Uint16* dst, int len) {
+    for (int i = 0; i < len; i++) dst[i] = (Uint16)src[i];
+}
+
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+unsigned long micros();
+
+#endif /* defined(____AudioSim_core__) */
@@ -0,0 +1,135 @@
+//
+//  main.cpp
+//
+//
+//  Runs the unmodified FinalDemo sketch on the host and reports the
+//  deadline accounting of every mode.
+//
+//  Build (from this directory):
+//    g++ -std=c++11 -O2 -Wno-unknown-pragmas -pthread
+//        -I. -I"../Version Final/FinalDemo" -I../WavFile
+//        main.cpp AudioSim.cpp ../WavFile/WavFile.cpp
+//        "../Version Final/FinalDemo/"{FLWT,PSOLA,Frequency,KeyDetector,AudioRing,QualityScheduler,Resampler,ControlPlane,Telemetry,serial_array}.cpp
+//        -o audiosim
+//
+//  Usage: audiosim input.wav [-f] [-v] [-o prefix] [-t log] [-m mode]...
+//    -f         raise the interrupts back to back instead of in real time
+//    -v         print what the sketch writes to the OLED
+//    -o prefix  record the codec output of each mode to prefix_<mode>.wav
+//    -t log     log the telemetry of every frame to a binary file
+//    -m mode    only run this mode (0-4), may be repeated
+//
+
+// The Energia IDE generates prototypes for the functions of a sketch
+void setup();
+void loop();
+void processData(const int *inputLeft, const int *inputRight, int *outputLeft, int *outputRight);
+void dmaIsr(void);
+void parse(int c);
+void processQueuedBlocks();
+void sendTelemetry();
+void phaseVocoder(int *outputLeft, int *outputRight);
+long workingRateOf(int status);
+int codecSamplesPerBlock(int status);
+void startWorkingRate(int status);
+void applyParams();
+void processCodecBlock(const int *inputLeft, const int *inputRight, int *outputLeft, int *outputRight);
+void setModeSamplingRate(long rate);
+float detectPitch(int *data, long fs);
+
+#include "FinalDemo.ino"
+#include "AudioSim.h"
+#include "WavFile.h"
+#include <stdlib.h>
+#include <string.h>
+
+const char* statusNames[] = {"NORMAL_MODE","PHASE_VOCODER","OCTAVE_UP","OCTAVE_DOWN","PITCH_DETECT"};
+const int numStatus = sizeof(statusNames)/sizeof(statusNames[0]);
+
+int main(int argc, char** argv) {
+    const char* inputPath = 0;
+    const char* outputPrefix = 0;
+    const char* telemetryPath = 0;
+    bool realTime = true;
+    bool runMode[numStatus] = {false};
+    bool anyMode = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-f")) {
+            realTime = false;
+        } else if (!strcmp(argv[i], "-v")) {
+            disp.verbose = true;
+        } else if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            outputPrefix = argv[++i];
+        } else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            telemetryPath = argv[++i];
+        } else if (!strcmp(argv[i], "-m") && i + 1 < argc) {
+            int mode = atoi(argv[++i]);
+            if (mode >= 0 && mode < numStatus) {
+                runMode[mode] = true;
+                anyMode = true;
+            }
+        } else {
+            inputPath = argv[i];
+        }
+    }
+    if (!inputPath) {
+        fprintf(stderr, "usage: %s input.wav [-f] [-v] [-o prefix] [-t log] [-m mode]...\n", argv[0]);
+        return 1;
+    }
+
+    setup();
+    // Drains the telemetry ring like loop() would with SEND_TELEMETRY
+    TelemetryLog telemetryLog;
+    if (telemetryPath && (telemetryLog.open(telemetryPath) || telemetryLog.start(&telemetry, 1))) {
+        fprintf(stderr, "cannot write %s\n", telemetryPath);
+        return 1;
+    }
+    AudioSim sim;
+    sim.setLoop(loop);
+    for (int mode = 0; mode < numStatus; mode++) {
+        if (anyMode && !runMode[mode]) {
+            continue;
+        }
+        // Same path as a command from MATLAB
+        parse(mode);
+        WavReader input;
+        if (input.open(inputPath)) {
+            fprintf(stderr, "cannot read %s\n", inputPath);
+            return 1;
+        }
+        WavWriter output;
+        if (outputPrefix) {
+            char path[1024];
+            snprintf(path, sizeof(path), "%s_%s.wav", outputPrefix, statusNames[mode]);
+            if (output.open(path, AudioSim::getSampleRate(), 2)) {
+                fprintf(stderr, "cannot write %s\n", path);
+                return 1;
+            }
+        }
+        AudioSimStats stats;
+        sim.run(input, outputPrefix ? &output : 0, realTime, stats);
+        AudioSim::printStats(statusNames[mode], stats);
+        if (SOFTWARE_RESAMPLING) {
+            printf("%-14s resampling: working rate=%ld underruns=%ld overruns=%ld\n", "",
+                   workingRateOf(mode), resampleUnderruns, resampleOverruns);
+            resampleUnderruns = 0;
+            resampleOverruns = 0;
+        }
+        if (mode == PHASE_VOCODER) {
+            printf("%-14s quality: ", "");
+            scheduler.print();
+        }
+        if (DEFERRED_PROCESSING) {
+            printf("%-14s rings: depth=%d latency=%d blocks input overruns=%ld output underruns=%ld\n", "",
+                   ProcessingQueueDepth, ProcessingLatencyBlocks, inputRing.getOverruns(), outputRing.getUnderruns());
+            inputRing.reset();
+            outputRing.reset();
+            outputRing.prime(ProcessingLatencyBlocks);
+        }
+    }
+    if (telemetryPath) {
+        telemetryLog.close();
+        printf("telemetry: %ld frames logged, %ld dropped\n", telemetryLog.getRecords(), telemetry.getDropped());
+    }
+    return 0;
+}
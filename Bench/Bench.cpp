@@ -0,0 +1,251 @@
+/**
+ *   @mainpage Kernel Benchmark Harness
+ *
+ *   \section desc_sec Description
+ *   Runs the hot kernels of the pitch correction (FLWT::getPitch() and
+ *      PSOLA::pitchCorrect()) over every frame of a recording a few times
+ *      and reports the best and mean time per run, per frame and per sample.
+ *
+ *  @n Built with PV_PROFILE defined, the modules also time their own stages
+ *      (see Profiler.h) and the harness prints where the time of a frame
+ *      goes: the statistics pass, lifting, peak and mode search of every
+ *      FLWT level, and the storage, window, overlap and add and write back
+ *      phases of PSOLA.
+ *
+ *  @n Wall-clock time does not say why the peak search is slow. On Linux,
+ *      PerfCounters reads cycles, instructions, branch misses and L1 data
+ *      cache misses through perf_event_open() around every kernel and, with
+ *      PV_PROFILE, around every stage (the counter becomes the clock of the
+ *      profiles, see setProfileClock()). The counters only count user space,
+ *      so reading them does not count the read system call itself. Many
+ *      containers and virtual machines do not expose the counters
+ *      (perf_event_paranoid, seccomp, no PMU); the events that cannot be
+ *      opened are then reported as unavailable and the harness falls back
+ *      to time alone.
+ *
+ *  \section contents_sec Table of Contents
+ *    Bench.cpp
+ *
+ *    Bench.h
+ *
+ *    main.cpp
+ *
+ */
+
+/**
+ *  @file Bench.cpp
+ *  @brief Source file for Bench
+ *  @file Bench.h
+ *  @brief Header file for Bench
+ */
+
+#include "Bench.h"
+#include <chrono>
+#include <errno.h>
+#include <string.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/** Standard constructor, nothing open */
+PerfCounters::PerfCounters() {
+    for (int e = 0; e < NUM_PERF_EVENTS; e++) {
+        _fd[e] = -1;
+    }
+    _error = "not opened";
+}
+
+/** Standard destructor */
+PerfCounters::~PerfCounters() {
+    close();
+}
+
+/** Name of a PERF_* event */
+const char* PerfCounters::getName(int event) {
+    static const char* const names[NUM_PERF_EVENTS] = {
+        "cycles", "instructions", "branch-misses", "L1D-misses"
+    };
+    return (event >= 0 && event < NUM_PERF_EVENTS) ? names[event] : "?";
+}
+
+/** ====================================================
+ * @brief       Opens and starts the counters.
+ *
+ * @details     Each event is opened on its own so that one the processor
+ *              lacks does not take the others down with it. The counts
+ *              cover the calling thread in user space.
+ *
+ * @return      Number of events that could be opened
+ * ======================================================
+ */
+int PerfCounters::open() {
+    close();
+#ifdef __linux__
+    for (int e = 0; e < NUM_PERF_EVENTS; e++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        switch (e) {
+        case PERF_CYCLES:
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PERF_INSTRUCTIONS:
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PERF_BRANCH_MISSES:
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        default:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        }
+        int fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fd < 0) {
+            _error = strerror(errno);
+            continue;
+        }
+        _fd[e] = fd;
+    }
+#else
+    _error = "perf_event is Linux only";
+#endif
+    return getAvailable();
+}
+
+/** Closes every counter */
+void PerfCounters::close() {
+    for (int e = 0; e < NUM_PERF_EVENTS; e++) {
+#ifdef __linux__
+        if (_fd[e] >= 0) {
+            ::close(_fd[e]);
+        }
+#endif
+        _fd[e] = -1;
+    }
+}
+
+/** Number of events that are counted */
+int PerfCounters::getAvailable() const {
+    int available = 0;
+    for (int e = 0; e < NUM_PERF_EVENTS; e++) {
+        available += isAvailable(e);
+    }
+    return available;
+}
+
+/** Count of an event since PerfCounters::open(), 0 if it is not available */
+unsigned long long PerfCounters::read(int event) const {
+    unsigned long long count = 0;
+#ifdef __linux__
+    if (_fd[event] < 0 || ::read(_fd[event], &count, sizeof(count)) != sizeof(count)) {
+        return 0;
+    }
+#endif
+    return count;
+}
+
+/** ==============================================================================
+ * @brief       Initializes the harness.
+ *
+ * @param       repeats     Timed runs of every kernel
+ * ================================================================================
+ */
+Bench::Bench(int repeats) {
+    // Error Handle
+    if (repeats < 1) {
+        repeats = DEFAULT_BENCH_REPEATS;
+    }
+    _repeats = repeats;
+    _count = 0;
+    _counters = 0;
+}
+
+/** ====================================================
+ * @brief       Times a kernel.
+ *
+ * @details     The kernel runs once untimed to warm the caches up, then
+ *              getRepeats() times.
+ *
+ * @param       name        Name printed for the kernel
+ * @param       kernel      Function that runs one batch
+ * @param       context     Passed to kernel
+ * @param       frames      Frames processed by one run
+ * @param       samples     Samples processed by one run
+ *
+ * @return      The result, or 0 if there is no room for another kernel
+ * ======================================================
+ */
+const BenchResult* Bench::run(const char* name, BenchKernel kernel, void* context, long frames, long samples) {
+    if (_count == MAX_BENCH_KERNELS) {
+        return 0;
+    }
+    BenchResult& result = _results[_count++];
+    result.name = name;
+    result.frames = frames;
+    result.samples = samples;
+    result.runs = _repeats;
+    result.bestSeconds = 0;
+    double total = 0;
+    unsigned long long before[NUM_PERF_EVENTS];
+    kernel(context);
+    for (int e = 0; e < NUM_PERF_EVENTS; e++) {
+        result.counted[e] = _counters && _counters->isAvailable(e);
+        before[e] = result.counted[e] ? _counters->read(e) : 0;
+    }
+    for (int r = 0; r < _repeats; r++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        kernel(context);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (r == 0 || seconds < result.bestSeconds) {
+            result.bestSeconds = seconds;
+        }
+        total += seconds;
+    }
+    result.meanSeconds = total/_repeats;
+    for (int e = 0; e < NUM_PERF_EVENTS; e++) {
+        result.counts[e] = result.counted[e] ? (double)(_counters->read(e) - before[e])/_repeats : 0;
+    }
+    return &result;
+}
+
+/** Prints the time of every kernel per run, per frame and per sample */
+void Bench::print(FILE* out) const {
+    fprintf(out, "%-24s %10s %10s %12s %10s\n", "kernel", "best ms", "mean ms", "ns/frame", "ns/sample");
+    for (int k = 0; k < _count; k++) {
+        const BenchResult& result = _results[k];
+        fprintf(out, "%-24s %10.3f %10.3f %12.1f %10.2f\n", result.name, 1e3*result.bestSeconds,
+                1e3*result.meanSeconds, result.frames ? 1e9*result.bestSeconds/result.frames : 0.0,
+                result.samples ? 1e9*result.bestSeconds/result.samples : 0.0);
+    }
+    if (!_counters || !_counters->getAvailable()) {
+        return;
+    }
+    fprintf(out, "\n%-24s", "kernel (per sample)");
+    for (int e = 0; e < NUM_PERF_EVENTS; e++) {
+        fprintf(out, " %13s", PerfCounters::getName(e));
+    }
+    fprintf(out, " %8s\n", "IPC");
+    for (int k = 0; k < _count; k++) {
+        const BenchResult& result = _results[k];
+        fprintf(out, "%-24s", result.name);
+        for (int e = 0; e < NUM_PERF_EVENTS; e++) {
+            if (result.counted[e] && result.samples) {
+                fprintf(out, " %13.3f", result.counts[e]/result.samples);
+            } else {
+                fprintf(out, " %13s", "n/a");
+            }
+        }
+        if (result.counted[PERF_CYCLES] && result.counted[PERF_INSTRUCTIONS] && result.counts[PERF_CYCLES]) {
+            fprintf(out, " %8.2f\n", result.counts[PERF_INSTRUCTIONS]/result.counts[PERF_CYCLES]);
+        } else {
+            fprintf(out, " %8s\n", "n/a");
+        }
+    }
+}
@@ -0,0 +1,87 @@
+//
+//  Bench.h
+//
+//
+//  Times kernels (functions that run a batch of frames through a module)
+//  over repeated runs and prints a table per kernel, per frame and per
+//  sample, with hardware counters from perf_event where the kernel lets us
+//  (host only).
+//
+//
+
+#ifndef ____Bench__
+#define ____Bench__
+
+#include <stdio.h>
+
+#define MAX_BENCH_KERNELS       16
+#define DEFAULT_BENCH_REPEATS   5
+
+// Hardware events of PerfCounters
+#define PERF_CYCLES             0
+#define PERF_INSTRUCTIONS       1
+#define PERF_BRANCH_MISSES      2
+#define PERF_L1D_MISSES         3   // L1 data cache read misses
+#define NUM_PERF_EVENTS         4
+
+// Counts hardware events of the calling thread (user space only) through
+//  perf_event_open(). Events the processor, kernel or container does not
+//  allow are left out rather than failing.
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+    // Opens every event it can, returns how many (0 = none, see getError())
+    int open();
+    void close();
+    bool isAvailable(int event) const { return _fd[event] >= 0; }
+    int getAvailable() const;
+    static const char* getName(int event);
+    // Why the last event that could not be opened failed
+    const char* getError() const { return _error; }
+    // Current count of an event since open() (0 if not available)
+    unsigned long long read(int event) const;
+
+private:
+    int _fd[NUM_PERF_EVENTS];
+    const char* _error;
+};
+
+// Runs one batch of work on context
+typedef void (*BenchKernel)(void* context);
+
+struct BenchResult {
+    const char* name;
+    long frames;                // frames in one run
+    long samples;               // samples in one run
+    int runs;
+    double bestSeconds;         // fastest run
+    double meanSeconds;
+    bool counted[NUM_PERF_EVENTS];
+    double counts[NUM_PERF_EVENTS]; // mean per run
+};
+
+class Bench {
+public:
+    // repeats = runs of every kernel (after one warm-up run)
+    Bench(int repeats = DEFAULT_BENCH_REPEATS);
+    // Also counts the events available in counters during the timed runs (0 = time only)
+    void setCounters(const PerfCounters* counters) { _counters = counters; }
+    // Times kernel, which processes frames frames of samples samples in total per run.
+    //  Returns the result, or 0 once MAX_BENCH_KERNELS kernels were run
+    const BenchResult* run(const char* name, BenchKernel kernel, void* context, long frames, long samples);
+    int getRepeats() const { return _repeats; }
+    int getCount() const { return _count; }
+    const BenchResult& getResult(int kernel) const { return _results[kernel]; }
+    // One line per kernel: best and mean time per run, per frame and per sample,
+    //  then the counted events per sample
+    void print(FILE* out) const;
+
+private:
+    const PerfCounters* _counters;
+    int _repeats;
+    int _count;
+    BenchResult _results[MAX_BENCH_KERNELS];
+};
+
+#endif /* defined(____Bench__) */
@@ -0,0 +1,152 @@
+//
+//  main.cpp
+//
+//
+//  Benchmarks FLWT::getPitch() and PSOLA::pitchCorrect() over every frame of
+//  a WAV file and prints the FLWT diagnostics of the file. Add -DPV_PROFILE
+//  to also print the time of every stage. Where Linux lets us, the cycles,
+//  instructions, branch misses and L1D misses of every kernel (and with
+//  -DPV_PROFILE of every stage) are counted too.
+//  Build: g++ -std=c++11 -O2 [-DPV_PROFILE] -I../FLWT -I../PSOLA -I../FixedPoint -I../Profiler -I../CostModel -I../Arena -I../WavFile main.cpp Bench.cpp
+//         ../FLWT/FLWT.cpp ../PSOLA/PSOLA.cpp ../Profiler/Profiler.cpp ../WavFile/WavFile.cpp
+//  Usage: a.out [file.wav] [repeats]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Bench.h"
+#include "FLWT.h"
+#include "PSOLA.h"
+#include "Profiler.h"
+#include "WavFile.h"
+#include <iostream>
+
+using namespace std;
+
+const char* defaultPath = "../Version Final/FinalDemo/cscalesinging.wav";
+const int blockLength = 512;
+const int levels = 6;
+const float semitone = 1.0594631f;
+
+// The recording cut into frames, and what the kernels work on
+struct Frames {
+    int* samples;
+    long count;
+    long fs;
+    float* pitch;
+    int* scratch;
+    FLWT* flwt;
+    PSOLA* psola;
+};
+
+#ifdef PV_PROFILE
+// Hardware event the profiles count instead of time
+const PerfCounters* eventSource;
+int profiledEvent;
+
+ProfileTicks eventClock() {
+    return eventSource->read(profiledEvent);
+}
+#endif
+
+void detectKernel(void* context) {
+    Frames& frames = *(Frames*)context;
+    for (long f = 0; f < frames.count; f++) {
+        frames.pitch[f] = frames.flwt->getPitch(frames.samples + f*blockLength, blockLength, frames.fs);
+    }
+}
+
+// Corrects every frame a semitone up (into a scratch copy, the copy is part of the time)
+void correctKernel(void* context) {
+    Frames& frames = *(Frames*)context;
+    for (long f = 0; f < frames.count; f++) {
+        const int* block = frames.samples + f*blockLength;
+        for (int i = 0; i < blockLength; i++) {
+            frames.scratch[i] = block[i];
+        }
+        frames.psola->pitchCorrect(frames.scratch, frames.fs, frames.pitch[f], frames.pitch[f]*semitone);
+    }
+}
+
+int main(int argc, char** argv) {
+    cout<<endl<<"Bench Testing: "<<endl<<endl;
+    const char* path = (argc > 1) ? argv[1] : defaultPath;
+    int repeats = (argc > 2) ? atoi(argv[2]) : DEFAULT_BENCH_REPEATS;
+    WavReader wav;
+    if (wav.open(path)) {
+        printf("cannot read %s\n", path);
+        return 1;
+    }
+    Frames frames;
+    frames.count = wav.getFrames()/blockLength;
+    frames.fs = wav.getSampleRate();
+    frames.samples = new int[frames.count*blockLength];
+    frames.pitch = new float[frames.count];
+    frames.scratch = new int[blockLength];
+    for (long f = 0; f < frames.count; f++) {
+        wav.read(frames.samples + f*blockLength, 0, blockLength);
+    }
+    FLWT flwt(levels, blockLength);
+    PSOLA psola(blockLength);
+    frames.flwt = &flwt;
+    frames.psola = &psola;
+    printf("%s: %ld frames of %d samples at %ld Hz, %d runs\n\n", path, frames.count, blockLength, frames.fs, repeats);
+
+    PerfCounters counters;
+    if (counters.open()) {
+        printf("%d of %d hardware counters available\n\n", counters.getAvailable(), NUM_PERF_EVENTS);
+    } else {
+        printf("hardware counters unavailable (%s), timing only\n\n", counters.getError());
+    }
+    Bench bench(repeats);
+    bench.setCounters(&counters);
+    long samples = frames.count*blockLength;
+    bench.run("FLWT::getPitch", detectKernel, &frames, frames.count, samples);
+    bench.run("PSOLA::pitchCorrect", correctKernel, &frames, frames.count, samples);
+    bench.print(stdout);
+
+    // Every run plus the warm-up went through the profiles
+    long profiledFrames = frames.count*(repeats + 1);
+    if (flwt.getProfile()) {
+        printf("\n");
+        flwt.getProfile()->print(stdout, "FLWT::getPitch stages", profiledFrames, "frame");
+        psola.getProfile()->print(stdout, "PSOLA::pitchCorrect phases", profiledFrames*blockLength, "sample");
+#ifdef PV_PROFILE
+        // One more pass per event with that event as the clock of the profiles
+        eventSource = &counters;
+        for (int e = 0; e < NUM_PERF_EVENTS; e++) {
+            if (!counters.isAvailable(e)) {
+                continue;
+            }
+            profiledEvent = e;
+            setProfileClock(eventClock);
+            flwt.resetProfile();
+            psola.resetProfile();
+            detectKernel(&frames);
+            correctKernel(&frames);
+            setProfileClock(0);
+            printf("\n");
+            flwt.getProfile()->printCounts(stdout, "FLWT::getPitch stages", PerfCounters::getName(e), samples, "sample");
+            psola.getProfile()->printCounts(stdout, "PSOLA::pitchCorrect phases", PerfCounters::getName(e), samples, "sample");
+        }
+#endif
+    } else {
+        printf("\nbuild with -DPV_PROFILE for the time of every stage\n");
+    }
+
+    // Where the pitch of this material is found, and why frames are pitchless
+    FLWT diagnosed(levels, blockLength);
+    FLWTDiagnostics diagnostics;
+    FLWTHistogram histogram;
+    diagnosed.setDiagnostics(&diagnostics);
+    for (long f = 0; f < frames.count; f++) {
+        diagnosed.getPitch(frames.samples + f*blockLength, blockLength, frames.fs);
+        histogram.add(diagnostics);
+    }
+    printf("\nFLWT diagnostics: ");
+    histogram.print(stdout);
+    delete[] frames.samples;
+    delete[] frames.pitch;
+    delete[] frames.scratch;
+    return 0;
+}
@@ -0,0 +1,86 @@
+//
+//  ControlPlane.h
+//
+//
+//  Hands the user parameters (mode, key, tuning, quality) from the command
+//  parser to the audio side as whole snapshots, without locks or tearing.
+//
+//
+
+#ifndef ____ControlPlane__
+#define ____ControlPlane__
+
+#include <stdio.h>
+
+#if __cplusplus >= 201103L
+#include <atomic>
+typedef std::atomic<unsigned> ControlSequence;
+typedef std::atomic<int> ControlInt;
+typedef std::atomic<float> ControlFloat;
+#define CONTROL_LOAD(seq)           (seq).load(std::memory_order_acquire)
+#define CONTROL_STORE(seq, value)   (seq).store((value), std::memory_order_release)
+#define CONTROL_FENCE()             std::atomic_thread_fence(std::memory_order_seq_cst)
+// Fields of the shared snapshot: ordered by the fences around them, so relaxed is enough
+#define CONTROL_GET(field)          (field).load(std::memory_order_relaxed)
+#define CONTROL_SET(field, value)   (field).store((value), std::memory_order_relaxed)
+#else
+// One core: the ISR and loop() only need the compiler to not reorder around the sequence.
+//  The snapshot fields are volatile like the sequence, and the compiler keeps volatile
+//  accesses in program order, so the copy cannot move out from between the two stores.
+typedef volatile unsigned ControlSequence;
+typedef volatile int ControlInt;
+typedef volatile float ControlFloat;
+#define CONTROL_LOAD(seq)           (seq)
+#define CONTROL_STORE(seq, value)   ((seq) = (value))
+#define CONTROL_FENCE()
+#define CONTROL_GET(field)          (field)
+#define CONTROL_SET(field, value)   ((field) = (value))
+#endif
+
+// Everything the audio side needs to know about what the user asked for
+struct ControlParams {
+    int mode;                   // STATUS of the sketch
+    int scale;                  // key that begins the scale (A_SCALE...), used without autoKey
+    int majorOrMinor;           // MAJOR_SCALE or MINOR_SCALE, used without autoKey
+    int autoKey;                // true = follow the key of the singer
+    float referencePitch;       // frequency of A4 (Hz)
+    int qualityLimit;           // best QUALITY_* level the scheduler may use (QUALITY_FULL = no limit)
+};
+
+class ControlPlane {
+public:
+    ControlPlane();
+    // Writer (command parser): makes a complete set of parameters the current one
+    void publish(const ControlParams& params);
+    // Writer: the last published parameters, to change some of them and publish again
+    const ControlParams& getPublished() const { return _published; }
+    // Reader (audio side), once per block: copies the current snapshot into params if it
+    //  changed since the last call. Returns 1 if params changed, 0 otherwise
+    int acquire(ControlParams& params);
+    // Snapshots published so far
+    unsigned getVersion() const { return CONTROL_LOAD(_sequence)/2; }
+    // Reads that met a publish in progress and kept the previous snapshot
+    long getRetries() const { return _retries; }
+
+private:
+    // ControlParams as the writer and reader share it, one field at a time
+    struct SharedParams {
+        ControlInt mode;
+        ControlInt scale;
+        ControlInt majorOrMinor;
+        ControlInt autoKey;
+        ControlFloat referencePitch;
+        ControlInt qualityLimit;
+    };
+
+    void store(const ControlParams& params);
+    void load(ControlParams& params) const;
+
+    SharedParams _params;
+    ControlParams _published;   // writer only
+    ControlSequence _sequence;  // odd while a publish is in progress
+    unsigned _acquired;         // sequence of the snapshot the reader holds (reader only)
+    long _retries;              // reader only
+};
+
+#endif /* defined(____ControlPlane__) */
@@ -0,0 +1,76 @@
+//
+//  main.cpp
+//
+//
+//  One thread publishes numbered snapshots as fast as it can while another
+//  acquires them once per "block" and checks that no snapshot is torn.
+//  Build: g++ -std=c++11 -O2 -pthread main.cpp ControlPlane.cpp
+//
+
+#include <stdio.h>
+#include "ControlPlane.h"
+#include <iostream>
+#include <thread>
+
+using namespace std;
+
+int numSnapshots = 1000000;
+
+// Every field of snapshot n is derived from n
+void fill(ControlParams& params, int n) {
+    params.mode = n;
+    params.scale = n % 12 + 1;
+    params.majorOrMinor = (n & 1) ? -1 : 1;
+    params.autoKey = n & 2;
+    params.referencePitch = 430 + (n % 20);
+    params.qualityLimit = n % 5;
+}
+
+bool consistent(const ControlParams& params) {
+    ControlParams expected;
+    fill(expected, params.mode);
+    return params.scale == expected.scale && params.majorOrMinor == expected.majorOrMinor
+        && params.autoKey == expected.autoKey && params.referencePitch == expected.referencePitch
+        && params.qualityLimit == expected.qualityLimit;
+}
+
+int main() {
+    cout<<endl<<"ControlPlane Testing: "<<endl<<endl;
+    ControlPlane control;
+    ControlParams params;
+    fill(params, 0);
+    control.publish(params);
+    control.acquire(params);
+
+    long blocks = 0;
+    long changes = 0;
+    long torn = 0;
+    long backwards = 0;
+    thread writer([&]() {
+        ControlParams next;
+        for (int n = 1; n <= numSnapshots; n++) {
+            fill(next, n);
+            control.publish(next);
+        }
+    });
+    int last = 0;
+    while (last < numSnapshots) {
+        blocks++;
+        if (control.acquire(params)) {
+            changes++;
+            if (!consistent(params)) {
+                torn++;
+            }
+            if (params.mode < last) {
+                backwards++;
+            }
+            last = params.mode;
+        }
+        this_thread::yield();
+    }
+    writer.join();
+    cout << "snapshots = " << numSnapshots << ", blocks = " << blocks << ", changes seen = " << changes
+         << ", reads that met a publish = " << control.getRetries() << endl
+         << "torn = " << torn << ", out of order = " << backwards << endl << endl;
+    return (torn || backwards) ? 1 : 0;
+}
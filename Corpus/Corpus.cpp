@@ -0,0 +1,290 @@
+/**
+ *   @mainpage Synthetic Pitch Detection Corpus
+ *
+ *   \section desc_sec Description
+ *   Generates test signals whose pitch is known exactly, frame by frame,
+ *      so that the accuracy of a pitch detector can be measured rather than
+ *      judged by ear on a couple of recordings.
+ *
+ *  @n At each of the codec rates (8 to 48 kHz) the corpus holds a pure tone
+ *      and a harmonic stack at every one of the 88 piano keys, and at nine
+ *      keys from C2 to C6: a vibrato, a glide over an octave, an octave jump
+ *      and the harmonic stack in white noise at 20, 10 and 0 dB SNR. The
+ *      true pitch of a frame is the mean of the instantaneous pitch over the
+ *      frame. The noise comes from a fixed generator, so every run sees the
+ *      same samples on every host.
+ *
+ *  @n A CorpusScore counts, over the frames it is given, the gross pitch
+ *      errors (more than 20% off, in percent of the frames with a pitch),
+ *      the octave errors among them, the misses (frames called pitchless)
+ *      and the frames per second of the detector.
+ *
+ *  \section contents_sec Table of Contents
+ *    Corpus.cpp
+ *
+ *    Corpus.h
+ *
+ *    main.cpp
+ *
+ */
+
+/**
+ *  @file Corpus.cpp
+ *  @brief Source file for Corpus
+ *  @file Corpus.h
+ *  @brief Header file for Corpus
+ */
+
+#include "Corpus.h"
+#include <math.h>
+
+#define PI                      3.14159265358979
+#define MAX_HARMONICS           8
+#define VIBRATO_RATE            5.5     // Hz
+#define VIBRATO_DEPTH           50      // cents
+#define NUM_PIANO_KEYS          88
+#define A4_KEY                  49
+#define STEADY_FRAMES           8       // frames of the tones and harmonic stacks
+#define MOVING_FRAMES           16      // frames of the vibratos, glides and octave jumps
+#define FIRST_MOVING_KEY        16      // C2
+#define LAST_MOVING_KEY         64      // C6
+#define MOVING_KEY_STEP         6
+
+/** Codec rates of the C5535 */
+static const long rates[CORPUS_NUM_RATES] = {8000, 11025, 12000, 16000, 22050, 24000, 32000, 44100, 48000};
+
+/** Signal to noise ratios of the CORPUS_NOISE signals (dB) */
+static const double snrs[] = {20, 10, 0};
+#define NUM_SNRS                3
+
+/** ==============================================================================
+ * @brief       Builds the corpus.
+ *
+ * @param       blockLength     Samples per frame
+ * @param       seed            Seed of the noise
+ * ================================================================================
+ */
+Corpus::Corpus(int blockLength, unsigned long seed) {
+    // Error Handle
+    if (blockLength < 1) {
+        blockLength = 512;
+    }
+    _blockLength = blockLength;
+    _seed = seed;
+    _count = 0;
+    _signal = 0;
+    _frame = 0;
+    _phase = 0;
+    _state = 0;
+    _noiseRms = 0;
+    for (int r = 0; r < CORPUS_NUM_RATES; r++) {
+        for (int key = 1; key <= NUM_PIANO_KEYS; key++) {
+            addSignal(CORPUS_TONE, key, rates[r], 0, STEADY_FRAMES);
+            addSignal(CORPUS_HARMONICS, key, rates[r], 0, STEADY_FRAMES);
+        }
+        for (int key = FIRST_MOVING_KEY; key <= LAST_MOVING_KEY; key += MOVING_KEY_STEP) {
+            addSignal(CORPUS_VIBRATO, key, rates[r], 0, MOVING_FRAMES);
+            addSignal(CORPUS_GLIDE, key, rates[r], 0, MOVING_FRAMES);
+            addSignal(CORPUS_OCTAVE_JUMP, key, rates[r], 0, MOVING_FRAMES);
+            for (int s = 0; s < NUM_SNRS; s++) {
+                addSignal(CORPUS_NOISE, key, rates[r], snrs[s], STEADY_FRAMES);
+            }
+        }
+    }
+}
+
+/** Adds a signal to the corpus (ignored once it is full) */
+void Corpus::addSignal(int kind, int key, long fs, double snrDb, int frames) {
+    if (_count == CORPUS_MAX_SIGNALS) {
+        return;
+    }
+    CorpusSignal& signal = _signals[_count++];
+    signal.kind = kind;
+    signal.key = key;
+    signal.fs = fs;
+    signal.f0 = 440*pow(2.0, (key - A4_KEY)/12.0);
+    signal.snrDb = snrDb;
+    signal.frames = frames;
+}
+
+/** Frames in the whole corpus */
+long Corpus::getFrames() const {
+    long frames = 0;
+    for (int i = 0; i < _count; i++) {
+        frames += _signals[i].frames;
+    }
+    return frames;
+}
+
+/** Name of a CORPUS_* kind */
+const char* Corpus::getKindName(int kind) {
+    static const char* const names[CORPUS_NUM_KINDS] = {
+        "tone", "harmonics", "vibrato", "glide", "octave jump", "noise"
+    };
+    return (kind >= 0 && kind < CORPUS_NUM_KINDS) ? names[kind] : "?";
+}
+
+/** One of the CORPUS_NUM_RATES codec rates */
+long Corpus::getRate(int rate) {
+    return (rate >= 0 && rate < CORPUS_NUM_RATES) ? rates[rate] : 0;
+}
+
+/** Uniform in [0, 1), the same on every host */
+double Corpus::random() {
+    _state = (_state*1664525UL + 1013904223UL) & 0xFFFFFFFFUL;
+    return _state/4294967296.0;
+}
+
+/** ====================================================
+ * @brief       Starts rendering a signal.
+ *
+ * @param       signal      Index of the signal (0 to getCount()-1)
+ * ======================================================
+ */
+void Corpus::start(int signal) {
+    // Error Handle
+    if (signal < 0 || signal >= _count) {
+        signal = 0;
+    }
+    _signal = &_signals[signal];
+    _frame = 0;
+    _phase = 0;
+    _state = (_seed + 2654435761UL*(unsigned long)signal) & 0xFFFFFFFFUL;
+    _noiseRms = 0;
+    if (_signal->kind == CORPUS_NOISE) {
+        // RMS of the harmonic stack at the lowest pitch (the most harmonics)
+        double sum = 0;
+        double squares = 0;
+        for (int h = 1; h <= MAX_HARMONICS && h*_signal->f0 < _signal->fs/2; h++) {
+            sum += 1.0/h;
+            squares += 1.0/(h*h);
+        }
+        _noiseRms = CORPUS_AMPLITUDE/sum*sqrt(squares/2)/pow(10.0, _signal->snrDb/20);
+    }
+}
+
+/** ====================================================
+ * @brief       Renders the next frame of the current signal.
+ *
+ * @details     The phase carries over from frame to frame. Harmonics at or
+ *              above half the sampling rate are left out. A signal restarts
+ *              after its last frame.
+ *
+ * @param       block       getBlockLength() samples
+ *
+ * @return      True pitch of the frame (Hz)
+ * ======================================================
+ */
+double Corpus::next(int* block) {
+    if (!_signal) {
+        start(0);
+    }
+    if (_frame == _signal->frames) {
+        start((int)(_signal - _signals));
+    }
+    const CorpusSignal& s = *_signal;
+    double duration = (double)s.frames*_blockLength/s.fs;
+    double truth = 0;
+    for (int i = 0; i < _blockLength; i++) {
+        double t = (double)(_frame*_blockLength + i)/s.fs;
+        double f = s.f0;
+        if (s.kind == CORPUS_VIBRATO) {
+            f *= pow(2.0, VIBRATO_DEPTH/1200.0*sin(2*PI*VIBRATO_RATE*t));
+        } else if (s.kind == CORPUS_GLIDE) {
+            f *= pow(2.0, t/duration);
+        } else if (s.kind == CORPUS_OCTAVE_JUMP && 2*_frame >= s.frames) {
+            f *= 2;
+        }
+        truth += f;
+        _phase += 2*PI*f/s.fs;
+        if (_phase > 2*PI) {
+            _phase -= 2*PI;
+        }
+        double x = 0;
+        double sum = 0;
+        int harmonics = (s.kind == CORPUS_TONE) ? 1 : MAX_HARMONICS;
+        for (int h = 1; h <= harmonics && h*f < s.fs/2; h++) {
+            x += sin(h*_phase)/h;
+            sum += 1.0/h;
+        }
+        x = sum ? CORPUS_AMPLITUDE*x/sum : 0;
+        if (_noiseRms) {
+            // Sum of 4 uniforms: close enough to gaussian, unit variance after scaling
+            double g = (random() + random() + random() + random() - 2)*sqrt(3.0);
+            x += _noiseRms*g;
+        }
+        if (x > 32767) {
+            x = 32767;
+        } else if (x < -32768) {
+            x = -32768;
+        }
+        block[i] = (int)floor(x + 0.5);
+    }
+    _frame++;
+    return truth/_blockLength;
+}
+
+/** Clears the score */
+void CorpusScore::reset() {
+    frames = 0;
+    pitched = 0;
+    grossErrors = 0;
+    octaveErrors = 0;
+    misses = 0;
+    seconds = 0;
+}
+
+/** ====================================================
+ * @brief       Scores one frame.
+ *
+ * @param       truth       True pitch (Hz)
+ * @param       pitch       Pitch found, 0 if the detector called the frame pitchless
+ * ======================================================
+ */
+void CorpusScore::add(double truth, float pitch) {
+    frames++;
+    if (pitch <= 0) {
+        misses++;
+        return;
+    }
+    pitched++;
+    if (fabs(pitch/truth - 1) <= CORPUS_GROSS_ERROR) {
+        return;
+    }
+    grossErrors++;
+    double octaves = log(pitch/truth)/log(2.0);
+    double nearest = floor(octaves + 0.5);
+    if (nearest != 0 && fabs(octaves - nearest) <= CORPUS_OCTAVE_TOLERANCE) {
+        octaveErrors++;
+    }
+}
+
+/** Adds another score to this one */
+void CorpusScore::add(const CorpusScore& other) {
+    frames += other.frames;
+    pitched += other.pitched;
+    grossErrors += other.grossErrors;
+    octaveErrors += other.octaveErrors;
+    misses += other.misses;
+    seconds += other.seconds;
+}
+
+/** Gross errors in percent of the pitched frames */
+double CorpusScore::getGrossErrorRate() const {
+    return pitched ? 100.0*grossErrors/pitched : 0;
+}
+
+/** Octave errors in percent of the pitched frames */
+double CorpusScore::getOctaveErrorRate() const {
+    return pitched ? 100.0*octaveErrors/pitched : 0;
+}
+
+/** Pitchless frames in percent of all frames */
+double CorpusScore::getMissRate() const {
+    return frames ? 100.0*misses/frames : 0;
+}
+
+/** Frames per second of the detector */
+double CorpusScore::getFramesPerSecond() const {
+    return seconds > 0 ? frames/seconds : 0;
+}
@@ -0,0 +1,93 @@
+//
+//  Corpus.h
+//
+//
+//  Labeled synthetic test signals for the pitch detectors (tones, harmonic
+//  stacks, vibrato, glides, octave jumps and noisy tones at every codec
+//  rate) and the scores a detector gets on them.
+//
+//
+
+#ifndef ____Corpus__
+#define ____Corpus__
+
+#include <stdio.h>
+
+// Kinds of signals (CorpusSignal::kind)
+#define CORPUS_TONE             0   // pure sine
+#define CORPUS_HARMONICS        1   // harmonic stack, harmonic h at 1/h
+#define CORPUS_VIBRATO          2   // harmonic stack with a 5.5 Hz, +-50 cent vibrato
+#define CORPUS_GLIDE            3   // harmonic stack gliding an octave up over the signal
+#define CORPUS_OCTAVE_JUMP      4   // harmonic stack jumping an octave up halfway through
+#define CORPUS_NOISE            5   // harmonic stack in white noise at CorpusSignal::snrDb
+#define CORPUS_NUM_KINDS        6
+
+#define CORPUS_NUM_RATES        9   // codec rates, 8 to 48 kHz
+#define CORPUS_MAX_SIGNALS      2560
+#define CORPUS_AMPLITUDE        8000    // peak of the clean signals
+
+// A pitch more than this far (relative) from the truth is a gross error
+#define CORPUS_GROSS_ERROR      0.2
+// A gross error this close (in octaves) to a whole number of octaves is an octave error
+#define CORPUS_OCTAVE_TOLERANCE 0.05
+
+struct CorpusSignal {
+    int kind;           // CORPUS_*
+    int key;            // piano key of the starting pitch (1 to 88)
+    long fs;            // sampling rate
+    double f0;          // starting pitch (Hz)
+    double snrDb;       // CORPUS_NOISE only
+    int frames;         // length in blocks
+};
+
+// Accuracy and speed of a detector on part of the corpus
+struct CorpusScore {
+    long frames;        // frames scored
+    long pitched;       // frames the detector found a pitch in
+    long grossErrors;   // pitched frames more than CORPUS_GROSS_ERROR off
+    long octaveErrors;  // gross errors that are a whole number of octaves off
+    long misses;        // frames the detector called pitchless
+    double seconds;     // time spent in the detector
+    CorpusScore() { reset(); }
+    void reset();
+    // Scores one frame: truth and pitch in Hz, pitch 0 = pitchless
+    void add(double truth, float pitch);
+    void add(const CorpusScore& other);
+    // In percent: gross errors and octave errors of the pitched frames, misses of all frames
+    double getGrossErrorRate() const;
+    double getOctaveErrorRate() const;
+    double getMissRate() const;
+    double getFramesPerSecond() const;
+};
+
+class Corpus {
+public:
+    // Frames are blockLength samples long; every signal gets its own noise seeded from seed
+    Corpus(int blockLength, unsigned long seed = 1);
+    int getBlockLength() const { return _blockLength; }
+    int getCount() const { return _count; }
+    const CorpusSignal& getSignal(int signal) const { return _signals[signal]; }
+    long getFrames() const;
+    // Starts rendering a signal from its first frame
+    void start(int signal);
+    // Renders the next frame of the signal into block, returns its true pitch (the mean over the frame)
+    double next(int* block);
+    static const char* getKindName(int kind);
+    static long getRate(int rate);
+
+private:
+    void addSignal(int kind, int key, long fs, double snrDb, int frames);
+    double random();
+    int _blockLength;
+    unsigned long _seed;
+    int _count;
+    CorpusSignal _signals[CORPUS_MAX_SIGNALS];
+    // Rendering
+    const CorpusSignal* _signal;
+    int _frame;
+    double _phase;
+    unsigned long _state;
+    double _noiseRms;
+};
+
+#endif /* defined(____Corpus__) */
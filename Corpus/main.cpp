@@ -0,0 +1,279 @@
+//
+//  main.cpp
+//
+//
+//  Runs every FLWT detector variant over the synthetic corpus, prints its
+//  gross pitch error, octave error and miss rates (overall and per kind of
+//  signal) and its frames per second, and compares them with a baseline.
+//  Exits with 1 if a variant lost more accuracy or throughput than allowed,
+//  so it can gate a commit. -w writes an accuracy-only baseline instead,
+//  which holds on any machine (the committed baseline.txt is one). -t
+//  writes a baseline that also checks throughput; write it locally, on the
+//  machine that runs the gate. Throughput is counted in frames per run of a
+//  fixed reference kernel timed next to every variant, so machine load
+//  moves both alike.
+//  Build: g++ -std=c++11 -O2 -I../FLWT -I../Profiler -I../CostModel -I../Arena -I../Decimator -I../FixedPoint main.cpp Corpus.cpp
+//         ../FLWT/FLWT.cpp ../Decimator/Decimator.cpp
+//  Usage: a.out [-w | -t] [baseline]
+//
+
+#include <stdio.h>
+#include <string.h>
+#include "Corpus.h"
+#include "FLWT.h"
+#include "Decimator.h"
+#include <iostream>
+#include <chrono>
+
+using namespace std;
+
+const char* defaultBaseline = "baseline.txt";
+const int blockLength = 512;
+const int levels = 6;
+const int maxFrames = 16;
+// Timed runs of every signal, the fastest counts
+const int timedRuns = 3;
+// Reference kernel: autocorrelation lags of one block, repeated per timed run
+const int referenceLags = 64;
+const int referenceRepeats = 200;
+// Allowed losses: percentage points of any error rate, percent of the frames per second
+const double maxAccuracyLoss = 0.5;
+const double maxThroughputLoss = 25;
+
+// The ways the FLWT is used in the code base
+const int methodPitch = 0;
+const int methodMedian5 = 1;
+const int methodLastReliable = 2;
+const int methodOctaveInvariant = 3;
+const int methodRobust = 4;
+
+struct Variant {
+    const char* name;
+    int method;
+    int decimation;     // 1 = full rate input
+};
+
+const int numVariants = 6;
+const Variant variants[numVariants] = {
+    {"getPitch", methodPitch, 1},
+    {"getPitchWithMedian5", methodMedian5, 1},
+    {"getPitchLastReliable", methodLastReliable, 1},
+    {"getPitchOctaveInvariant", methodOctaveInvariant, 1},
+    {"getPitchRobust", methodRobust, 1},
+    {"getPitchWithMedian5/2", methodMedian5, 2}
+};
+
+Corpus corpus(blockLength);
+int frames[maxFrames][blockLength];
+double truths[maxFrames];
+CorpusScore scores[numVariants][CORPUS_NUM_KINDS];
+double referenceSeconds[numVariants];
+
+float detect(FLWT& flwt, Decimator& decimator, int method, int* data, long fs) {
+    int n = blockLength;
+    if (decimator.getFactor() > 1) {
+        static int decimated[blockLength];
+        n = decimator.process(data, blockLength, decimated);
+        data = decimated;
+        fs /= decimator.getFactor();
+    }
+    switch (method) {
+    case methodMedian5:
+        return flwt.getPitchWithMedian5(data, n, fs);
+    case methodLastReliable:
+        return flwt.getPitchLastReliable(data, n, fs);
+    case methodOctaveInvariant:
+        return flwt.getPitchOctaveInvariant(data, n, fs);
+    case methodRobust:
+        return flwt.getPitchRobust(data, n, fs);
+    default:
+        return flwt.getPitch(data, n, fs);
+    }
+}
+
+// Seconds of the fastest of timedRuns runs of the reference kernel: a plain integer
+//  autocorrelation that does not depend on the code under test, so it only measures how
+//  fast this machine is right now
+double timeReference() {
+    static int block[blockLength + referenceLags];
+    for (int i = 0; i < blockLength + referenceLags; i++) {
+        block[i] = ((i*7919) & 0xFFFF) - 0x8000;
+    }
+    volatile long sink = 0;
+    double best = 0;
+    for (int r = 0; r < timedRuns; r++) {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (int n = 0; n < referenceRepeats; n++) {
+            long total = 0;
+            for (int lag = 0; lag < referenceLags; lag++) {
+                long sum = 0;
+                for (int i = 0; i < blockLength; i++) {
+                    sum += (long)block[i]*block[i + lag] >> 8;
+                }
+                total += sum;
+            }
+            sink = sink + total;
+            block[n & (blockLength - 1)] ^= 1;
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (r == 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+    return best;
+}
+
+void run(int v) {
+    const Variant& variant = variants[v];
+    FLWT flwt(levels, blockLength);
+    Decimator decimator(variant.decimation, blockLength);
+    flwt.setInputDecimation(decimator.getStages());
+    for (int s = 0; s < corpus.getCount(); s++) {
+        const CorpusSignal& signal = corpus.getSignal(s);
+        corpus.start(s);
+        for (int f = 0; f < signal.frames; f++) {
+            truths[f] = corpus.next(frames[f]);
+        }
+        double best = 0;
+        for (int r = 0; r < timedRuns; r++) {
+            flwt.resetState();
+            decimator.reset();
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            float pitches[maxFrames];
+            for (int f = 0; f < signal.frames; f++) {
+                pitches[f] = detect(flwt, decimator, variant.method, frames[f], signal.fs);
+            }
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            if (r == 0) {
+                for (int f = 0; f < signal.frames; f++) {
+                    scores[v][signal.kind].add(truths[f], pitches[f]);
+                }
+            }
+            if (r == 0 || seconds < best) {
+                best = seconds;
+            }
+        }
+        scores[v][signal.kind].seconds += best;
+        if (s % 64 == 0) {
+            referenceSeconds[v] += timeReference();
+        }
+    }
+}
+
+// Frames per run of the reference kernel
+double getFramesPerReference(int v, const CorpusScore& total) {
+    int timed = (corpus.getCount() + 63)/64;
+    return total.getFramesPerSecond()*referenceSeconds[v]/(timed*referenceRepeats);
+}
+
+// Baseline line of a variant: name, gross %, octave %, miss % and, in a local baseline,
+//  frames per reference run
+struct Baseline {
+    char name[64];
+    double gross, octave, miss, fpr;    // fpr = 0: throughput not checked
+};
+
+int readBaseline(const char* path, Baseline* baselines, int max) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return -1;
+    }
+    int count = 0;
+    char line[256];
+    while (count < max && fgets(line, sizeof(line), file)) {
+        Baseline& b = baselines[count];
+        b.fpr = 0;
+        if (line[0] != '#' && sscanf(line, "%63s %lf %lf %lf %lf", b.name, &b.gross, &b.octave, &b.miss, &b.fpr) >= 4) {
+            count++;
+        }
+    }
+    fclose(file);
+    return count;
+}
+
+int main(int argc, char** argv) {
+    cout<<endl<<"Corpus Testing: "<<endl<<endl;
+    bool writeThroughput = (argc > 1 && !strcmp(argv[1], "-t"));
+    bool write = writeThroughput || (argc > 1 && !strcmp(argv[1], "-w"));
+    const char* path = (argc > 1 + write) ? argv[1 + write] : defaultBaseline;
+    printf("%d signals, %ld frames of %d samples at %d rates from %ld to %ld Hz\n\n", corpus.getCount(),
+           corpus.getFrames(), blockLength, CORPUS_NUM_RATES, Corpus::getRate(0), Corpus::getRate(CORPUS_NUM_RATES - 1));
+
+    CorpusScore totals[numVariants];
+    printf("%-24s %8s %8s %8s %10s %10s\n", "variant", "gross %", "octave %", "miss %", "frames/s", "frames/ref");
+    for (int v = 0; v < numVariants; v++) {
+        run(v);
+        for (int k = 0; k < CORPUS_NUM_KINDS; k++) {
+            totals[v].add(scores[v][k]);
+        }
+        printf("%-24s %8.2f %8.2f %8.2f %10.0f %10.3f\n", variants[v].name, totals[v].getGrossErrorRate(),
+               totals[v].getOctaveErrorRate(), totals[v].getMissRate(), totals[v].getFramesPerSecond(),
+               getFramesPerReference(v, totals[v]));
+    }
+    printf("\ngross %% / miss %% per kind of signal\n%-24s", "variant");
+    for (int k = 0; k < CORPUS_NUM_KINDS; k++) {
+        printf(" %13s", Corpus::getKindName(k));
+    }
+    printf("\n");
+    for (int v = 0; v < numVariants; v++) {
+        printf("%-24s", variants[v].name);
+        for (int k = 0; k < CORPUS_NUM_KINDS; k++) {
+            printf("   %5.1f/%5.1f", scores[v][k].getGrossErrorRate(), scores[v][k].getMissRate());
+        }
+        printf("\n");
+    }
+
+    if (write) {
+        FILE* file = fopen(path, "w");
+        if (!file) {
+            printf("\ncannot write %s\n", path);
+            return 1;
+        }
+        fprintf(file, writeThroughput ? "# variant gross%% octave%% miss%% frames/ref\n" : "# variant gross%% octave%% miss%%\n");
+        for (int v = 0; v < numVariants; v++) {
+            fprintf(file, "%s %.2f %.2f %.2f", variants[v].name, totals[v].getGrossErrorRate(),
+                    totals[v].getOctaveErrorRate(), totals[v].getMissRate());
+            if (writeThroughput) {
+                fprintf(file, " %.3f", getFramesPerReference(v, totals[v]));
+            }
+            fprintf(file, "\n");
+        }
+        fclose(file);
+        printf("\nbaseline written to %s\n", path);
+        return 0;
+    }
+
+    Baseline baselines[numVariants];
+    int count = readBaseline(path, baselines, numVariants);
+    if (count < 0) {
+        printf("\nno baseline %s (write one with -w)\n", path);
+        return 0;
+    }
+    int failures = 0;
+    printf("\nagainst %s (at most +%.1f points of error, -%.0f%% of frames/ref where the baseline has it):\n", path, maxAccuracyLoss, maxThroughputLoss);
+    for (int v = 0; v < numVariants; v++) {
+        const Baseline* b = 0;
+        for (int i = 0; i < count; i++) {
+            if (!strcmp(baselines[i].name, variants[v].name)) {
+                b = &baselines[i];
+            }
+        }
+        if (!b) {
+            printf("  %-24s not in the baseline\n", variants[v].name);
+            continue;
+        }
+        const CorpusScore& t = totals[v];
+        double speed = b->fpr > 0 ? 100*(getFramesPerReference(v, t)/b->fpr - 1) : 0;
+        bool failed = t.getGrossErrorRate() > b->gross + maxAccuracyLoss ||
+                      t.getOctaveErrorRate() > b->octave + maxAccuracyLoss ||
+                      t.getMissRate() > b->miss + maxAccuracyLoss || speed < -maxThroughputLoss;
+        printf("  %-24s gross %+6.2f  octave %+6.2f  miss %+6.2f", variants[v].name,
+               t.getGrossErrorRate() - b->gross, t.getOctaveErrorRate() - b->octave, t.getMissRate() - b->miss);
+        if (b->fpr > 0) {
+            printf("  frames/ref %+6.1f%%", speed);
+        }
+        printf("  %s\n", failed ? "FAIL" : "ok");
+        failures += failed;
+    }
+    return failures ? 1 : 0;
+}
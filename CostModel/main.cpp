@@ -0,0 +1,109 @@
+//
+//  main.cpp
+//
+//
+//  Counts the operations of the PHASE_VOCODER mode (pitch detection,
+//  quantization and the correction of both channels) on every buffer of a
+//  WAV file and estimates the cycles of a buffer on the device. Exits with 1
+//  if the worst buffer does not fit in the real-time budget of the target.
+//  Build: g++ -std=c++11 -O2 -DPV_COST -I. -I../Arena -I../FLWT -I../PSOLA -I../FixedPoint -I../Frequency -I../Profiler -I../WavFile main.cpp
+//         CostModel.cpp ../FLWT/FLWT.cpp ../PSOLA/PSOLA.cpp ../Frequency/Frequency.cpp ../WavFile/WavFile.cpp
+//  Usage: a.out [file.wav] [C5535|Cortex-M4F]
+//
+
+#include <stdio.h>
+#include <string.h>
+#include "CostModel.h"
+#include "FLWT.h"
+#include "PSOLA.h"
+#include "Frequency.h"
+#include "WavFile.h"
+#include <iostream>
+
+using namespace std;
+
+const char* defaultPath = "../Version Final/FinalDemo/cscalesinging.wav";
+const int blockLength = 512;
+const int levels = 6;
+
+// Stages of a buffer
+const int numStages = 3;
+const char* const stageNames[numStages] = {"FLWT::getPitchWithMedian5", "Frequency::getClosestKeyNumInScale",
+                                           "PSOLA::pitchCorrect (x2)"};
+
+int main(int argc, char** argv) {
+    cout<<endl<<"CostModel Testing: "<<endl<<endl;
+#ifndef PV_COST
+    printf("build with -DPV_COST to count the operations\n");
+    return 1;
+#else
+    const char* path = (argc > 1) ? argv[1] : defaultPath;
+    const CostTable& target = (argc > 2 && !strcmp(argv[2], costTableCortexM4F.name)) ? costTableCortexM4F : costTableC5535;
+    WavReader wav;
+    if (wav.open(path)) {
+        printf("cannot read %s\n", path);
+        return 1;
+    }
+    long fs = wav.getSampleRate();
+    FLWT flwt(levels, blockLength);
+    PSOLA psola(blockLength);
+    Frequency f;
+    int left[blockLength];
+    int right[blockLength];
+    CostCounts stages[numStages];
+    CostCounts worst;
+    double worstCycles = 0;
+    long buffers = 0;
+    long worstBuffer = 0;
+    while (wav.read(left, right, blockLength) == blockLength) {
+        CostCounts buffer;
+        costCounts.reset();
+        float freq = flwt.getPitchWithMedian5(left, blockLength, fs);
+        stages[0].add(costCounts);
+        buffer.add(costCounts);
+        if (freq) {
+            costCounts.reset();
+            float closestFreq = f.getFreqOfKeyNum(f.getClosestKeyNumInScale(freq, C_SCALE, MAJOR_SCALE));
+            stages[1].add(costCounts);
+            buffer.add(costCounts);
+            costCounts.reset();
+            psola.pitchCorrect(left, fs, freq, closestFreq);
+            psola.pitchCorrect(right, fs, freq, closestFreq);
+            stages[2].add(costCounts);
+            buffer.add(costCounts);
+        }
+        double cycles = costCycles(buffer, target);
+        if (cycles > worstCycles) {
+            worstCycles = cycles;
+            worst = buffer;
+            worstBuffer = buffers;
+        }
+        buffers++;
+    }
+    if (!buffers) {
+        printf("%s is shorter than a buffer\n", path);
+        return 1;
+    }
+
+    double budget = costBudget(target, blockLength, fs);
+    printf("%s: %ld buffers of %d samples at %ld Hz on %s (%.0f MHz)\n\n", path, buffers, blockLength, fs,
+           target.name, target.clockHz/1e6);
+    CostCounts total;
+    for (int s = 0; s < numStages; s++) {
+        costPrint(stdout, stageNames[s], stages[s], target, buffers);
+        total.add(stages[s]);
+    }
+    printf("\n");
+    char title[64];
+    snprintf(title, sizeof(title), "worst buffer (%ld)", worstBuffer);
+    costPrint(stdout, title, worst, target);
+    double mean = costCycles(total, target)/buffers;
+    printf("\nbudget %.0f cycles per buffer: mean %.0f (%.1f%%), worst %.0f (%.1f%%)\n", budget, mean,
+           100*mean/budget, worstCycles, 100*worstCycles/budget);
+    if (worstCycles > budget) {
+        printf("OVER BUDGET\n");
+        return 1;
+    }
+    return 0;
+#endif
+}
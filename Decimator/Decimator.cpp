@@ -0,0 +1,155 @@
+/**
+ *   @mainpage Half-Band Decimator Module
+ *
+ *   \section desc_sec Description
+ *   Produces a reduced rate copy of an audio stream for analysis. Pitch
+ *      detection only needs the band below MAX_FREQUENCY (3 kHz), so the
+ *      FLWT can work on a stream decimated by 2, 4 or 8 while PSOLA keeps
+ *      working on the full rate audio.
+ *
+ *  @n Every stage low-pass filters with a 23 tap half-band FIR and keeps
+ *      every other sample. In a half-band filter every other tap is zero
+ *      and the center tap is one half, so a stage costs 6 multiplies per
+ *      output sample, and the whole cascade costs less than 6 multiplies per
+ *      input sample whatever the factor. The passband is flat to within
+ *      0.3 dB up to 0.19 of the input rate of a stage, and the band that
+ *      folds back onto it is attenuated by at least 29 dB.
+ *
+ *  @n A FLWT level is itself a Haar low-pass and decimation by 2, so a
+ *      stream decimated by 2^k already is the approximation of FLWT level
+ *      k-1: call FLWT::setInputDecimation(getStages()) and pass the reduced
+ *      sampling rate, and the FLWT searches the same levels (with the same
+ *      minDist) as on the full rate stream. With a factor of 2 the pitch
+ *      tracks agree to a few cents; larger factors lose the finest level and
+ *      with it some of the high pitches.
+ *
+ *  @n Because the FLWT already halves its window at every level, the
+ *      detection itself does not get cheaper by the decimation factor: what
+ *      the half-band stages add is a real anti-aliasing filter in front of
+ *      the Haar cascade, and a low rate stream that other analysis can share.
+ *      On cscalesinging.wav a factor of 2 costs about 1.4 times the full
+ *      rate detection, so FinalDemo detects at the working rate and the
+ *      decimated path is only exercised by the host tools (Corpus, Golden).
+ *
+ *  \section contents_sec Table of Contents
+ *    Decimator.cpp
+ *
+ *    Decimator.h
+ *
+ */
+
+/**
+ *  @file Decimator.cpp
+ *  @brief Source file for Decimator
+ *  @file Decimator.h
+ *  @brief Header file for Decimator
+ */
+
+#include "Decimator.h"
+#include "FixedPoint.h"
+
+#define HISTORY_LENGTH      (HALFBAND_LENGTH - 1)
+#define HALFBAND_CENTER     16384   // 0.5 in Q15
+
+/**
+ Q15 half-band taps at offsets 1, 3, 5, ... from the center (Blackman windowed
+ sinc, normalized so the filter has a DC gain of exactly 1).
+ */
+const int halfBand[HALFBAND_SIDE_TAPS] = {10183,-2795,1121,-420,125,-22};
+
+/** ==============================================================================
+ * @brief       Initializes the decimator.
+ *
+ * @param       factor              Decimation factor (rounded down to a power of two)
+ * @param       maxBlockLength      Longest block passed to Decimator::process()
+ * ================================================================================
+ */
+Decimator::Decimator(int factor, int maxBlockLength) {
+    // Error Handle
+    _stages = 0;
+    while (_stages < MAX_DECIMATION_STAGES && (2 << _stages) <= factor) {
+        _stages++;
+    }
+    if (maxBlockLength < 1) {
+        maxBlockLength = 1;
+    }
+    _maxBlockLength = maxBlockLength;
+    for (int s = 0; s < MAX_DECIMATION_STAGES; s++) {
+        _buffer[s] = 0;
+    }
+    for (int s = 0; s < _stages; s++) {
+        _buffer[s] = new int[HISTORY_LENGTH + (maxBlockLength >> s)];
+    }
+    reset();
+}
+
+/** Standard destructor */
+Decimator::~Decimator() {
+    for (int s = 0; s < _stages; s++) {
+        delete[] _buffer[s];
+    }
+}
+
+/** Clears the filter history */
+void Decimator::reset() {
+    for (int s = 0; s < _stages; s++) {
+        for (int i = 0; i < HISTORY_LENGTH; i++) {
+            _buffer[s][i] = 0;
+        }
+    }
+}
+
+/** Group delay in output samples */
+float Decimator::getDelay() const {
+    // Each stage delays by half its length at its own input rate
+    return (float)(HALFBAND_LENGTH/2)*((1 << _stages) - 1)/(1 << _stages);
+}
+
+/** ====================================================
+ * @brief       Decimates a block of samples.
+ *
+ * @details     The history of every stage is carried between calls, so
+ *              consecutive blocks are filtered as one stream.
+ *
+ * @param       in          Input samples
+ * @param       inLen       Number of input samples (divisible by getFactor())
+ * @param       out         Output samples (inLen/getFactor() of them)
+ *
+ * @return      Number of output samples, or -1 if inLen is not valid
+ * ======================================================
+ */
+int Decimator::process(const int* in, int inLen, int* out) {
+    if (inLen < 0 || inLen > _maxBlockLength || (inLen & (getFactor() - 1))) {
+        return -1;
+    }
+    if (_stages == 0) {
+        for (int i = 0; i < inLen; i++) {
+            out[i] = in[i];
+        }
+        return inLen;
+    }
+    int len = inLen;
+    for (int i = 0; i < len; i++) {
+        _buffer[0][HISTORY_LENGTH + i] = in[i];
+    }
+    for (int s = 0; s < _stages; s++) {
+        int* x = _buffer[s];
+        int* y = (s == _stages - 1) ? out : _buffer[s + 1] + HISTORY_LENGTH;
+        int outLen = len >> 1;
+        for (int n = 0; n < outLen; n++) {
+            const int* center = x + 2*n + HISTORY_LENGTH/2;
+            long acc = (long)HALFBAND_CENTER*center[0];
+            for (int k = 0; k < HALFBAND_SIDE_TAPS; k++) {
+                acc += (long)halfBand[k]*((long)center[-2*k - 1] + center[2*k + 1]);
+            }
+            // The ripple can overshoot a full scale input
+            y[n] = q15RoundSatRaw<int>(acc);
+        }
+        // Keep the end of this block as the history of the next one
+        for (int i = 0; i < HISTORY_LENGTH; i++) {
+            x[i] = x[len + i];
+        }
+        len = outLen;
+    }
+    return len;
+}
@@ -0,0 +1,39 @@
+//
+//  Decimator.h
+//
+//
+//  Half-band FIR cascade that decimates a stream by a power of two.
+//
+//
+
+#ifndef ____Decimator__
+#define ____Decimator__
+
+#include <stdio.h>
+
+#define HALFBAND_SIDE_TAPS      6                           // nonzero taps on each side of the center
+#define HALFBAND_LENGTH         (4*HALFBAND_SIDE_TAPS - 1)  // 23 taps, every other one zero
+#define MAX_DECIMATION_STAGES   4                           // decimation by up to 16
+
+class Decimator {
+public:
+    // factor is rounded down to a power of two (1 to 2^MAX_DECIMATION_STAGES)
+    Decimator(int factor, int maxBlockLength);
+    ~Decimator();
+    // inLen MUST be divisible by getFactor() and at most maxBlockLength.
+    // Returns the number of samples written to out (inLen/getFactor()) or -1.
+    int process(const int* in, int inLen, int* out);
+    void reset();
+    int getFactor() const { return 1 << _stages; }
+    // log2 of the factor (see FLWT::setInputDecimation())
+    int getStages() const { return _stages; }
+    // Group delay in output samples
+    float getDelay() const;
+
+private:
+    int _stages;
+    int _maxBlockLength;
+    int *_buffer[MAX_DECIMATION_STAGES];    // history followed by the input of each stage
+};
+
+#endif /* defined(____Decimator__) */
@@ -0,0 +1,76 @@
+//
+//  main.cpp
+//
+//
+//  Tracks the pitch of a gliding harmonic tone with the FLWT on the full rate
+//  signal and on the decimated analysis stream, and compares the two.
+//  Build: g++ -O2 -I../FLWT -I../Profiler -I../CostModel -I../Arena -I../FixedPoint main.cpp Decimator.cpp ../FLWT/FLWT.cpp
+//
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include "Decimator.h"
+#include "FLWT.h"
+#include <iostream>
+
+using namespace std;
+
+const long fs = 32000;
+const int blockLength = 512;
+const int levels = 6;
+const int numBlocks = 600;
+
+int main() {
+    cout<<endl<<"Decimator Testing: "<<endl<<endl;
+    int* block = new int[blockLength];
+    int* analysis = new int[blockLength];
+    for (int factor = 2; factor <= 8; factor *= 2) {
+        Decimator decimator(factor, blockLength);
+        FLWT full(levels, blockLength);
+        FLWT reduced(levels, blockLength);
+        reduced.setInputDecimation(decimator.getStages());
+        double phase = 0;
+        double fullTime = 0, reducedTime = 0;
+        int bothVoiced = 0, onlyOne = 0;
+        double cents = 0, worstCents = 0;
+        for (int b = 0; b < numBlocks; b++) {
+            // 8 harmonics gliding from 100 Hz to 800 Hz and back
+            for (int i = 0; i < blockLength; i++) {
+                double t = (double)(b*blockLength + i)/(numBlocks*blockLength);
+                double f0 = 100*pow(8.0, 1 - fabs(2*t - 1));
+                phase += 2*3.14159265358979*f0/fs;
+                double x = 0;
+                for (int h = 1; h <= 8; h++) {
+                    x += sin(h*phase)/h;
+                }
+                block[i] = (int)(8000*x);
+            }
+            clock_t start = clock();
+            float p1 = full.getPitch(block, blockLength, fs);
+            clock_t middle = clock();
+            int n = decimator.process(block, blockLength, analysis);
+            float p2 = reduced.getPitch(analysis, n, fs/factor);
+            clock_t end = clock();
+            fullTime += middle - start;
+            reducedTime += end - middle;
+            if (p1 > 0 && p2 > 0) {
+                double c = fabs(1200*log(p2/p1)/log(2.0));
+                cents += c;
+                if (c > worstCents) {
+                    worstCents = c;
+                }
+                bothVoiced++;
+            } else if (p1 > 0 || p2 > 0) {
+                onlyOne++;
+            }
+        }
+        printf("factor %d (analysis at %5ld Hz): both voiced %3d/%d, only one voiced %3d, "
+               "mean difference %5.2f cents (worst %6.1f), time %4.2fx of full rate\n",
+               factor, fs/factor, bothVoiced, numBlocks, onlyOne,
+               bothVoiced ? cents/bothVoiced : 0.0, worstCents, reducedTime/fullTime);
+    }
+    delete[] block;
+    delete[] analysis;
+    return 0;
+}
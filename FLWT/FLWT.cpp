@@ -19,6 +19,12 @@
  *      algorithm to estimatethe pitch reliably. If the algorithm decides the windowed 
  *      audio is pitchless, it conservatively returns 0.
  *
+ *  @n To find out why, hand FLWT::setDiagnostics() a FLWTDiagnostics: every call
+ *      then records the peaks, valleys and mode of each level it searched and
+ *      the reason it stopped. A FLWTHistogram of many calls shows at which level
+ *      the pitch is usually found, i.e. how many levels (and how long a window)
+ *      the material at hand actually needs.
+ *
  *  \section contents_sec Table of Contents
  *    FLWT.cpp
  *
@@ -34,19 +40,34 @@
  */
 
 #include "FLWT.h"
+#include "CostModel.h"
 #include <math.h>
+#include <limits.h>
 //#include <iostream> //@debugging
 //using namespace std; //@debugging
 
 // ====================================
 #define DEFAULT_WIN_LENGTH  1024
-#define MAX_LEVELS          6
+#define MAX_LEVELS          FLWT_MAX_LEVELS
 #define MAX_INT16           32767
 #define MIN_INT16           -32768
 #define MAX_INT32           2147483647
 #define MIN_INT32           -2147483648
 // ====================================
 
+#ifdef PV_PROFILE
+/** Names of the FLWT_PROFILE_* slots */
+static const char* const profileNames[1 + 2*MAX_LEVELS] = {
+    "statistics",
+    "level 1 lifting+peaks", "level 1 mode search",
+    "level 2 lifting+peaks", "level 2 mode search",
+    "level 3 lifting+peaks", "level 3 mode search",
+    "level 4 lifting+peaks", "level 4 mode search",
+    "level 5 lifting+peaks", "level 5 mode search",
+    "level 6 lifting+peaks", "level 6 mode search"
+};
+#endif
+
 /** Sets the number of differences between peaks to consider as the mode
  *
  * @b Example: 
@@ -81,18 +102,27 @@
 #endif
 
 // abs value
-int iabs(int x) {
+CostInt iabs(CostInt x) {
     if (x >= 0) return x;
     return -x;
 }
 
-float fabs(float x) {
+float ffabs(float x) {
     if (x >= 0) return x;
     return -x;
 }
 
+// Mean of two samples, summed in Acc so it cannot overflow, floored like the shift
+template<class Acc, class Sample> inline Sample flwtMean(const Sample& a, const Sample& b) {
+    return ((Acc)a + b) >> 1;
+}
+template<> inline float flwtMean<float, float>(const float& a, const float& b) {
+    return (a + b)*0.5f;
+}
+
 // load median filter
-void FLWT::addToMedianBuffer(float f) {
+template<class SampleT, class AccT>
+void BasicFLWT<SampleT, AccT>::addToMedianBuffer(float f) {
     if (_medianBufferLastIndex == MEDIAN_BUFFER_LENGTH) {
         _medianBufferLastIndex = 0;
     }
@@ -101,12 +131,13 @@ void FLWT::addToMedianBuffer(float f) {
 }
 
 // Return median
-float FLWT::median5() {
-    float a = _medianBuffer5[0];
-    float b = _medianBuffer5[1];
-    float c = _medianBuffer5[2];
-    float d = _medianBuffer5[3];
-    float e = _medianBuffer5[4];
+template<class SampleT, class AccT>
+float BasicFLWT<SampleT, AccT>::median5() {
+    CostFloat a = _medianBuffer5[0];
+    CostFloat b = _medianBuffer5[1];
+    CostFloat c = _medianBuffer5[2];
+    CostFloat d = _medianBuffer5[3];
+    CostFloat e = _medianBuffer5[4];
     // Put the largest value in a
     if (a <= b) { a = a+b; b = a-b; a = a-b; }
     if (a <= c) { a = a+c; c = a-c; a = a-c; }
@@ -119,7 +150,7 @@ float FLWT::median5() {
     // The 3rd largest is the median
     if (c <= d) { c = c+d; d = c-d; c = c-d; }
     if (c <= e) { c = c+e; e = c-e; c = c-e; }
-    return c;
+    return costValue(c);
 }
 
 /** ==============================================================================
@@ -138,45 +169,325 @@ float FLWT::median5() {
  * ================================================================================
  */
 
-FLWT::FLWT(int levels, int windowLen) {
+template<class SampleT, class AccT>
+BasicFLWT<SampleT, AccT>::BasicFLWT(int levels, int windowLen) {
+    init(levels, windowLen, 0);
+}
+
+/** ====================================================
+ * @brief       Initializes a FLWT whose buffers are in an arena.
+ *
+ * @details     Same as the other constructor, but the buffers are taken from
+ *              arena, one after the other, so creating the FLWT allocates
+ *              nothing and destroying it frees nothing: they go away with
+ *              the arena. Falls back to the heap if the arena has less than
+ *              getArenaSize() bytes left.
+ *
+ * @param       levels       Number of levels for the FLWT algorithm
+ * @param       windowLen    Length of the window
+ * @param       arena        Arena to take the buffers from; must outlive the FLWT
+ * ======================================================
+ */
+template<class SampleT, class AccT>
+BasicFLWT<SampleT, AccT>::BasicFLWT(int levels, int windowLen, Arena& arena) {
+    init(levels, windowLen, (arena.getRemaining() >= getArenaSize(levels, windowLen)) ? &arena : 0);
+}
+
+// n Ts from the arena, or from the heap if there is none
+template<class T> static T* flwtAllocate(Arena* arena, int n) {
+    return arena ? arena->allocateArray<T>(n) : new T[n];
+}
+
+/** Initializes the FLWT, taking its buffers from arena (0 = the heap) */
+template<class SampleT, class AccT>
+void BasicFLWT<SampleT, AccT>::init(int levels, int windowLen, Arena* arena) {
     // Error Handle
     if (windowLen < 4 || windowLen > DEFAULT_WIN_LENGTH) {
-        _window = new int[DEFAULT_WIN_LENGTH];
+        _window = flwtAllocate<SampleT>(arena, DEFAULT_WIN_LENGTH);
     } else {
-        _window = new int[windowLen];
+        _window = flwtAllocate<SampleT>(arena, windowLen);
     }
     if (levels < 0 || levels > MAX_LEVELS) {
         _levels = MAX_LEVELS;
     } else {
         _levels = levels;
     }
-    _maxCount = new int[levels];
-    _minCount = new int[levels];
-    _maxIndices = new int[windowLen];
-    _minIndices = new int[windowLen];
+    _maxLevels = _levels;
+    _inputStages = 0;
+    _maxCount = flwtAllocate<int>(arena, _levels);
+    _minCount = flwtAllocate<int>(arena, _levels);
+    _maxIndices = flwtAllocate<int>(arena, windowLen);
+    _minIndices = flwtAllocate<int>(arena, windowLen);
     _oldFreq = 0.0;
     _oldMode = 0;
-    _mode = new int[levels];
+    _foundLevel = 0;
+    _diagnostics = 0;
+    _mode = flwtAllocate<int>(arena, _levels);
     _winLength = windowLen;
     _dLength = 0;
     // This buffer can't overflow up unless windowLen < (#peaks + #valleys)*(#peaks + #valleys + 1)/2
-    _differs = new int[windowLen];
+    _differs = flwtAllocate<int>(arena, windowLen);
     // Median Buffer variables
-    _medianBuffer5 = new float[5];
-    _medianBufferLastIndex = 0;
+    _medianBuffer5 = flwtAllocate<float>(arena, MEDIAN_BUFFER_LENGTH);
+    _ownsBuffers = !arena;
+    resetState();
+    PV_PROFILE_ONLY(_profile.setSlots(profileNames, 1 + 2*_levels));
 }
 
-/** Standard destructor */
-FLWT::~FLWT() {
+/** Standard destructor (the buffers in an arena go away with the arena) */
+template<class SampleT, class AccT>
+BasicFLWT<SampleT, AccT>::~BasicFLWT() {
+    if (!_ownsBuffers) {
+        return;
+    }
     delete[] _window;
     delete[] _maxCount;
     delete[] _minCount;
     delete[] _maxIndices;
     delete[] _minIndices;
     delete[] _mode;
+    delete[] _differs;
     delete[] _medianBuffer5;
 }
 
+/** ====================================================
+ * @brief       Bytes of an arena the buffers of a FLWT take.
+ *
+ * @param       levels       Number of levels given to the constructor
+ * @param       windowLen    Length of the window given to the constructor
+ *
+ * @return      Size to reserve in an arena for a FLWT built with these parameters
+ * ======================================================
+ */
+template<class SampleT, class AccT>
+size_t BasicFLWT<SampleT, AccT>::getArenaSize(int levels, int windowLen) {
+    int window = (windowLen < 4 || windowLen > DEFAULT_WIN_LENGTH) ? DEFAULT_WIN_LENGTH : windowLen;
+    if (levels < 0 || levels > MAX_LEVELS) {
+        levels = MAX_LEVELS;
+    }
+    return Arena::sizeOfArray<SampleT>(window) + 3*Arena::sizeOfArray<int>(levels) +
+           3*Arena::sizeOfArray<int>(windowLen) + Arena::sizeOfArray<float>(MEDIAN_BUFFER_LENGTH);
+}
+
+/** ====================================================
+ * @brief       Changes the number of levels searched for a pitch.
+ *
+ * @details     A pitch is only reported once two neighbouring levels agree,
+ *              so at least 2 levels are needed. Each level halves the window,
+ *              so dropping the last levels saves little on voiced frames (the
+ *              search stops at the first agreeing pair) but cuts the work on
+ *              pitchless ones, at the price of missing the lowest pitches.
+ *
+ * @param       levels      Number of levels (2 to the number given to the constructor)
+ *
+ * @return      Number of levels in use after clamping
+ * ======================================================
+ */
+template<class SampleT, class AccT>
+int BasicFLWT<SampleT, AccT>::setLevels(int levels) {
+    if (levels < 2) {
+        levels = 2;
+    }
+    if (levels > _maxLevels) {
+        levels = _maxLevels;
+    }
+    _levels = levels;
+    return _levels;
+}
+
+/** ====================================================
+ * @brief       Tells the FLWT that its input was decimated.
+ *
+ * @details     Every FLWT level halves the window before looking for peaks,
+ *              so an input that was low-pass filtered and decimated by
+ *              2^stages (see Decimator) already is the approximation of level
+ *              stages-1. It is then searched as it is, and stages-1 fewer
+ *              levels are searched, so that the same levels as on the full
+ *              rate input are covered. Pass the decimated sampling rate to
+ *              the getPitch functions; minDist and the returned pitch follow
+ *              from it.
+ *
+ * @param       stages      log2 of the decimation factor (0 for full rate input)
+ *
+ * @return      Number of stages in use after clamping
+ * ======================================================
+ */
+template<class SampleT, class AccT>
+int BasicFLWT<SampleT, AccT>::setInputDecimation(int stages) {
+    if (stages < 0) {
+        stages = 0;
+    }
+    if (stages > _maxLevels - 1) {
+        stages = _maxLevels - 1;
+    }
+    _inputStages = stages;
+    return _inputStages;
+}
+
+/** ====================================================
+ * @brief       Saves the state carried from one frame to the next.
+ *
+ * @details     The pitch of a frame depends only on its samples and on this
+ *              state (the last mode and frequency found and the median
+ *              buffer), so a FLWT restored with FLWT::setState() returns
+ *              exactly what the saved one would have. This is what lets a
+ *              long recording be split between several detectors.
+ *
+ * @param       state       Filled with the current state
+ * ======================================================
+ */
+template<class SampleT, class AccT>
+void BasicFLWT<SampleT, AccT>::getState(FLWTState& state) const {
+    state.oldFreq = _oldFreq;
+    state.oldMode = _oldMode;
+    for (int i = 0; i < MEDIAN_BUFFER_LENGTH; i++) {
+        state.median[i] = _medianBuffer5[i];
+    }
+    state.medianIndex = _medianBufferLastIndex;
+}
+
+/** Restores a state saved by FLWT::getState() */
+template<class SampleT, class AccT>
+void BasicFLWT<SampleT, AccT>::setState(const FLWTState& state) {
+    _oldFreq = state.oldFreq;
+    _oldMode = state.oldMode;
+    for (int i = 0; i < MEDIAN_BUFFER_LENGTH; i++) {
+        _medianBuffer5[i] = state.median[i];
+    }
+    _medianBufferLastIndex = state.medianIndex;
+}
+
+/** Forgets the previous frames (the median buffer starts out full of zeros) */
+template<class SampleT, class AccT>
+void BasicFLWT<SampleT, AccT>::resetState() {
+    _oldFreq = 0.0;
+    _oldMode = 0;
+    for (int i = 0; i < MEDIAN_BUFFER_LENGTH; i++) {
+        _medianBuffer5[i] = 0.0;
+    }
+    _medianBufferLastIndex = 0;
+}
+
+/** Time spent in each stage of FLWT::getPitch(), 0 unless built with PV_PROFILE */
+template<class SampleT, class AccT>
+const Profile* BasicFLWT<SampleT, AccT>::getProfile() const {
+#ifdef PV_PROFILE
+    return &_profile;
+#else
+    return 0;
+#endif
+}
+
+/** Clears the profile */
+template<class SampleT, class AccT>
+void BasicFLWT<SampleT, AccT>::resetProfile() {
+    PV_PROFILE_ONLY(_profile.reset());
+}
+
+/** ====================================================
+ * @brief       Fills the diagnostics of the current call.
+ *
+ * @details     Only called when FLWT::setDiagnostics() was given a struct,
+ *              so the search itself pays nothing for it otherwise.
+ *
+ * @param       levels      Levels searched by the call
+ * @param       pitch       Pitch found, 0.0 if pitchless
+ * @param       average     Average of the window
+ * @param       maxThresh   Threshold of the peaks
+ * @param       minThresh   Threshold of the valleys
+ * ======================================================
+ */
+template<class SampleT, class AccT>
+void BasicFLWT<SampleT, AccT>::diagnose(int levels, float pitch, int average, int maxThresh, int minThresh) {
+    FLWTDiagnostics& d = *_diagnostics;
+    d.pitch = pitch;
+    d.foundLevel = _foundLevel;
+    d.average = average;
+    d.maxThresh = maxThresh;
+    d.minThresh = minThresh;
+    d.levels = levels;
+    bool anyPeak = false;
+    bool enoughPeaks = false;
+    bool anyMode = false;
+    for (int lev = 0; lev < FLWT_MAX_LEVELS; lev++) {
+        if (lev < levels) {
+            d.maxCount[lev] = _maxCount[lev];
+            d.minCount[lev] = _minCount[lev];
+            d.mode[lev] = _mode[lev];
+        } else {
+            d.maxCount[lev] = 0;
+            d.minCount[lev] = 0;
+            d.mode[lev] = 0;
+        }
+        anyPeak = anyPeak || d.maxCount[lev] || d.minCount[lev];
+        enoughPeaks = enoughPeaks || (d.maxCount[lev] >= 2 && d.minCount[lev] >= 2);
+        anyMode = anyMode || d.mode[lev];
+    }
+    if (pitch) {
+        d.exitReason = FLWT_EXIT_PITCH;
+    } else if (!anyPeak) {
+        d.exitReason = FLWT_EXIT_NO_PEAKS;
+    } else if (!enoughPeaks) {
+        d.exitReason = FLWT_EXIT_FEW_PEAKS;
+    } else if (!anyMode) {
+        d.exitReason = FLWT_EXIT_NO_MODE;
+    } else {
+        d.exitReason = FLWT_EXIT_NO_AGREEMENT;
+    }
+}
+
+/** Clears the histogram */
+void FLWTHistogram::reset() {
+    frames = 0;
+    for (int i = 0; i <= FLWT_MAX_LEVELS; i++) {
+        foundAt[i] = 0;
+    }
+    for (int i = 0; i < FLWT_NUM_EXITS; i++) {
+        exits[i] = 0;
+    }
+}
+
+/** Accounts for the diagnostics of one call */
+void FLWTHistogram::add(const FLWTDiagnostics& diagnostics) {
+    frames++;
+    if (diagnostics.foundLevel >= 0 && diagnostics.foundLevel <= FLWT_MAX_LEVELS) {
+        foundAt[diagnostics.foundLevel]++;
+    }
+    if (diagnostics.exitReason >= 0 && diagnostics.exitReason < FLWT_NUM_EXITS) {
+        exits[diagnostics.exitReason]++;
+    }
+}
+
+/** Prints the share of frames found at each level and of each exit reason */
+void FLWTHistogram::print(FILE* out) const {
+    static const char* const exitNames[FLWT_NUM_EXITS] = {
+        "pitch", "no peaks", "too few peaks", "no mode", "no agreement"
+    };
+    double scale = frames ? 100.0/frames : 0;
+    fprintf(out, "%ld frames\n  pitch found at level:", frames);
+    for (int i = 1; i <= FLWT_MAX_LEVELS; i++) {
+        fprintf(out, " %d=%.1f%%", i, foundAt[i]*scale);
+    }
+    fprintf(out, "\n  exit:");
+    for (int i = 0; i < FLWT_NUM_EXITS; i++) {
+        fprintf(out, " %s=%.1f%%", exitNames[i], exits[i]*scale);
+    }
+    fprintf(out, "\n");
+}
+
+/** true if both states make a FLWT behave the same from now on */
+bool FLWTState::equals(const FLWTState& other) const {
+    if (oldFreq != other.oldFreq || oldMode != other.oldMode || medianIndex != other.medianIndex) {
+        return false;
+    }
+    for (int i = 0; i < MEDIAN_BUFFER_LENGTH; i++) {
+        if (median[i] != other.median[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
 /** ====================================================
  * @brief       Calculates the pitch of a set of data.
  *
@@ -205,16 +516,28 @@ FLWT::~FLWT() {
  *              http://www.schmittmachine.com/dywapitchtrack.html
  * ======================================================
  */
-float FLWT::getPitch(int* data, int datalen, long fs) {
+template<class SampleT, class AccT>
+float BasicFLWT<SampleT, AccT>::getPitch(const SampleT* data, int datalen, long fs) {
+    // Counted views of the buffers when built with PV_COST
+    typedef typename CostType<SampleT>::Value Sample;
+    typedef typename CostType<AccT>::Value Acc;
+    typename CostType<SampleT>::Array window = costArray(_window);
+    CostIntArray maxCount = costArray(_maxCount);
+    CostIntArray minCount = costArray(_minCount);
+    CostIntArray maxIndices = costArray(_maxIndices);
+    CostIntArray minIndices = costArray(_minIndices);
+    CostIntArray mode = costArray(_mode);
+    CostIntArray differs = costArray(_differs);
+    PV_PROFILE_START(watch);
     // Calculate Parameters for this window
     int newWidth = (datalen > _winLength) ? _winLength : datalen;
-    long average = 0;
-    int globalMax = MIN_INT16;
-    int globalMin = MAX_INT16;
-    int maxThresh;
-    int minThresh;
+    Acc average = 0;
+    Sample globalMax = data[0];
+    Sample globalMin = data[0];
+    Sample maxThresh;
+    Sample minThresh;
     for (int i = 0; i < datalen; i++) {
-        _window[i] = data[i];
+        window[i] = data[i];
         average += data[i];
         if (data[i] > globalMax) {
             globalMax = data[i];
@@ -226,26 +549,37 @@ float FLWT::getPitch(int* data, int datalen, long fs) {
     average /= datalen;
     maxThresh = GLOBAL_MAX_THRESHOLD*(globalMax - average) + average;
     minThresh = GLOBAL_MAX_THRESHOLD*(globalMin - average) + average;
+    PV_PROFILE_LAP(_profile, FLWT_PROFILE_STATS, watch);
     
     // Perform FLWT Algorithm
     int minDist;
-    int climber;
+    CostInt climber;
     bool isSearching; // flag for whether or not another peak can be found
-    int tooClose; // Make sure the peaks aren't too close
-    int test;
-    for(int lev = 0; lev < _levels; lev++) {
+    CostInt tooClose; // Make sure the peaks aren't too close
+    // A decimated input already is the approximation of level _inputStages-1, so it
+    //  is searched as it is first and the levels it replaces are not searched
+    int shift = _inputStages ? 0 : 1;
+    int numLevels = _levels - _inputStages + 1 - shift;
+    if (_inputStages && numLevels < 2) {
+        numLevels = 2;
+    }
+    bool halve;
+    for(int lev = 0; lev < numLevels; lev++) {
         // Reinitialize level parameters
-        _mode[lev] = 0;
-        _maxCount[lev] = 0;
-        _minCount[lev] = 0;
+        mode[lev] = 0;
+        maxCount[lev] = 0;
+        minCount[lev] = 0;
         isSearching = true;
         tooClose = 0;
         _dLength = 0;
         
-        newWidth = newWidth >> 1;
-        minDist = max( floor((fs/MAX_FREQUENCY) >> (lev+1)) ,1);
+        halve = (lev > 0 || shift);
+        if (halve) {
+            newWidth = newWidth >> 1;
+        }
+        minDist = max( floor((fs/MAX_FREQUENCY) >> (lev+shift)) ,1);
         // First forward difference of new window (a(i,2) - a(i,1) > 0)
-        if ((_window[3]+_window[2]-_window[1]-_window[0]) > 0) {
+        if (halve ? (Acc)window[3] + window[2] > (Acc)window[1] + window[0] : window[1] > window[0]) {
             climber = 1;
         } else {
             climber = -1;
@@ -256,27 +590,30 @@ float FLWT::getPitch(int* data, int datalen, long fs) {
         // First and last element of the approximation is calculated separately
         //  to exploit the fact that maxima and minima can be calculated
         //  while next approximation component is being filled
-        _window[0] = (_window[1] + _window[0]) >> 1;
+        if (halve) {
+            window[0] = flwtMean<Acc>(window[1], window[0]);
+        }
         for (int j = 1; j < newWidth; j++) {
-            _window[j] = (_window[2*j+1] + _window[2*j]) >> 1;
-            
-            // While the window is being filled, find max and mins
-            test = _window[j] - _window[j-1]; // first backward difference
+            if (halve) {
+                window[j] = flwtMean<Acc>(window[2*j+1], window[2*j]);
+            }
             
-            if (climber >= 0 && test < 0) { // reached a peak
-                if (_window[j-1] >= maxThresh && isSearching && !tooClose) {
+            // While the window is being filled, find max and mins (the sign of the first
+            //  backward difference, compared rather than subtracted so it cannot overflow)
+            if (climber >= 0 && window[j] < window[j-1]) { // reached a peak
+                if (window[j-1] >= maxThresh && isSearching && !tooClose) {
                     // value is large enough, haven't found peak yet, and not too close
-                    _maxIndices[_maxCount[lev]] = j-1;
-                    _maxCount[lev]++;
+                    maxIndices[maxCount[lev]] = j-1;
+                    maxCount[lev]++;
                     isSearching = false;
                     tooClose = minDist;
                 }
                 climber = -1;
-            } else if(climber <= 0 && test > 0) { // reached valley
-                if (_window[j-1] <= minThresh && isSearching && !tooClose) {
+            } else if(climber <= 0 && window[j] > window[j-1]) { // reached valley
+                if (window[j-1] <= minThresh && isSearching && !tooClose) {
                     // value is small enough, haven't found peak yet, and not too close
-                    _minIndices[_minCount[lev]] = j-1;
-                    _minCount[lev]++;
+                    minIndices[minCount[lev]] = j-1;
+                    minCount[lev]++;
                     isSearching = false;
                     tooClose = minDist;
                 }
@@ -285,8 +622,8 @@ float FLWT::getPitch(int* data, int datalen, long fs) {
             }
             
             // If we reach zero crossing, we can look for another peak
-            if ((_window[j] <= average && _window[j-1] > average) ||
-                (_window[j] >= average && _window[j-1] < average)) {
+            if ((window[j] <= average && window[j-1] > average) ||
+                (window[j] >= average && window[j-1] < average)) {
                 isSearching = true;
             }
             
@@ -294,73 +631,79 @@ float FLWT::getPitch(int* data, int datalen, long fs) {
                 tooClose--;
             }
         }
+        PV_PROFILE_LAP(_profile, FLWT_PROFILE_PASS(lev), watch);
         
         // Find the mode distance between peaks
-        if (_maxCount[lev] >= 2 && _minCount[lev] >= 2) {
+        if (maxCount[lev] >= 2 && minCount[lev] >= 2) {
             
             // Find all differences between maxima/minima
             for (int j = 1; j <= MAX_NUM_OF_PEAKS_BETWEEN_MODE; j++) {
-                for (int k = 0; k < _maxCount[lev] - j; k++) {
-                    _differs[_dLength] = iabs(_maxIndices[k] - _maxIndices[k+j]);
+                for (int k = 0; k < maxCount[lev] - j; k++) {
+                    differs[_dLength] = iabs(maxIndices[k] - maxIndices[k+j]);
                     _dLength++;
                 }
-                for (int k = 0; k < _minCount[lev] - j; k++) {
-                    _differs[_dLength] = iabs(_minIndices[k] - _minIndices[k+j]);
+                for (int k = 0; k < minCount[lev] - j; k++) {
+                    differs[_dLength] = iabs(minIndices[k] - minIndices[k+j]);
                     _dLength++;
                 }
             }
             
             // Determine the mode
-            int numer = 1; // Require at least two agreeing _differs to yield a mode
-            int numerJ;
+            CostInt numer = 1; // Require at least two agreeing differs to yield a mode
+            CostInt numerJ;
             for (int j = 0; j < _dLength; j++) {
                 numerJ = 0;
                 
-                // Find the number of _differs that are near _differs[j]
+                // Find the number of differs that are near differs[j]
                 for (int n = 0; n < _dLength; n++) {
-                    if (iabs(_differs[j] - _differs[n]) < minDist) {
+                    if (iabs(differs[j] - differs[n]) < minDist) {
                         numerJ++;
                     }
                 }
                 
                 // Check to see if there is a better candidate for the mode
-                if (numerJ >= numer && numerJ > floor((newWidth/_differs[j])>>2)) {
+                if (numerJ >= numer && numerJ > floor((newWidth/differs[j])>>2)) {
                     if (numerJ == numer) {
-                        if (_oldMode && iabs(_differs[j] - (_oldMode >> (lev+1))) < minDist) {
-                            _mode[lev] = _differs[j];
-                        } else if (~_oldMode && (_differs[j] > 1.95*_mode[lev] && _differs[j] < 2.05*_mode[lev])) {
-                            _mode[lev] = _differs[j];
+                        if (_oldMode && iabs(differs[j] - (_oldMode >> (lev+shift))) < minDist) {
+                            mode[lev] = differs[j];
+                        } else if (~_oldMode && (differs[j] > 1.95*mode[lev] && differs[j] < 2.05*mode[lev])) {
+                            mode[lev] = differs[j];
                         }
                     } else {
                         numer = numerJ;
-                        _mode[lev] = _differs[j];
+                        mode[lev] = differs[j];
                     }
-                } else if (numerJ == numer-1 && _oldMode && iabs(_differs[j] - (_oldMode >> (lev+1))) < minDist) {
-                    _mode[lev] = _differs[j];
+                } else if (numerJ == numer-1 && _oldMode && iabs(differs[j] - (_oldMode >> (lev+shift))) < minDist) {
+                    mode[lev] = differs[j];
                 }
             }
             
             // Average to get the mode
-            if (_mode[lev]) {
-                int numerator = 0;
-                int denominator = 0;
+            if (mode[lev]) {
+                CostInt numerator = 0;
+                CostInt denominator = 0;
                 for (int m = 0; m < _dLength; m++) {
-                    if (iabs(_mode[lev] - _differs[m]) <= minDist) {
-                        numerator += _differs[m];
+                    if (iabs(mode[lev] - differs[m]) <= minDist) {
+                        numerator += differs[m];
                         denominator++;
                     }
                 }
-                _mode[lev] = numerator/denominator;
+                mode[lev] = numerator/denominator;
             }
+            PV_PROFILE_LAP(_profile, FLWT_PROFILE_MODE(lev), watch);
             
             // Check if the mode is shared with the previous level
             if (lev == 0) {
                 // Do nothing
-            } else if (_mode[lev-1] && _maxCount[lev-1] >= 2 && _minCount[lev-1] >= 2) {
+            } else if (mode[lev-1] && maxCount[lev-1] >= 2 && minCount[lev-1] >= 2) {
                 // If the modes are within a sample of one another, return the calculated frequency
-                if (iabs(_mode[lev-1] - 2*_mode[lev]) <= minDist) {
-                    _oldMode = _mode[lev-1];
-                    _oldFreq = ((float)fs)/((float)_mode[lev-1])/((float)(1<<(lev)));
+                if (iabs(mode[lev-1] - 2*mode[lev]) <= minDist) {
+                    _oldMode = costValue(mode[lev-1]);
+                    _oldFreq = ((float)fs)/((float)mode[lev-1])/((float)(1<<(lev-1+shift)));
+                    _foundLevel = lev + 1 + (_inputStages ? _inputStages - 1 : 0);
+                    if (_diagnostics) {
+                        diagnose(lev + 1, _oldFreq, costValue(average), costValue(maxThresh), costValue(minThresh));
+                    }
                     // Add the frequency to the median buffer
                     addToMedianBuffer(_oldFreq);
                     return _oldFreq;
@@ -371,6 +714,10 @@ float FLWT::getPitch(int* data, int datalen, long fs) {
     }
     
     // Getting here means the window was pitchless
+    _foundLevel = 0;
+    if (_diagnostics) {
+        diagnose(numLevels, 0.0, costValue(average), costValue(maxThresh), costValue(minThresh));
+    }
     
     // Add to this value to the median filter
     addToMedianBuffer(0.0);
@@ -396,7 +743,8 @@ float FLWT::getPitch(int* data, int datalen, long fs) {
  *
  * ======================================================
  */
-float FLWT::getPitchWithMedian5(int* data, int datalen, long fs) {
+template<class SampleT, class AccT>
+float BasicFLWT<SampleT, AccT>::getPitchWithMedian5(const SampleT* data, int datalen, long fs) {
     this->getPitch(data,datalen,fs);
     return this->median5();
 }
@@ -418,7 +766,8 @@ float FLWT::getPitchWithMedian5(int* data, int datalen, long fs) {
  *
  * ======================================================
  */
-float FLWT::getPitchLastReliable(int* data, int datalen, long fs) {
+template<class SampleT, class AccT>
+float BasicFLWT<SampleT, AccT>::getPitchLastReliable(const SampleT* data, int datalen, long fs) {
     this->getPitch(data,datalen,fs);
     return _oldFreq;
 }
@@ -441,7 +790,8 @@ float FLWT::getPitchLastReliable(int* data, int datalen, long fs) {
  *
  * ======================================================
  */
-float FLWT::getPitchOctaveInvariant(int* data, int datalen, long fs) {
+template<class SampleT, class AccT>
+float BasicFLWT<SampleT, AccT>::getPitchOctaveInvariant(const SampleT* data, int datalen, long fs) {
     float old = _oldFreq;
     this->getPitch(data,datalen,fs);
     if (_oldFreq >= (2*old - OCTAVE_TOLERANCE) && _oldFreq <= (2*old + OCTAVE_TOLERANCE)) {
@@ -471,17 +821,28 @@ float FLWT::getPitchOctaveInvariant(int* data, int datalen, long fs) {
  *
  * ======================================================
  */
-float FLWT::getPitchRobust(int* data, int datalen, long fs) {
+template<class SampleT, class AccT>
+float BasicFLWT<SampleT, AccT>::getPitchRobust(const SampleT* data, int datalen, long fs) {
+    // Counted views of the buffers when built with PV_COST
+    typedef typename CostType<SampleT>::Value Sample;
+    typedef typename CostType<AccT>::Value Acc;
+    typename CostType<SampleT>::Array window = costArray(_window);
+    CostIntArray maxCount = costArray(_maxCount);
+    CostIntArray minCount = costArray(_minCount);
+    CostIntArray maxIndices = costArray(_maxIndices);
+    CostIntArray minIndices = costArray(_minIndices);
+    CostIntArray mode = costArray(_mode);
+    CostIntArray differs = costArray(_differs);
     // Calculate Parameters for this window
     float currentFreq;
     int newWidth = (datalen > _winLength) ? _winLength : datalen;
-    long average = 0;
-    int globalMax = MIN_INT16;
-    int globalMin = MAX_INT16;
-    int maxThresh;
-    int minThresh;
+    Acc average = 0;
+    Sample globalMax = data[0];
+    Sample globalMin = data[0];
+    Sample maxThresh;
+    Sample minThresh;
     for (int i = 0; i < datalen; i++) {
-        _window[i] = data[i];
+        window[i] = data[i];
         average += data[i];
         if (data[i] > globalMax) {
             globalMax = data[i];
@@ -496,23 +857,33 @@ float FLWT::getPitchRobust(int* data, int datalen, long fs) {
     
     // Perform FLWT Algorithm
     int minDist;
-    int climber;
+    CostInt climber;
     bool isSearching; // flag for whether or not another peak can be found
-    int tooClose; // Make sure the peaks aren't too close
-    int test;
-    for(int lev = 0; lev < _levels; lev++) {
+    CostInt tooClose; // Make sure the peaks aren't too close
+    // A decimated input already is the approximation of level _inputStages-1, so it
+    //  is searched as it is first and the levels it replaces are not searched
+    int shift = _inputStages ? 0 : 1;
+    int numLevels = _levels - _inputStages + 1 - shift;
+    if (_inputStages && numLevels < 2) {
+        numLevels = 2;
+    }
+    bool halve;
+    for(int lev = 0; lev < numLevels; lev++) {
         // Reinitialize level parameters
-        _mode[lev] = 0;
-        _maxCount[lev] = 0;
-        _minCount[lev] = 0;
+        mode[lev] = 0;
+        maxCount[lev] = 0;
+        minCount[lev] = 0;
         isSearching = true;
         tooClose = 0;
         _dLength = 0;
         
-        newWidth = newWidth >> 1;
-        minDist = max( floor((fs/MAX_FREQUENCY) >> (lev+1)) ,1);
+        halve = (lev > 0 || shift);
+        if (halve) {
+            newWidth = newWidth >> 1;
+        }
+        minDist = max( floor((fs/MAX_FREQUENCY) >> (lev+shift)) ,1);
         // First forward difference of new window (a(i,2) - a(i,1) > 0)
-        if ((_window[3]+_window[2]-_window[1]-_window[0]) > 0) {
+        if (halve ? (Acc)window[3] + window[2] > (Acc)window[1] + window[0] : window[1] > window[0]) {
             climber = 1;
         } else {
             climber = -1;
@@ -523,27 +894,30 @@ float FLWT::getPitchRobust(int* data, int datalen, long fs) {
         // First and last element of the approximation is calculated separately
         //  to exploit the fact that maxima and minima can be calculated
         //  while next approximation component is being filled
-        _window[0] = (_window[1] + _window[0]) >> 1;
+        if (halve) {
+            window[0] = flwtMean<Acc>(window[1], window[0]);
+        }
         for (int j = 1; j < newWidth; j++) {
-            _window[j] = (_window[2*j+1] + _window[2*j]) >> 1;
-            
-            // While the window is being filled, find max and mins
-            test = _window[j] - _window[j-1]; // first backward difference
+            if (halve) {
+                window[j] = flwtMean<Acc>(window[2*j+1], window[2*j]);
+            }
             
-            if (climber >= 0 && test < 0) { // reached a peak
-                if (_window[j-1] >= maxThresh && isSearching && !tooClose) {
+            // While the window is being filled, find max and mins (the sign of the first
+            //  backward difference, compared rather than subtracted so it cannot overflow)
+            if (climber >= 0 && window[j] < window[j-1]) { // reached a peak
+                if (window[j-1] >= maxThresh && isSearching && !tooClose) {
                     // value is large enough, haven't found peak yet, and not too close
-                    _maxIndices[_maxCount[lev]] = j-1;
-                    _maxCount[lev]++;
+                    maxIndices[maxCount[lev]] = j-1;
+                    maxCount[lev]++;
                     isSearching = false;
                     tooClose = minDist;
                 }
                 climber = -1;
-            } else if(climber <= 0 && test > 0) { // reached valley
-                if (_window[j-1] <= minThresh && isSearching && !tooClose) {
+            } else if(climber <= 0 && window[j] > window[j-1]) { // reached valley
+                if (window[j-1] <= minThresh && isSearching && !tooClose) {
                     // value is small enough, haven't found peak yet, and not too close
-                    _minIndices[_minCount[lev]] = j-1;
-                    _minCount[lev]++;
+                    minIndices[minCount[lev]] = j-1;
+                    minCount[lev]++;
                     isSearching = false;
                     tooClose = minDist;
                 }
@@ -552,8 +926,8 @@ float FLWT::getPitchRobust(int* data, int datalen, long fs) {
             }
             
             // If we reach zero crossing, we can look for another peak
-            if ((_window[j] <= average && _window[j-1] > average) ||
-                (_window[j] >= average && _window[j-1] < average)) {
+            if ((window[j] <= average && window[j-1] > average) ||
+                (window[j] >= average && window[j-1] < average)) {
                 isSearching = true;
             }
             
@@ -563,71 +937,75 @@ float FLWT::getPitchRobust(int* data, int datalen, long fs) {
         }
         
         // Find the mode distance between peaks
-        if (_maxCount[lev] >= 2 && _minCount[lev] >= 2) {
+        if (maxCount[lev] >= 2 && minCount[lev] >= 2) {
             
             // Find all differences between maxima/minima
             for (int j = 1; j <= MAX_NUM_OF_PEAKS_BETWEEN_MODE; j++) {
-                for (int k = 0; k < _maxCount[lev] - j; k++) {
-                    _differs[_dLength] = iabs(_maxIndices[k] - _maxIndices[k+j]);
+                for (int k = 0; k < maxCount[lev] - j; k++) {
+                    differs[_dLength] = iabs(maxIndices[k] - maxIndices[k+j]);
                     _dLength++;
                 }
-                for (int k = 0; k < _minCount[lev] - j; k++) {
-                    _differs[_dLength] = iabs(_minIndices[k] - _minIndices[k+j]);
+                for (int k = 0; k < minCount[lev] - j; k++) {
+                    differs[_dLength] = iabs(minIndices[k] - minIndices[k+j]);
                     _dLength++;
                 }
             }
             
             // Determine the mode
-            int numer = 1; // Require at least two agreeing _differs to yield a mode
-            int numerJ;
+            CostInt numer = 1; // Require at least two agreeing differs to yield a mode
+            CostInt numerJ;
             for (int j = 0; j < _dLength; j++) {
                 numerJ = 0;
                 
-                // Find the number of _differs that are near _differs[j]
+                // Find the number of differs that are near differs[j]
                 for (int n = 0; n < _dLength; n++) {
-                    if (iabs(_differs[j] - _differs[n]) < minDist) {
+                    if (iabs(differs[j] - differs[n]) < minDist) {
                         numerJ++;
                     }
                 }
                 
                 // Check to see if there is a better candidate for the mode
-                if (numerJ >= numer && numerJ > floor((newWidth/_differs[j])>>2)) {
+                if (numerJ >= numer && numerJ > floor((newWidth/differs[j])>>2)) {
                     if (numerJ == numer) {
-                        if (_oldMode && iabs(_differs[j] - (_oldMode >> (lev+1))) < minDist) {
-                            _mode[lev] = _differs[j];
-                        } else if (~_oldMode && (_differs[j] > 1.95*_mode[lev] && _differs[j] < 2.05*_mode[lev])) {
-                            _mode[lev] = _differs[j];
+                        if (_oldMode && iabs(differs[j] - (_oldMode >> (lev+shift))) < minDist) {
+                            mode[lev] = differs[j];
+                        } else if (~_oldMode && (differs[j] > 1.95*mode[lev] && differs[j] < 2.05*mode[lev])) {
+                            mode[lev] = differs[j];
                         }
                     } else {
                         numer = numerJ;
-                        _mode[lev] = _differs[j];
+                        mode[lev] = differs[j];
                     }
-                } else if (numerJ == numer-1 && _oldMode && iabs(_differs[j] - (_oldMode >> (lev+1))) < minDist) {
-                    _mode[lev] = _differs[j];
+                } else if (numerJ == numer-1 && _oldMode && iabs(differs[j] - (_oldMode >> (lev+shift))) < minDist) {
+                    mode[lev] = differs[j];
                 }
             }
             
             // Average to get the mode
-            if (_mode[lev]) {
-                int numerator = 0;
-                int denominator = 0;
+            if (mode[lev]) {
+                CostInt numerator = 0;
+                CostInt denominator = 0;
                 for (int m = 0; m < _dLength; m++) {
-                    if (iabs(_mode[lev] - _differs[m]) <= minDist) {
-                        numerator += _differs[m];
+                    if (iabs(mode[lev] - differs[m]) <= minDist) {
+                        numerator += differs[m];
                         denominator++;
                     }
                 }
-                _mode[lev] = numerator/denominator;
+                mode[lev] = numerator/denominator;
             }
             
             // Check if the mode is shared with the previous level
             if (lev == 0) {
                 // Do nothing
-            } else if (_mode[lev-1] && _maxCount[lev-1] >= 2 && _minCount[lev-1] >= 2) {
+            } else if (mode[lev-1] && maxCount[lev-1] >= 2 && minCount[lev-1] >= 2) {
                 // If the modes are within a sample of one another, return the calculated frequency
-                if (iabs(_mode[lev-1] - 2*_mode[lev]) <= minDist) {
-                    _oldMode = _mode[lev-1];
-                    currentFreq = ((float)fs)/((float)_mode[lev-1])/((float)(1<<(lev)));
+                if (iabs(mode[lev-1] - 2*mode[lev]) <= minDist) {
+                    _oldMode = costValue(mode[lev-1]);
+                    currentFreq = ((float)fs)/((float)mode[lev-1])/((float)(1<<(lev-1+shift)));
+                    _foundLevel = lev + 1 + (_inputStages ? _inputStages - 1 : 0);
+                    if (_diagnostics) {
+                        diagnose(lev + 1, currentFreq, costValue(average), costValue(maxThresh), costValue(minThresh));
+                    }
                     // Add the frequency to the median buffer
                     //addToMedianBuffer(_oldFreq);
                     //return _oldFreq;
@@ -640,13 +1018,17 @@ float FLWT::getPitchRobust(int* data, int datalen, long fs) {
     
     // Getting here means the window was pitchless
     currentFreq = 0.0;
+    _foundLevel = 0;
+    if (_diagnostics) {
+        diagnose(numLevels, 0.0, costValue(average), costValue(maxThresh), costValue(minThresh));
+    }
     // Add to this value to the median filter
     //addToMedianBuffer(0.0);
     //return 0.0;
     
 wrapUp:
     // Check whether the change in frequency is humanly possible
-    /*if (fabs(currentFreq - _oldFreq) < _oldFreq*CHANGE_IN_FREQ_TOLERANCE) {
+    /*if (ffabs(currentFreq - _oldFreq) < _oldFreq*CHANGE_IN_FREQ_TOLERANCE) {
         // If the change wasn't significant then we should use the median filter
         if (currentFreq) {
             addToMedianBuffer(currentFreq);
@@ -682,3 +1064,10 @@ wrapUp:
     }
 }
 
+// The instantiations in use (see FLWT.h). On the device int is int16_t and
+//  floats are software, and the cost model counts the device types only.
+template class BasicFLWT<int, long>;
+#if INT_MAX > 32767 && !defined(PV_COST)
+template class BasicFLWT<int16_t, int32_t>;
+template class BasicFLWT<float, float>;
+#endif
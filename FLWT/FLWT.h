@@ -10,53 +10,152 @@
 #define ____FLWT__
 
 #include <stdio.h>
+#include <stdint.h>
+#include "Profiler.h"
+#include "Arena.h"
 
 #define DEFAULT_WIN_LENGTH  1024
 #define MEDIAN_BUFFER_LENGTH 5
+#define FLWT_MAX_LEVELS     6
+
+// Why a getPitch call ended (FLWTDiagnostics::exitReason)
+#define FLWT_EXIT_PITCH             0   // two neighbouring levels agreed on a mode
+#define FLWT_EXIT_NO_PEAKS          1   // the thresholds were never crossed at any level
+#define FLWT_EXIT_FEW_PEAKS         2   // no level had 2 maxima and 2 minima
+#define FLWT_EXIT_NO_MODE           3   // peaks, but no two differences agreed at any level
+#define FLWT_EXIT_NO_AGREEMENT      4   // modes, but no two neighbouring levels agreed
+#define FLWT_NUM_EXITS              5
+
+// What a getPitch call saw at every level it searched (see FLWT::setDiagnostics())
+struct FLWTDiagnostics {
+    int exitReason;                     // FLWT_EXIT_*
+    float pitch;                        // pitch found before any filtering, 0 if pitchless
+    int foundLevel;                     // as FLWT::getFoundLevel()
+    int average;                        // of the window
+    int maxThresh;                      // peaks must be above this
+    int minThresh;                      // valleys must be below this
+    int levels;                         // levels searched
+    int maxCount[FLWT_MAX_LEVELS];      // peaks found at each level
+    int minCount[FLWT_MAX_LEVELS];      // valleys found at each level
+    int mode[FLWT_MAX_LEVELS];          // distance between peaks at each level (0 = none)
+};
+
+// Aggregate of many FLWTDiagnostics, to right-size the levels and the window
+struct FLWTHistogram {
+    long frames;
+    long foundAt[FLWT_MAX_LEVELS + 1];  // frames whose pitch was found at each level (0 = pitchless)
+    long exits[FLWT_NUM_EXITS];         // frames per exit reason
+    FLWTHistogram() { reset(); }
+    void reset();
+    void add(const FLWTDiagnostics& diagnostics);
+    void print(FILE* out) const;
+};
+
+// Profile slots of getPitch(): the statistics pass, then for each level
+//  the fused lifting and peak search pass and the mode search
+#define FLWT_PROFILE_STATS          0
+#define FLWT_PROFILE_PASS(level)    (1 + 2*(level))
+#define FLWT_PROFILE_MODE(level)    (2 + 2*(level))
+
+// Everything a FLWT carries from one frame to the next (see FLWT::getState())
+struct FLWTState {
+    float oldFreq;
+    int oldMode;
+    float median[MEDIAN_BUFFER_LENGTH];
+    int medianIndex;
+    bool equals(const FLWTState& other) const;
+};
 
 /**
- * @brief      Short class description.
+ * @brief      Fast lifting wavelet transform pitch detector.
  *
- * @details    Verbose description of class details.
+ * @details    SampleT is the type of the samples (and of the window the
+ *             transform works in place on), AccT the wider type of the sums
+ *             that can overflow a sample: the average of the window, the
+ *             approximations (the mean of two samples) and the first
+ *             difference of a level. Storage defaults to 16 bits, which is
+ *             what the device has and halves the memory traffic on the host.
  *
  * Note the following example code:
  * @code
- *    Window win = new Window(parent);
- *    win.show();
+ *    FLWT16 flwt(6, 512);          // int16_t samples, int32_t sums
+ *    float pitch = flwt.getPitch(samples, 512, 48000);
  * @endcode
  */
 
-class FLWT {
+template<class SampleT = int16_t, class AccT = int32_t>
+class BasicFLWT {
 public:
-    //FLWT();
+    //BasicFLWT();
     // windowLen MUST be divisible by 2^(levels-1)
-    FLWT(int levels, int windowLen = DEFAULT_WIN_LENGTH);
-    ~FLWT();
+    BasicFLWT(int levels, int windowLen = DEFAULT_WIN_LENGTH);
+    // Takes every buffer from arena (from the heap if less than getArenaSize() is left)
+    BasicFLWT(int levels, int windowLen, Arena& arena);
+    ~BasicFLWT();
+    // Bytes of an arena the buffers of a FLWT take
+    static size_t getArenaSize(int levels, int windowLen = DEFAULT_WIN_LENGTH);
     // datalen MUST be divisible by 2^(levels-1)
     // Returns 0.0 if it deduces the segment is pitchless
-    float getPitch(int* data, int datalen, long fs);
-    float getPitchWithMedian5(int* data, int datalen, long fs);
-    float getPitchLastReliable(int* data, int datalen, long fs);
-    float getPitchOctaveInvariant(int* data, int datalen, long fs);
-    float getPitchRobust(int* data, int datalen, long fs);
+    float getPitch(const SampleT* data, int datalen, long fs);
+    float getPitchWithMedian5(const SampleT* data, int datalen, long fs);
+    float getPitchLastReliable(const SampleT* data, int datalen, long fs);
+    float getPitchOctaveInvariant(const SampleT* data, int datalen, long fs);
+    float getPitchRobust(const SampleT* data, int datalen, long fs);
+    // Number of levels searched from now on (2 to the number given to the constructor).
+    //  Fewer levels cost less on pitchless frames but miss the lowest pitches.
+    int setLevels(int levels);
+    int getLevels() { return _levels; }
+    // The input is decimated by 2^stages (e.g. by a Decimator); levels and minDist follow
+    int setInputDecimation(int stages);
+    // Level (1 to getLevels()) at which the last call found its pitch, 0 if pitchless
+    int getFoundLevel() const { return _foundLevel; }
+    // Frame to frame state: a FLWT given the state of another continues exactly like it
+    void getState(FLWTState& state) const;
+    void setState(const FLWTState& state);
+    // Back to the state of a new FLWT
+    void resetState();
+    // Time spent in each stage of getPitch() (FLWT_PROFILE_* slots), 0 unless built with PV_PROFILE
+    const Profile* getProfile() const;
+    void resetProfile();
+    // Every later getPitch call fills diagnostics (0 = off, the default)
+    void setDiagnostics(FLWTDiagnostics* diagnostics) { _diagnostics = diagnostics; }
     
 private:
+    void init(int levels, int windowLen, Arena* arena);
     void addToMedianBuffer(float f);
     float median5();
-    int *_window;
+    void diagnose(int levels, float pitch, int average, int maxThresh, int minThresh);
+    SampleT* _window;
     int _levels;
-    int *_maxCount;
-    int *_minCount;
-    int *_maxIndices;
-    int *_minIndices;
+    int _maxLevels;
+    int _inputStages;
+    int* _maxCount;
+    int* _minCount;
+    int* _maxIndices;
+    int* _minIndices;
     float _oldFreq;
     int _oldMode;
-    int *_mode;
+    int _foundLevel;
+    int* _mode;
     int _winLength;
     int _dLength;
-    int *_differs;
+    int* _differs;
     float *_medianBuffer5;
     int _medianBufferLastIndex;
+    FLWTDiagnostics* _diagnostics;
+    bool _ownsBuffers;                  // false if they are in an arena
+#ifdef PV_PROFILE
+    Profile _profile;
+#endif
 };
 
+// The detector of the sketch: int samples and long sums, which are the
+//  16 and 32 bits of the device
+typedef BasicFLWT<int, long> FLWT;
+// Explicit widths and float samples. The host tools (PitchCorrector,
+//  PitchTracker, StreamEngine) use FLWT16. On the device FLWT16 is the same
+//  class as FLWT and FLWTFloat is not built (see FLWT.cpp).
+typedef BasicFLWT<int16_t, int32_t> FLWT16;
+typedef BasicFLWT<float, float> FLWTFloat;
+
 #endif /* defined(____FLWT__) */
@@ -3,6 +3,7 @@
 //
 //
 //  Created by Terry Kong on 2/22/15.
+//  Build: g++ -I../Profiler -I../CostModel -I../Arena main.cpp FLWT.cpp
 //
 //
 
@@ -0,0 +1,417 @@
+//
+//  FixedPoint.h
+//
+//
+//  Q15 and Q31 fixed point arithmetic, header only: rounding and
+//  saturating operations on raw values of any integer type, the Q15 and
+//  Q31 value types built on them (formats only mix through fixedConvert()),
+//  and batch operations on arrays of Q15, eight at a time with SSE2/SSSE3
+//  when available.
+//
+//
+
+#ifndef ____FixedPoint__
+#define ____FixedPoint__
+
+#include <stdint.h>
+#include <limits.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+/**
+ *  @file FixedPoint.h
+ *  @brief Q15 and Q31 fixed point arithmetic.
+ *
+ *  @details A Qn value is an integer standing for itself divided by 2^n.
+ *      Products are rounded to nearest (ties up, like the rounding multiply
+ *      of the C5535) and every operation but the explicitly wrapping ones
+ *      saturates to the range of the format, so -1 * -1 gives the largest
+ *      positive value instead of wrapping to -1.
+ *
+ *  @n The raw functions (fixedMulRaw(), q15AddSatRaw(), ...) work on any
+ *      integer type that holds the values (int16_t, the int of the device
+ *      or of the host, a counting type of CostModel.h) and form their
+ *      intermediate results in the Wide type given, so templated DSP code
+ *      can use them whatever its sample type. Q15 and Q31 wrap the raw
+ *      values in types of their own; a Q15 and a Q31 (or a Q15 and an
+ *      integer) do not mix without a conversion, and a format whose
+ *      fraction does not fit its storage, or whose products do not fit
+ *      its wide type, does not compile.
+ *
+ *  @b Example:
+ *
+ *  @code
+ *    Q15 gain = Q15::fromFloat(0.5f);
+ *    Q15 y = x*gain + offset;                  // rounded and saturated
+ *    Q31 z = fixedConvert<Q31>(y);             // y + z would not compile
+ *    q15MulBatch(samples, window, samples, n); // eight at a time with SSSE3
+ *  @endcode
+ */
+
+#define Q15_FBITS           15
+#define Q15_MAX             32767
+#define Q15_MIN             (-32767 - 1)
+#define Q15_ROUND           (1 << (Q15_FBITS - 1))
+#define Q31_FBITS           31
+#define Q31_MAX             2147483647L
+#define Q31_MIN             (-2147483647L - 1)
+#define Q31_ROUND           (1L << (Q31_FBITS - 1))
+
+// Compile time check: the typedef is an array of -1 chars when the condition is false
+template<bool condition> struct FixedCheck {
+    enum { size = -1 };
+};
+template<> struct FixedCheck<true> {
+    enum { size = 1 };
+};
+#define FIXED_CHECK(condition, name) typedef char name[FixedCheck<(condition)>::size]
+
+// 64 bit type of the Q31 products: int64_t, or long long where <stdint.h>
+//  has no int64_t. The C55x tools may have neither (their long long is 40
+//  bits), so everything Q31 is only defined where FIXED_HAS_Q31 is.
+#if defined(INT64_MAX)
+typedef int64_t FixedInt64;
+#define FIXED_HAS_Q31
+#elif defined(LLONG_MAX) && (LLONG_MAX >> 31 >> 31) > 0
+typedef long long FixedInt64;
+#define FIXED_HAS_Q31
+#endif
+
+// ====================================
+// Raw values of any integer type
+// ====================================
+
+/** x saturated to [lo, hi] and converted to T */
+template<class T, class Wide> inline T fixedSaturate(const Wide& x, long lo, long hi) {
+    if (x > hi) {
+        return (T)hi;
+    }
+    if (x < lo) {
+        return (T)lo;
+    }
+    return (T)x;
+}
+
+/** x*y formed in Wide. CostModel.h overloads it so that a 16x16 -> 32 bit
+ *  product of its counting types counts as the single multiply it is on the device */
+template<class Wide, class T> inline Wide fixedWideMul(const T& x, const T& y) {
+    return (Wide)x*y;
+}
+
+/** Product of two values with fbits fraction bits, rounded and saturated to [lo, hi] */
+template<int fbits, class Wide, class T> inline T fixedMulRaw(const T& x, const T& y, long lo, long hi) {
+    Wide product = fixedWideMul<Wide>(x, y);
+    product += (Wide)1 << (fbits - 1);
+    return fixedSaturate<T>((Wide)(product >> fbits), lo, hi);
+}
+
+/** Sum saturated to [lo, hi] */
+template<class Wide, class T> inline T fixedAddSatRaw(const T& x, const T& y, long lo, long hi) {
+    Wide sum = (Wide)x + y;
+    return fixedSaturate<T>(sum, lo, hi);
+}
+
+/** Difference saturated to [lo, hi] */
+template<class Wide, class T> inline T fixedSubSatRaw(const T& x, const T& y, long lo, long hi) {
+    Wide difference = (Wide)x - y;
+    return fixedSaturate<T>(difference, lo, hi);
+}
+
+/** Q15 product of raw values, formed in Wide */
+template<class Wide, class T> inline T q15MulRaw(const T& x, const T& y) {
+    return fixedMulRaw<Q15_FBITS, Wide>(x, y, Q15_MIN, Q15_MAX);
+}
+
+/** Q15 product of raw values, formed in Wide and rounded but not saturated:
+ *  only -1 * -1 overflows, so it suits operands of which one is never -1 */
+template<class Wide, class T> inline T q15MulRoundRaw(const T& x, const T& y) {
+    Wide product = fixedWideMul<Wide>(x, y);
+    product += Q15_ROUND;
+    return (T)(product >> Q15_FBITS);
+}
+// A float holds the Q15 value unscaled: the product is not rounded
+template<> inline float q15MulRoundRaw<float, float>(const float& x, const float& y) {
+    return x*y*(1.0f/(1 << Q15_FBITS));
+}
+
+/** Q30 value (e.g. a sum of Q15 products) rounded to Q15 and saturated */
+template<class T, class Wide> inline T q15RoundSatRaw(const Wide& x) {
+    return fixedSaturate<T>((Wide)((x + Q15_ROUND) >> Q15_FBITS), Q15_MIN, Q15_MAX);
+}
+
+/** Q15 sum of raw values wrapping around like the adder of the width of T */
+template<class T> inline T q15AddWrapRaw(const T& x, const T& y) {
+    return x + y;
+}
+
+/** Q15 sum of raw values saturated to the Q15 range, formed in Wide */
+template<class Wide, class T> inline T q15AddSatRaw(const T& x, const T& y) {
+    return fixedAddSatRaw<Wide>(x, y, Q15_MIN, Q15_MAX);
+}
+
+/** Q15 difference of raw values saturated to the Q15 range, formed in Wide */
+template<class Wide, class T> inline T q15SubSatRaw(const T& x, const T& y) {
+    return fixedSubSatRaw<Wide>(x, y, Q15_MIN, Q15_MAX);
+}
+
+// ====================================
+// int16_t (Q15) and int32_t (Q31)
+// ====================================
+
+/** Rounded, saturated Q15 product */
+inline int16_t q15Mul(int16_t x, int16_t y) {
+    return q15MulRaw<int32_t>(x, y);
+}
+
+/** Saturated Q15 sum */
+inline int16_t q15AddSat(int16_t x, int16_t y) {
+    return q15AddSatRaw<int32_t>(x, y);
+}
+
+/** Saturated Q15 difference */
+inline int16_t q15SubSat(int16_t x, int16_t y) {
+    return q15SubSatRaw<int32_t>(x, y);
+}
+
+/** Q15 sum wrapping around like the 16 bit adder */
+inline int16_t q15AddWrap(int16_t x, int16_t y) {
+    return (int16_t)(uint16_t)((uint16_t)x + (uint16_t)y);
+}
+
+#ifdef FIXED_HAS_Q31
+/** Rounded, saturated Q31 product */
+inline int32_t q31Mul(int32_t x, int32_t y) {
+    return fixedMulRaw<Q31_FBITS, FixedInt64>(x, y, Q31_MIN, Q31_MAX);
+}
+
+/** Saturated Q31 sum */
+inline int32_t q31AddSat(int32_t x, int32_t y) {
+    return fixedAddSatRaw<FixedInt64>(x, y, Q31_MIN, Q31_MAX);
+}
+
+/** Saturated Q31 difference */
+inline int32_t q31SubSat(int32_t x, int32_t y) {
+    return fixedSubSatRaw<FixedInt64>(x, y, Q31_MIN, Q31_MAX);
+}
+#endif
+
+// ====================================
+// Value types
+// ====================================
+
+// Range of the storage types of the formats
+template<class Raw> struct FixedLimits;
+template<> struct FixedLimits<int16_t> {
+    static long min() { return Q15_MIN; }
+    static long max() { return Q15_MAX; }
+};
+template<> struct FixedLimits<int32_t> {
+    static long min() { return Q31_MIN; }
+    static long max() { return Q31_MAX; }
+};
+
+/**
+ * @brief      A fixed point value with FBits fraction bits stored in Raw.
+ *
+ * @details    Arithmetic saturates and products are rounded; only values
+ *             of the same format mix. Wide must hold the product of two
+ *             Raw values.
+ */
+template<int FBits, class Raw, class Wide>
+class Fixed {
+    FIXED_CHECK(FBits > 0 && FBits < (int)(sizeof(Raw)*CHAR_BIT), fractionMustFitTheStorage);
+    FIXED_CHECK(sizeof(Wide) >= 2*sizeof(Raw), wideTypeMustHoldProducts);
+public:
+    enum { fractionBits = FBits };
+    typedef Raw RawType;
+    Fixed() : _raw(0) {}
+    static Fixed fromRaw(Raw raw) {
+        Fixed x;
+        x._raw = raw;
+        return x;
+    }
+    // Rounded to nearest and saturated
+    static Fixed fromFloat(double value) {
+        double scaled = value*((Wide)1 << FBits);
+        scaled += (scaled < 0) ? -0.5 : 0.5;
+        if (scaled > FixedLimits<Raw>::max()) {
+            return fromRaw((Raw)FixedLimits<Raw>::max());
+        }
+        if (scaled < FixedLimits<Raw>::min()) {
+            return fromRaw((Raw)FixedLimits<Raw>::min());
+        }
+        return fromRaw((Raw)(Wide)scaled);
+    }
+    static Fixed max() { return fromRaw((Raw)FixedLimits<Raw>::max()); }
+    static Fixed min() { return fromRaw((Raw)FixedLimits<Raw>::min()); }
+    Raw raw() const { return _raw; }
+    double toFloat() const { return (double)_raw/((Wide)1 << FBits); }
+    Fixed operator+(const Fixed& y) const {
+        return fromRaw(fixedAddSatRaw<Wide>(_raw, y._raw, FixedLimits<Raw>::min(), FixedLimits<Raw>::max()));
+    }
+    Fixed operator-(const Fixed& y) const {
+        return fromRaw(fixedSubSatRaw<Wide>(_raw, y._raw, FixedLimits<Raw>::min(), FixedLimits<Raw>::max()));
+    }
+    Fixed operator*(const Fixed& y) const {
+        return fromRaw(fixedMulRaw<FBits, Wide>(_raw, y._raw, FixedLimits<Raw>::min(), FixedLimits<Raw>::max()));
+    }
+    // -min() saturates to max()
+    Fixed operator-() const { return Fixed() - *this; }
+    Fixed& operator+=(const Fixed& y) { return *this = *this + y; }
+    Fixed& operator-=(const Fixed& y) { return *this = *this - y; }
+    Fixed& operator*=(const Fixed& y) { return *this = *this*y; }
+    // Sum wrapping around like the adder of the storage width
+    Fixed addWrap(const Fixed& y) const {
+        return fromRaw((Raw)((Wide)_raw + y._raw));
+    }
+    bool operator==(const Fixed& y) const { return _raw == y._raw; }
+    bool operator!=(const Fixed& y) const { return _raw != y._raw; }
+    bool operator<(const Fixed& y) const { return _raw < y._raw; }
+    bool operator<=(const Fixed& y) const { return _raw <= y._raw; }
+    bool operator>(const Fixed& y) const { return _raw > y._raw; }
+    bool operator>=(const Fixed& y) const { return _raw >= y._raw; }
+
+private:
+    Raw _raw;
+};
+
+typedef Fixed<Q15_FBITS, int16_t, int32_t> Q15;
+#ifdef FIXED_HAS_Q31
+typedef Fixed<Q31_FBITS, int32_t, FixedInt64> Q31;
+
+/** ====================================================
+ * @brief       Converts between formats.
+ *
+ * @details     Gaining fraction bits is exact (saturated if the integer
+ *              part does not fit), losing them rounds to nearest.
+ *
+ * @code
+ *    Q31 wide = fixedConvert<Q31>(Q15::fromFloat(0.25));
+ * @endcode
+ * ======================================================
+ */
+template<class To, class From> inline To fixedConvert(const From& x) {
+    typedef typename To::RawType ToRaw;
+    int shift = (int)To::fractionBits - (int)From::fractionBits;
+    FixedInt64 value = x.raw();
+    if (shift >= 0) {
+        value = value*((FixedInt64)1 << shift);
+    } else {
+        value = (value + ((FixedInt64)1 << (-shift - 1))) >> -shift;
+    }
+    return To::fromRaw(fixedSaturate<ToRaw>(value, FixedLimits<ToRaw>::min(), FixedLimits<ToRaw>::max()));
+}
+#endif
+
+// ====================================
+// Batch operations on n values (out may be one of the inputs)
+// ====================================
+
+#if defined(__SSE2__)
+/** Rounded Q15 products of eight values, -1 * -1 saturated */
+inline __m128i q15MulVector(__m128i x, __m128i y) {
+#if defined(__SSSE3__)
+    __m128i product = _mm_mulhrs_epi16(x, y);
+#else
+    // (x*y + 2^14) >> 15 from the high and low halves of the 32 bit products
+    __m128i high = _mm_mulhi_epi16(x, y);
+    __m128i low = _mm_mullo_epi16(x, y);
+    __m128i product = _mm_or_si128(_mm_slli_epi16(high, 1), _mm_srli_epi16(low, 15));
+    product = _mm_add_epi16(product, _mm_and_si128(_mm_srli_epi16(low, 14), _mm_set1_epi16(1)));
+#endif
+    // Only -1 * -1 gives -1 (0x8000)
+    __m128i overflow = _mm_cmpeq_epi16(product, _mm_set1_epi16((short)0x8000));
+    return _mm_xor_si128(product, overflow);
+}
+#endif
+
+/** out = x*y (rounded, saturated) */
+inline void q15MulBatch(const Q15* x, const Q15* y, Q15* out, int n) {
+    const int16_t* a = (const int16_t*)x;
+    const int16_t* b = (const int16_t*)y;
+    int16_t* c = (int16_t*)out;
+    int i = 0;
+#if defined(__SSE2__)
+    for (; i + 8 <= n; i += 8) {
+        __m128i product = q15MulVector(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i)));
+        _mm_storeu_si128((__m128i*)(c + i), product);
+    }
+#endif
+    for (; i < n; i++) {
+        c[i] = q15Mul(a[i], b[i]);
+    }
+}
+
+/** out = x + y (saturated) */
+inline void q15AddSatBatch(const Q15* x, const Q15* y, Q15* out, int n) {
+    const int16_t* a = (const int16_t*)x;
+    const int16_t* b = (const int16_t*)y;
+    int16_t* c = (int16_t*)out;
+    int i = 0;
+#if defined(__SSE2__)
+    for (; i + 8 <= n; i += 8) {
+        __m128i sum = _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i)));
+        _mm_storeu_si128((__m128i*)(c + i), sum);
+    }
+#endif
+    for (; i < n; i++) {
+        c[i] = q15AddSat(a[i], b[i]);
+    }
+}
+
+/** out = x - y (saturated) */
+inline void q15SubSatBatch(const Q15* x, const Q15* y, Q15* out, int n) {
+    const int16_t* a = (const int16_t*)x;
+    const int16_t* b = (const int16_t*)y;
+    int16_t* c = (int16_t*)out;
+    int i = 0;
+#if defined(__SSE2__)
+    for (; i + 8 <= n; i += 8) {
+        __m128i difference = _mm_subs_epi16(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i)));
+        _mm_storeu_si128((__m128i*)(c + i), difference);
+    }
+#endif
+    for (; i < n; i++) {
+        c[i] = q15SubSat(a[i], b[i]);
+    }
+}
+
+/** acc = acc + x*y (product rounded, sum saturated): windowed overlap and add */
+inline void q15MulAddBatch(const Q15* x, const Q15* y, Q15* acc, int n) {
+    const int16_t* a = (const int16_t*)x;
+    const int16_t* b = (const int16_t*)y;
+    int16_t* c = (int16_t*)acc;
+    int i = 0;
+#if defined(__SSE2__)
+    for (; i + 8 <= n; i += 8) {
+        __m128i product = q15MulVector(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i)));
+        _mm_storeu_si128((__m128i*)(c + i), _mm_adds_epi16(_mm_loadu_si128((const __m128i*)(c + i)), product));
+    }
+#endif
+    for (; i < n; i++) {
+        c[i] = q15AddSat(c[i], q15Mul(a[i], b[i]));
+    }
+}
+
+/** out = x*gain (rounded, saturated) */
+inline void q15ScaleBatch(const Q15* x, Q15 gain, Q15* out, int n) {
+    const int16_t* a = (const int16_t*)x;
+    int16_t g = gain.raw();
+    int16_t* c = (int16_t*)out;
+    int i = 0;
+#if defined(__SSE2__)
+    __m128i gains = _mm_set1_epi16(g);
+    for (; i + 8 <= n; i += 8) {
+        _mm_storeu_si128((__m128i*)(c + i), q15MulVector(_mm_loadu_si128((const __m128i*)(a + i)), gains));
+    }
+#endif
+    for (; i < n; i++) {
+        c[i] = q15Mul(a[i], g);
+    }
+}
+
+#endif /* defined(____FixedPoint__) */
@@ -0,0 +1,183 @@
+//
+//  main.cpp
+//
+//
+//  Checks the Q15 and Q31 operations on their edge cases (the largest and
+//  smallest values, -1 * -1, ties of the rounding), the batch operations
+//  against the scalar ones on random data and the conversions between
+//  formats, then times the batch operations. Exits with 1 on any mismatch.
+//  Build: g++ -std=c++11 -O2 main.cpp
+//         (add -mssse3 for the SSSE3 multiply, -mno-sse2 for the scalar loops)
+//  Usage: a.out
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "FixedPoint.h"
+#include <iostream>
+#include <chrono>
+
+using namespace std;
+
+const int batchLength = 1027;      // not a multiple of 8, so the scalar tail runs too
+const int timedRuns = 2000;
+
+int failures = 0;
+
+void expect(const char* what, long value, long expected) {
+    if (value != expected) {
+        printf("  %-40s %ld, expected %ld  FAIL\n", what, value, expected);
+        failures++;
+    }
+}
+
+// Exact result of a Q15 product, rounded to nearest (ties up) and saturated
+long referenceMul(long x, long y) {
+    long product = (x*y + Q15_ROUND) >> Q15_FBITS;
+    return product > Q15_MAX ? Q15_MAX : product;
+}
+
+void testScalar() {
+    expect("q15Mul(-1, -1)", q15Mul(Q15_MIN, Q15_MIN), Q15_MAX);
+    expect("q15Mul(-1, max)", q15Mul(Q15_MIN, Q15_MAX), -Q15_MAX);
+    expect("q15Mul(max, max)", q15Mul(Q15_MAX, Q15_MAX), 32766);
+    expect("q15Mul(1/2 lsb tie up)", q15Mul(1, 1 << 14), 1);
+    expect("q15Mul(-1/2 lsb tie up)", q15Mul(-1, 1 << 14), 0);
+    expect("q15AddSat(max, 1)", q15AddSat(Q15_MAX, 1), Q15_MAX);
+    expect("q15AddSat(min, -1)", q15AddSat(Q15_MIN, -1), Q15_MIN);
+    expect("q15SubSat(min, 1)", q15SubSat(Q15_MIN, 1), Q15_MIN);
+    expect("q15SubSat(0, min)", q15SubSat(0, Q15_MIN), Q15_MAX);
+    expect("q15AddWrap(max, 1)", q15AddWrap(Q15_MAX, 1), Q15_MIN);
+    expect("q15MulRoundRaw(-1, -1) wraps", q15MulRoundRaw<int32_t>((int16_t)Q15_MIN, (int16_t)Q15_MIN), Q15_MIN);
+    expect("q15MulRoundRaw(-1, max)", q15MulRoundRaw<int32_t>((int16_t)Q15_MIN, (int16_t)Q15_MAX), -Q15_MAX);
+    expect("q15RoundSatRaw(max*max)", q15RoundSatRaw<int16_t>(32767L*32767), 32766);
+    expect("q15RoundSatRaw(overshoot)", q15RoundSatRaw<int16_t>(32767L*32767*2), Q15_MAX);
+    expect("q15AddWrapRaw(max, 1)", q15AddWrapRaw<int16_t>(Q15_MAX, 1), Q15_MIN);
+    expect("q31Mul(-1, -1)", q31Mul(Q31_MIN, Q31_MIN), Q31_MAX);
+    expect("q31Mul(1/2, 1/2)", q31Mul(1L << 30, 1L << 30), 1L << 29);
+    expect("q31AddSat(max, 1)", q31AddSat(Q31_MAX, 1), Q31_MAX);
+    expect("q31SubSat(min, 1)", q31SubSat(Q31_MIN, 1), Q31_MIN);
+
+    // Every product of a sweep of values against the exact result
+    for (long x = Q15_MIN; x <= Q15_MAX; x += 127) {
+        for (long y = Q15_MIN; y <= Q15_MAX; y += 113) {
+            if (q15Mul((int16_t)x, (int16_t)y) != referenceMul(x, y)) {
+                expect("q15Mul sweep", q15Mul((int16_t)x, (int16_t)y), referenceMul(x, y));
+                return;
+            }
+        }
+    }
+}
+
+void testTypes() {
+    Q15 half = Q15::fromFloat(0.5);
+    Q15 quarter = Q15::fromFloat(0.25);
+    expect("Q15 0.5*0.5", (half*half).raw(), quarter.raw());
+    expect("Q15 0.5+0.5 saturates", (half + half).raw(), Q15::max().raw());
+    expect("Q15 -min saturates", (-Q15::min()).raw(), Q15_MAX);
+    expect("Q15 fromFloat(2)", Q15::fromFloat(2).raw(), Q15_MAX);
+    expect("Q15 fromFloat(-1)", Q15::fromFloat(-1).raw(), Q15_MIN);
+    expect("Q15 addWrap", Q15::max().addWrap(Q15::fromRaw(1)).raw(), Q15_MIN);
+    expect("Q15 -> Q31", fixedConvert<Q31>(quarter).raw(), 1L << 29);
+    expect("Q31 -> Q15 rounds", fixedConvert<Q15>(Q31::fromRaw((1L << 15) + (1L << 15) + (1L << 15))).raw(), 2);
+    expect("Q31 max -> Q15", fixedConvert<Q15>(Q31::max()).raw(), Q15_MAX);
+    expect("Q31 0.25 - 0.5", (Q31::fromFloat(0.25) - Q31::fromFloat(0.5)).raw(), -(1L << 29));
+    // Q15 + Q31 or Q15 + 1 do not compile: every mix goes through fixedConvert()
+}
+
+void testBatch() {
+    static Q15 x[batchLength], y[batchLength], out[batchLength], acc[batchLength];
+    srand(1);
+    for (int i = 0; i < batchLength; i++) {
+        x[i] = Q15::fromRaw((int16_t)(rand() & 0xFFFF));
+        y[i] = Q15::fromRaw((int16_t)(rand() & 0xFFFF));
+        acc[i] = Q15::fromRaw((int16_t)(rand() & 0xFFFF));
+    }
+    // The edge cases in the vectorized part
+    x[0] = y[0] = Q15::min();
+    x[1] = Q15::max();
+    y[1] = Q15::max();
+    x[2] = Q15::min();
+    y[2] = Q15::max();
+
+    q15MulBatch(x, y, out, batchLength);
+    for (int i = 0; i < batchLength; i++) {
+        if (out[i] != x[i]*y[i]) {
+            expect("q15MulBatch", out[i].raw(), (x[i]*y[i]).raw());
+            break;
+        }
+    }
+    q15AddSatBatch(x, y, out, batchLength);
+    for (int i = 0; i < batchLength; i++) {
+        if (out[i] != x[i] + y[i]) {
+            expect("q15AddSatBatch", out[i].raw(), (x[i] + y[i]).raw());
+            break;
+        }
+    }
+    q15SubSatBatch(x, y, out, batchLength);
+    for (int i = 0; i < batchLength; i++) {
+        if (out[i] != x[i] - y[i]) {
+            expect("q15SubSatBatch", out[i].raw(), (x[i] - y[i]).raw());
+            break;
+        }
+    }
+    Q15 gain = Q15::fromFloat(-0.75);
+    q15ScaleBatch(x, gain, out, batchLength);
+    for (int i = 0; i < batchLength; i++) {
+        if (out[i] != x[i]*gain) {
+            expect("q15ScaleBatch", out[i].raw(), (x[i]*gain).raw());
+            break;
+        }
+    }
+    for (int i = 0; i < batchLength; i++) {
+        out[i] = acc[i];
+    }
+    q15MulAddBatch(x, y, out, batchLength);
+    for (int i = 0; i < batchLength; i++) {
+        if (out[i] != acc[i] + x[i]*y[i]) {
+            expect("q15MulAddBatch", out[i].raw(), (acc[i] + x[i]*y[i]).raw());
+            break;
+        }
+    }
+}
+
+void timeBatch() {
+    static Q15 x[batchLength], y[batchLength], out[batchLength];
+    for (int i = 0; i < batchLength; i++) {
+        x[i] = Q15::fromRaw((int16_t)(i*37));
+        y[i] = Q15::fromRaw((int16_t)(i*-91));
+    }
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int r = 0; r < timedRuns; r++) {
+        q15MulBatch(x, y, out, batchLength);
+        x[r % batchLength] = out[(r*7) % batchLength];
+    }
+    double batch = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < timedRuns; r++) {
+        for (int i = 0; i < batchLength; i++) {
+            out[i] = x[i]*y[i];
+        }
+        x[r % batchLength] = out[(r*7) % batchLength];
+    }
+    double scalar = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    printf("q15MulBatch %.2f ns/sample, Q15 operator* %.2f ns/sample\n",
+           1e9*batch/timedRuns/batchLength, 1e9*scalar/timedRuns/batchLength);
+}
+
+int main() {
+    cout<<endl<<"FixedPoint Testing: "<<endl<<endl;
+#if defined(__SSSE3__)
+    printf("batch operations: SSSE3\n");
+#elif defined(__SSE2__)
+    printf("batch operations: SSE2\n");
+#else
+    printf("batch operations: scalar\n");
+#endif
+    testScalar();
+    testTypes();
+    testBatch();
+    timeBatch();
+    printf("%s\n", failures ? "FAIL" : "all operations match");
+    return failures ? 1 : 0;
+}
@@ -13,6 +13,18 @@
 #define MAJOR_SCALE             1
 #define MINOR_SCALE             -1
 
+// Scale masks: bit n is set if the key n steps above the tonic is in the scale
+#define SCALE_MASK_CHROMATIC            0x0FFFUL
+#define SCALE_MASK_MAJOR                0x0AB5UL
+#define SCALE_MASK_MINOR                0x05ADUL
+#define SCALE_MASK_DORIAN               0x06ADUL
+#define SCALE_MASK_PHRYGIAN             0x05ABUL
+#define SCALE_MASK_LYDIAN               0x0AD5UL
+#define SCALE_MASK_MIXOLYDIAN           0x06B5UL
+#define SCALE_MASK_LOCRIAN              0x056BUL
+#define SCALE_MASK_MAJOR_PENTATONIC     0x0295UL
+#define SCALE_MASK_MINOR_PENTATONIC     0x04A9UL
+
 #define A_SCALE                 1
 #define As_SCALE                2
 #define B_SCALE                 3
@@ -115,16 +127,41 @@
 #define  B7_KEY         87
 #define  C8_KEY         88
 
+/**
+ Read-only description of a tuning. Key numbers run from 1 to numKeys and
+ both tables have numKeys+1 entries so that the index is the key number.
+ Instances are generated at compile time by the Tuning template (Tuning.h).
+ */
+struct TuningTable {
+    float referencePitch;       // frequency of the reference key (Hz)
+    int referenceKey;           // key number tuned to referencePitch
+    int divisions;              // keys per octave
+    int numKeys;                // number of keys in the table
+    unsigned long scaleMask;    // scale used by getClosestKeyNumInTuningScale()
+    const float* keyFreq;       // frequency of each key (Hz)
+    const float* keyPeriod;     // period of each key (s), may be 0
+};
+
 class Frequency {
 public:
-    //Frequency();
+    // tuning = 0 selects the standard A4 = 440 Hz piano
+    Frequency(const TuningTable* tuning = 0);
     //~Frequency();
     int getClosestKeyNum(float freq);
     int getClosestKeyNumInScale(float freq, int keyThatBeginsScale, int majorOrMinor);
+    int getClosestKeyNumInScaleMask(float freq, int keyThatBeginsScale, unsigned long scaleMask);
+    int getClosestKeyNumInTuningScale(float freq, int keyThatBeginsScale);
     float getClosestKeyFreqInScale(float freq, int keyThatBeginsScale, int majorOrMinor);
     const char* getKeyName(int keynum);
     float getFreqOfKeyNum(int key);
+    float getPeriodOfKeyNum(int key, long fs);
+    void quantizeBatch(const float* in, int n, int keyThatBeginsScale, unsigned long scaleMask,
+                       float* outFreq, int* outKey, float* outCents);
+    void setTuning(const TuningTable* tuning);
+    const TuningTable* getTuning() const { return _tuning; }
     
+private:
+    const TuningTable* _tuning;
 };
 
 #endif
@@ -0,0 +1,121 @@
+//
+//  Tuning.h
+//
+//
+//  Compile-time generated tuning tables for the Frequency class.
+//
+//
+
+#ifndef _Tuning_h
+#define _Tuning_h
+
+#include "Frequency.h"
+
+/**
+ *  @file Tuning.h
+ *  @brief Compile-time generated key frequency and period tables.
+ *
+ *  @details The tables are computed by the compiler for any reference pitch,
+ *      any equal-tempered division of the octave and any scale mask, so a
+ *      program can hold several tunings and hand a different one to each
+ *      Frequency object without doing any math at runtime. The reference
+ *      pitch is given in mHz since floating point template arguments are
+ *      not allowed.
+ *
+ *  @b Example:
+ *
+ *  @code
+ *    Frequency baroque(&Tuning<415000>::table);
+ *    Frequency pentatonic(&Tuning<432000, 12, SCALE_MASK_MAJOR_PENTATONIC>::table);
+ *    Frequency quarterTone(&Tuning<440000, 24, 0, 176, 97>::table);   // mask 0: all 24 keys
+ *  @endcode
+ *
+ *  Requires C++14 (constexpr loops). Compilers without it can keep using the
+ *  standard table built into Frequency.cpp.
+ */
+
+#if __cplusplus >= 201402L
+
+namespace TuningDetail {
+
+    /** 2^x evaluated by the compiler (integer part by doubling, fraction by Taylor series) */
+    constexpr double exp2(double x) {
+        int whole = (int)x;
+        if (x < whole) {
+            whole--;
+        }
+        double y = (x - whole)*0.69314718055994530942;
+        double term = 1.0;
+        double sum = 1.0;
+        for (int i = 1; i < 24; i++) {
+            term *= y/i;
+            sum += term;
+        }
+        for (; whole > 0; whole--) {
+            sum *= 2.0;
+        }
+        for (; whole < 0; whole++) {
+            sum *= 0.5;
+        }
+        return sum;
+    }
+
+    /** Frequency and period of every key, index 0 is -1 like the standard table */
+    template <long ReferenceMilliHz, int Divisions, int NumKeys, int ReferenceKey>
+    struct Tables {
+        float freq[NumKeys + 1];
+        float period[NumKeys + 1];
+
+        constexpr Tables() : freq(), period() {
+            freq[0] = -1.0f;
+            period[0] = -1.0f;
+            for (int key = 1; key <= NumKeys; key++) {
+                double f = ReferenceMilliHz/1000.0*exp2((double)(key - ReferenceKey)/Divisions);
+                freq[key] = (float)f;
+                period[key] = (float)(1.0/f);
+            }
+        }
+    };
+}
+
+/** ====================================================
+ * @brief       Compile-time tuning.
+ *
+ * @tparam      ReferenceMilliHz    Frequency of the reference key in mHz (e.g. 440000)
+ * @tparam      Divisions           Equal-tempered keys per octave
+ * @tparam      ScaleMask           Scale used by Frequency::getClosestKeyNumInTuningScale
+ * @tparam      NumKeys             Number of keys in the table
+ * @tparam      ReferenceKey        Key number that is tuned to the reference pitch
+ * ======================================================
+ */
+template <long ReferenceMilliHz, int Divisions = 12, unsigned long ScaleMask = SCALE_MASK_MAJOR,
+          int NumKeys = 88, int ReferenceKey = A4_KEY>
+struct Tuning {
+    static_assert(ReferenceMilliHz > 0, "reference pitch must be positive");
+    static_assert(Divisions > 0 && Divisions <= 32, "scale masks hold at most 32 keys per octave");
+    static_assert(ReferenceKey >= 1 && ReferenceKey <= NumKeys, "reference key must be in the table");
+
+    typedef TuningDetail::Tables<ReferenceMilliHz, Divisions, NumKeys, ReferenceKey> Tables;
+
+    /** Key frequencies and periods, computed by the compiler */
+    static constexpr Tables tables = Tables();
+
+    /** Descriptor handed to Frequency */
+    static constexpr TuningTable table = {ReferenceMilliHz/1000.0f, ReferenceKey, Divisions, NumKeys, ScaleMask,
+                                          tables.freq, tables.period};
+};
+
+template <long R, int D, unsigned long S, int N, int K>
+constexpr typename Tuning<R, D, S, N, K>::Tables Tuning<R, D, S, N, K>::tables;
+
+template <long R, int D, unsigned long S, int N, int K>
+constexpr TuningTable Tuning<R, D, S, N, K>::table;
+
+// Common concert pitches
+typedef Tuning<432000> Tuning432;
+typedef Tuning<440000> Tuning440;
+typedef Tuning<442000> Tuning442;
+
+#endif
+
+#endif
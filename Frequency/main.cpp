@@ -3,12 +3,14 @@
 //  
 //
 //  Created by Terry Kong on 2/18/15.
+//  Build: g++ -std=c++14 -O2 -I../CostModel main.cpp Frequency.cpp
 //
 //
 
 #include <stdio.h>
 #include <iostream>
 #include "Frequency.h"
+#include "Tuning.h"
 #include <string.h>
 
 using namespace std;
@@ -26,6 +28,25 @@ int main() {
     for(int i = 1; i <= 88; i++) {
         std::cout << "closest key in c scale: " <<f.getKeyName(i) << " "<< f.getClosestKeyFreqInScale(f.getFreqOfKeyNum(i),C_SCALE,MAJOR_SCALE) << endl;
     }
+    
+#if __cplusplus >= 201402L
+    // Same lookups with a compile-time generated A4 = 432 Hz pentatonic tuning (C++14)
+    Frequency f432(&Tuning<432000, 12, SCALE_MASK_MAJOR_PENTATONIC>::table);
+    std::cout << endl << "A4 at 432: " << f432.getFreqOfKeyNum(A4_KEY) << " period @ 48k: " << f432.getPeriodOfKeyNum(A4_KEY,48000) << endl;
+    for(int i = C4_KEY; i <= C5_KEY; i++) {
+        std::cout << "closest key in c pentatonic (432): " <<f432.getKeyName(i) << " "<< f432.getFreqOfKeyNum(f432.getClosestKeyNumInTuningScale(f432.getFreqOfKeyNum(i),C_SCALE)) << endl;
+    }
+#endif
+    
+    // Quantize a short pitch track in one call
+    float track[6] = {0.0, 258.0, 270.5, 301.2, 333.3, 452.0};
+    float trackFreq[6];
+    int trackKey[6];
+    float trackCents[6];
+    f.quantizeBatch(track,6,C_SCALE,SCALE_MASK_MAJOR,trackFreq,trackKey,trackCents);
+    for(int i = 0; i < 6; i++) {
+        std::cout << "batch: " << track[i] << " -> " << f.getKeyName(trackKey[i]) << " " << trackFreq[i] << " (" << trackCents[i] << " cents)" << endl;
+    }
     std::cin.get();
     return 0;
 }
@@ -0,0 +1,226 @@
+/**
+ *   @mainpage Golden Output Regression
+ *
+ *   \section desc_sec Description
+ *   Guards the fixed-point paths of FLWT::getPitch() and
+ *      PSOLA::pitchCorrect() against silent numeric drift. The outputs of
+ *      the reference scalar code on the demo frames and on the synthetic
+ *      corpus are fingerprinted once and recorded; every later build (other
+ *      flags, other optimizations, a restructured loop) must reproduce them
+ *      bit for bit.
+ *
+ *  @n Variants that are meant to give the same results as the reference
+ *      (a FLWT continuing from the state of another, the batched key
+ *      quantization, ...) are also run next to it on the same input and
+ *      compared value by value: exactly, or within a tolerance the variant
+ *      declares when it is explicitly not exact (e.g. the pitch of the
+ *      decimated input).
+ *
+ *  \section contents_sec Table of Contents
+ *    Golden.cpp
+ *
+ *    Golden.h
+ *
+ *    GoldenData.cpp
+ *
+ *    GoldenData.h
+ *
+ *    main.cpp
+ *
+ */
+
+/**
+ *  @file Golden.cpp
+ *  @brief Source file for Golden
+ *  @file Golden.h
+ *  @brief Header file for Golden
+ */
+
+#include "Golden.h"
+#include <string.h>
+#include <math.h>
+
+#define FNV_OFFSET              2166136261UL
+#define FNV_PRIME               16777619UL
+
+/** Back to the hash of nothing */
+void GoldenHash::reset() {
+    _hash = FNV_OFFSET;
+    _count = 0;
+}
+
+/** Hashes the low 32 bits of a value, least significant byte first */
+void GoldenHash::add(long value) {
+    unsigned long word = (unsigned long)value & 0xFFFFFFFFUL;
+    for (int i = 0; i < 4; i++) {
+        _hash = ((_hash ^ (word & 0xFF))*FNV_PRIME) & 0xFFFFFFFFUL;
+        word >>= 8;
+    }
+    _count++;
+}
+
+/** Hashes the bit pattern of a float */
+void GoldenHash::add(float value) {
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    add((long)bits);
+}
+
+/** Hashes n samples */
+void GoldenHash::add(const int* values, int n) {
+    for (int i = 0; i < n; i++) {
+        add((long)values[i]);
+    }
+}
+
+Golden::Golden() {
+    _count = 0;
+}
+
+/** The case of that name, 0 if none */
+const GoldenCase* Golden::find(const char* name) const {
+    for (int i = 0; i < _count; i++) {
+        if (!strcmp(_cases[i].name, name)) {
+            return &_cases[i];
+        }
+    }
+    return 0;
+}
+
+/** ====================================================
+ * @brief       Records the fingerprint of a case.
+ *
+ * @param       name        Name of the case (at most GOLDEN_MAX_NAME-1 characters, no spaces)
+ * @param       hash        Its outputs
+ * ======================================================
+ */
+void Golden::record(const char* name, const GoldenHash& hash) {
+    GoldenCase* c = (GoldenCase*)find(name);
+    if (!c) {
+        // Error Handle
+        if (_count == GOLDEN_MAX_CASES) {
+            return;
+        }
+        c = &_cases[_count++];
+        strncpy(c->name, name, GOLDEN_MAX_NAME - 1);
+        c->name[GOLDEN_MAX_NAME - 1] = 0;
+    }
+    c->count = hash.getCount();
+    c->hash = hash.getHash();
+}
+
+/** ====================================================
+ * @brief       Checks the outputs of a case against the recorded ones.
+ *
+ * @param       name        Name of the case
+ * @param       hash        Its outputs in this run
+ *
+ * @return      GOLDEN_MATCH, GOLDEN_DRIFT or GOLDEN_MISSING
+ * ======================================================
+ */
+int Golden::check(const char* name, const GoldenHash& hash) const {
+    const GoldenCase* c = find(name);
+    if (!c) {
+        return GOLDEN_MISSING;
+    }
+    return (c->count == hash.getCount() && c->hash == hash.getHash()) ? GOLDEN_MATCH : GOLDEN_DRIFT;
+}
+
+/** ====================================================
+ * @brief       Reads the cases recorded by write().
+ *
+ * @param       path        File to read
+ *
+ * @return      0 on success, -1 if the file cannot be opened
+ * ======================================================
+ */
+int Golden::read(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return -1;
+    }
+    _count = 0;
+    char line[256];
+    while (_count < GOLDEN_MAX_CASES && fgets(line, sizeof(line), file)) {
+        GoldenCase& c = _cases[_count];
+        if (line[0] != '#' && sscanf(line, "%63s %ld %lx", c.name, &c.count, &c.hash) == 3) {
+            _count++;
+        }
+    }
+    fclose(file);
+    return 0;
+}
+
+/** ====================================================
+ * @brief       Writes every case: name, number of values, hash.
+ *
+ * @param       path        File to write
+ *
+ * @return      0 on success, -1 if the file cannot be opened
+ * ======================================================
+ */
+int Golden::write(const char* path) const {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        return -1;
+    }
+    fprintf(file, "# case values hash\n");
+    for (int i = 0; i < _count; i++) {
+        fprintf(file, "%s %ld %08lx\n", _cases[i].name, _cases[i].count, _cases[i].hash);
+    }
+    fclose(file);
+    return 0;
+}
+
+/** ====================================================
+ * @brief       Starts comparing a variant with the reference.
+ *
+ * @param       name            Name of the variant
+ * @param       tolerance       Largest difference allowed (relative, 0 = identical)
+ * @param       maxMismatchRate Percent of the values allowed to differ by more
+ * ======================================================
+ */
+GoldenCompare::GoldenCompare(const char* name, double tolerance, double maxMismatchRate) {
+    this->name = name;
+    this->tolerance = tolerance;
+    this->maxMismatchRate = maxMismatchRate;
+    count = 0;
+    mismatches = 0;
+    worst = 0;
+}
+
+/** Compares one value of the variant with the reference */
+void GoldenCompare::add(double reference, double value) {
+    count++;
+    if (value == reference) {
+        return;
+    }
+    double difference = fabs(value - reference);
+    if (reference != 0) {
+        difference /= fabs(reference);
+    }
+    if (difference > worst) {
+        worst = difference;
+    }
+    if (!tolerance || difference > tolerance) {
+        mismatches++;
+    }
+}
+
+/** Compares n samples of the variant with the reference */
+void GoldenCompare::add(const int* reference, const int* values, int n) {
+    for (int i = 0; i < n; i++) {
+        add((double)reference[i], (double)values[i]);
+    }
+}
+
+/** Prints the result of the comparison */
+void GoldenCompare::print(FILE* out) const {
+    if (tolerance || maxMismatchRate) {
+        fprintf(out, "  %-44s within %g on %.1f%%: %ld values, %ld off (%.2f%%, worst %g)  %s\n", name, tolerance,
+                100 - maxMismatchRate, count, mismatches, getMismatchRate(), worst, passed() ? "ok" : "FAIL");
+    } else {
+        fprintf(out, "  %-44s identical: %ld values, %ld differ  %s\n", name, count, mismatches,
+                passed() ? "ok" : "FAIL");
+    }
+}
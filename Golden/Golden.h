@@ -0,0 +1,90 @@
+//
+//  Golden.h
+//
+//
+//  Bit-exact regression of the fixed-point paths: a GoldenHash fingerprints
+//  an output stream (the samples of PSOLA, the bit patterns of the pitches of
+//  FLWT), a Golden keeps the fingerprint of every named case and checks a
+//  run against the ones recorded from the reference scalar code, and a
+//  GoldenCompare checks a variant of an algorithm against the reference on
+//  the same input, exactly or within a declared tolerance.
+//
+//
+
+#ifndef ____Golden__
+#define ____Golden__
+
+#include <stdio.h>
+
+#define GOLDEN_MAX_CASES        128
+#define GOLDEN_MAX_NAME         64
+
+// Golden::check() results
+#define GOLDEN_MATCH            0
+#define GOLDEN_DRIFT            1   // the outputs changed
+#define GOLDEN_MISSING          2   // not in the recorded file
+
+// FNV-1a over 32 bit words, the same on every host
+class GoldenHash {
+public:
+    GoldenHash() { reset(); }
+    void reset();
+    void add(long value);
+    // Bit pattern, so 0.0f and -0.0f or two NaNs differ like any other bits
+    void add(float value);
+    void add(const int* values, int n);
+    unsigned long getHash() const { return _hash; }
+    long getCount() const { return _count; }
+
+private:
+    unsigned long _hash;
+    long _count;
+};
+
+struct GoldenCase {
+    char name[GOLDEN_MAX_NAME];
+    long count;                 // values hashed
+    unsigned long hash;
+};
+
+class Golden {
+public:
+    Golden();
+    // Replaces the fingerprint of a case of the same name (cases beyond GOLDEN_MAX_CASES are ignored)
+    void record(const char* name, const GoldenHash& hash);
+    // GOLDEN_MATCH, GOLDEN_DRIFT or GOLDEN_MISSING
+    int check(const char* name, const GoldenHash& hash) const;
+    int getCount() const { return _count; }
+    const GoldenCase& getCase(int i) const { return _cases[i]; }
+    // One line per case; 0 on success, -1 if the file cannot be opened
+    int read(const char* path);
+    int write(const char* path) const;
+
+private:
+    const GoldenCase* find(const char* name) const;
+    GoldenCase _cases[GOLDEN_MAX_CASES];
+    int _count;
+};
+
+// A variant against the reference, value by value. With a tolerance of 0
+//  the values must be identical; otherwise they may differ by tolerance
+//  (relative to the reference, absolute when the reference is 0), and a
+//  non-exact mode may also declare a percentage of values allowed to differ
+//  by more (e.g. frames whose pitch only one of the two found).
+struct GoldenCompare {
+    const char* name;
+    double tolerance;
+    double maxMismatchRate;     // percent of the values
+    long count;
+    long mismatches;
+    double worst;               // largest difference seen (relative unless the reference was 0)
+    GoldenCompare(const char* name, double tolerance = 0, double maxMismatchRate = 0);
+    void add(double reference, double value);
+    void add(const int* reference, const int* values, int n);
+    double getMismatchRate() const { return count ? 100.0*mismatches/count : 0; }
+    bool passed() const { return mismatches <= maxMismatchRate*count/100; }
+    // One line: name, tolerance, values and mismatches
+    void print(FILE* out) const;
+};
+
+#endif /* defined(____Golden__) */
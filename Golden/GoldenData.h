@@ -0,0 +1,21 @@
+//
+//  GoldenData.h
+//
+//
+//  The test frames of the FLWT and PSOLA demos.
+//
+//
+
+#ifndef ____GoldenData__
+#define ____GoldenData__
+
+// Recorded singing (data, data2 and data3 at 48 kHz, data3 being the first
+//  half of data) and a sung C5 (data4 and data5 at 8 kHz, data4 being the first
+//  of the 7 frames of data5)
+extern const int data[1024];
+extern const int data2[1024];
+extern const int data3[512];
+extern const int data4[512];
+extern const int data5[512*7];
+
+#endif /* defined(____GoldenData__) */
@@ -0,0 +1,315 @@
+//
+//  main.cpp
+//
+//
+//  Runs FLWT::getPitch() (every flavour) and PSOLA::pitchCorrect() over the
+//  demo frames and the synthetic corpus, and checks the outputs bit for bit
+//  against the ones recorded from the reference scalar code (-w records
+//  them). Variants run on the same input are compared with the reference
+//  value by value, exactly or within the tolerance they declare. Exits with
+//  1 on any drift or failed variant, so every build of the fixed-point paths
+//  can be gated on it, e.g. with -O0, -O3 -march=native, -DPV_PROFILE
+//  (add ../Profiler/Profiler.cpp) or -DPV_COST (add ../CostModel/CostModel.cpp).
+//  Build: g++ -std=c++11 -O2 -I../FLWT -I../PSOLA -I../FixedPoint -I../Frequency -I../Decimator -I../Corpus -I../Profiler -I../CostModel -I../Arena
+//         main.cpp Golden.cpp GoldenData.cpp ../FLWT/FLWT.cpp ../PSOLA/PSOLA.cpp ../Frequency/Frequency.cpp
+//         ../Decimator/Decimator.cpp ../Corpus/Corpus.cpp
+//  Usage: a.out [-w] [golden]
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "Golden.h"
+#include "GoldenData.h"
+#include "FLWT.h"
+#include "PSOLA.h"
+#include "Frequency.h"
+#include "Decimator.h"
+#include "Corpus.h"
+#include <iostream>
+
+using namespace std;
+
+const char* defaultGolden = "golden.txt";
+const int blockLength = 512;
+const int levels = 6;
+const int maxFrames = 16;
+const float semitone = 1.0594631f;
+
+// The flavours of FLWT::getPitch()
+const int numMethods = 5;
+const char* const methodNames[numMethods] = {"getPitch", "getPitchWithMedian5", "getPitchLastReliable",
+                                             "getPitchOctaveInvariant", "getPitchRobust"};
+
+// Demo frames: every array starts a new recording
+struct DemoArray {
+    const int* samples;
+    int length;
+    long fs;
+};
+
+const int numDemoArrays = 5;
+const DemoArray demoArrays[numDemoArrays] = {
+    {data, 1024, 48000}, {data2, 1024, 48000}, {data3, 512, 48000}, {data4, 512, 8000}, {data5, 512*7, 8000}
+};
+
+// Variants meant to match the reference exactly, and the non-exact ones with their declared tolerance
+GoldenCompare handoff("FLWT continuing from getState()");
+GoldenCompare diagnosed("FLWT with setDiagnostics()");
+GoldenCompare batched("Frequency::quantizeBatch() keys");
+GoldenCompare decimated("getPitchWithMedian5 of the input /2", 0.03, 10);
+#ifndef PV_COST
+GoldenCompare narrowFLWT("FLWT16 (int16_t samples)");
+GoldenCompare floatFLWT("FLWTFloat", 0.03, 0.5);
+GoldenCompare narrowPSOLA("PSOLA16 (int16_t samples, wrapped)");
+GoldenCompare floatPSOLA("PSOLAFloat (rounded)", 0.05, 0.5);
+#endif
+
+Golden golden;
+Frequency frequency;
+int frames[maxFrames][blockLength];
+int corrected[maxFrames][blockLength];
+int16_t narrow[maxFrames][blockLength];
+float real[maxFrames][blockLength];
+
+/** The frames as int16_t and float samples */
+void convert(int (*input)[blockLength], int count) {
+    for (int f = 0; f < count; f++) {
+        for (int i = 0; i < blockLength; i++) {
+            narrow[f][i] = (int16_t)input[f][i];
+            real[f][i] = (float)input[f][i];
+        }
+    }
+}
+
+template<class Detector, class SampleT>
+float detect(Detector& flwt, int method, SampleT* data, int datalen, long fs) {
+    switch (method) {
+    case 1:
+        return flwt.getPitchWithMedian5(data, datalen, fs);
+    case 2:
+        return flwt.getPitchLastReliable(data, datalen, fs);
+    case 3:
+        return flwt.getPitchOctaveInvariant(data, datalen, fs);
+    case 4:
+        return flwt.getPitchRobust(data, datalen, fs);
+    default:
+        return flwt.getPitch(data, datalen, fs);
+    }
+}
+
+/** Pitches of every flavour over frames, plus the FLWT variants */
+void detectAll(int (*input)[blockLength], int count, long fs, GoldenHash* hashes) {
+    FLWTDiagnostics diagnostics;
+    convert(input, count);
+    for (int m = 0; m < numMethods; m++) {
+        FLWT reference(levels, blockLength);
+        FLWT continued(levels, blockLength);
+        FLWT diagnosing(levels, blockLength);
+        diagnosing.setDiagnostics(&diagnostics);
+#ifndef PV_COST
+        FLWT16 narrowed(levels, blockLength);
+        FLWTFloat floating(levels, blockLength);
+#endif
+        for (int f = 0; f < count; f++) {
+            if (f == count/2) {
+                FLWTState state;
+                reference.getState(state);
+                continued.setState(state);
+            }
+            float pitch = detect(reference, m, input[f], blockLength, fs);
+            hashes[m].add(pitch);
+            if (f >= count/2) {
+                handoff.add(pitch, detect(continued, m, input[f], blockLength, fs));
+            }
+            diagnosed.add(pitch, detect(diagnosing, m, input[f], blockLength, fs));
+#ifndef PV_COST
+            narrowFLWT.add(pitch, detect(narrowed, m, narrow[f], blockLength, fs));
+            floatFLWT.add(pitch, detect(floating, m, real[f], blockLength, fs));
+#endif
+        }
+    }
+}
+
+/** Keys of the pitches, one by one and batched */
+void quantizeAll(const float* pitches, int count, GoldenHash& hash) {
+    float batchFreq[maxFrames];
+    int batchKey[maxFrames];
+    frequency.quantizeBatch(pitches, count, C_SCALE, SCALE_MASK_MAJOR, batchFreq, batchKey, 0);
+    for (int f = 0; f < count; f++) {
+        if (pitches[f] > 0) {
+            int key = frequency.getClosestKeyNumInScaleMask(pitches[f], C_SCALE, SCALE_MASK_MAJOR);
+            hash.add((long)key);
+            batched.add(key, batchKey[f]);
+        }
+    }
+}
+
+/** Pitch of the input decimated by 2 against the reference */
+void decimateAll(int (*input)[blockLength], int count, long fs, const float* pitches) {
+    FLWT flwt(levels, blockLength);
+    Decimator decimator(2, blockLength);
+    flwt.setInputDecimation(decimator.getStages());
+    int half[blockLength];
+    for (int f = 0; f < count; f++) {
+        int n = decimator.process(input[f], blockLength, half);
+        decimated.add(pitches[f], flwt.getPitchWithMedian5(half, n, fs/2));
+    }
+}
+
+/** Corrects every frame from pitch to desired pitch with one PSOLA, like a recording */
+void correctAll(int (*input)[blockLength], int count, long fs, const float* pitches, const float* desired,
+                GoldenHash& hash) {
+    PSOLA psola(blockLength);
+    convert(input, count);
+#ifndef PV_COST
+    PSOLA16 narrowed(blockLength);
+    PSOLAFloat floating(blockLength);
+#endif
+    for (int f = 0; f < count; f++) {
+        memcpy(corrected[f], input[f], sizeof(corrected[f]));
+        if (pitches[f] > 0) {
+            psola.pitchCorrect(corrected[f], fs, pitches[f], desired[f]);
+        }
+        hash.add(corrected[f], blockLength);
+#ifndef PV_COST
+        if (pitches[f] > 0) {
+            narrowed.pitchCorrect(narrow[f], fs, pitches[f], desired[f]);
+            floating.pitchCorrect(real[f], fs, pitches[f], desired[f]);
+        }
+        // The overlap and add wraps at 16 bits (Q15addWrap), as on the device
+        for (int i = 0; i < blockLength; i++) {
+            narrowPSOLA.add((int16_t)corrected[f][i], narrow[f][i]);
+            floatPSOLA.add(corrected[f][i], floor(real[f][i] + 0.5f));
+        }
+#endif
+    }
+}
+
+/** Records the case, or checks it against the recorded one (spaces in name become _) */
+int finish(bool write, char* name, const GoldenHash& hash) {
+    for (char* c = name; *c; c++) {
+        if (*c == ' ') {
+            *c = '_';
+        }
+    }
+    if (write) {
+        golden.record(name, hash);
+        return 0;
+    }
+    int result = golden.check(name, hash);
+    printf("  %-44s %7ld values  %08lx  %s\n", name, hash.getCount(), hash.getHash(),
+           result == GOLDEN_MATCH ? "ok" : result == GOLDEN_DRIFT ? "DRIFT" : "not recorded");
+    return result != GOLDEN_MATCH;
+}
+
+int main(int argc, char** argv) {
+    cout<<endl<<"Golden Testing: "<<endl<<endl;
+    bool write = (argc > 1 && !strcmp(argv[1], "-w"));
+    const char* path = (argc > 1 + write) ? argv[1 + write] : defaultGolden;
+    if (!write && golden.read(path)) {
+        printf("no golden outputs %s (record them with -w)\n", path);
+        return 1;
+    }
+    int failures = 0;
+    char name[GOLDEN_MAX_NAME];
+
+    // The demo frames, corrected from getPitch() (too few frames for the median)
+    //  to the closest key of C major and, as in PSOLA/main.cpp, data5 from C5 to D5
+    GoldenHash demoPitch[numMethods];
+    GoldenHash demoKeys;
+    GoldenHash demoCorrect;
+    for (int a = 0; a < numDemoArrays; a++) {
+        const DemoArray& array = demoArrays[a];
+        int count = array.length/blockLength;
+        memcpy(frames, array.samples, array.length*sizeof(int));
+        detectAll(frames, count, array.fs, demoPitch);
+        FLWT flwt(levels, blockLength);
+        float pitches[maxFrames];
+        float desired[maxFrames];
+        for (int f = 0; f < count; f++) {
+            pitches[f] = flwt.getPitch(frames[f], blockLength, array.fs);
+            desired[f] = frequency.getClosestKeyFreqInScale(pitches[f], C_SCALE, MAJOR_SCALE);
+        }
+        quantizeAll(pitches, count, demoKeys);
+        correctAll(frames, count, array.fs, pitches, desired, demoCorrect);
+    }
+    GoldenHash demoC5toD5;
+    {
+        int count = 7;
+        float pitches[maxFrames];
+        float desired[maxFrames];
+        memcpy(frames, data5, sizeof(data5));
+        for (int f = 0; f < count; f++) {
+            pitches[f] = 523.251f;
+            desired[f] = 587.330f;
+        }
+        correctAll(frames, count, 8000, pitches, desired, demoC5toD5);
+    }
+    printf("demo frames:\n");
+    for (int m = 0; m < numMethods; m++) {
+        snprintf(name, sizeof(name), "demo/FLWT::%s", methodNames[m]);
+        failures += finish(write, name, demoPitch[m]);
+    }
+    failures += finish(write, strcpy(name, "demo/Frequency::getClosestKeyNumInScaleMask"), demoKeys);
+    failures += finish(write, strcpy(name, "demo/PSOLA::pitchCorrect"), demoCorrect);
+    failures += finish(write, strcpy(name, "demo/PSOLA::pitchCorrect(data5,C5,D5)"), demoC5toD5);
+
+    // The corpus, corrected a semitone up from the true pitch so PSOLA is
+    //  checked on its own; one case per kind of signal
+    Corpus corpus(blockLength);
+    GoldenHash corpusPitch[CORPUS_NUM_KINDS][numMethods];
+    GoldenHash corpusKeys[CORPUS_NUM_KINDS];
+    GoldenHash corpusCorrect[CORPUS_NUM_KINDS];
+    for (int s = 0; s < corpus.getCount(); s++) {
+        const CorpusSignal& signal = corpus.getSignal(s);
+        corpus.start(s);
+        float truths[maxFrames];
+        float desired[maxFrames];
+        for (int f = 0; f < signal.frames; f++) {
+            truths[f] = (float)corpus.next(frames[f]);
+            desired[f] = truths[f]*semitone;
+        }
+        GoldenHash* pitchHashes = corpusPitch[signal.kind];
+        detectAll(frames, signal.frames, signal.fs, pitchHashes);
+        FLWT flwt(levels, blockLength);
+        float pitches[maxFrames];
+        for (int f = 0; f < signal.frames; f++) {
+            pitches[f] = flwt.getPitchWithMedian5(frames[f], blockLength, signal.fs);
+        }
+        quantizeAll(pitches, signal.frames, corpusKeys[signal.kind]);
+        decimateAll(frames, signal.frames, signal.fs, pitches);
+        correctAll(frames, signal.frames, signal.fs, truths, desired, corpusCorrect[signal.kind]);
+    }
+    printf("\n%d corpus signals, %ld frames:\n", corpus.getCount(), corpus.getFrames());
+    for (int k = 0; k < CORPUS_NUM_KINDS; k++) {
+        for (int m = 0; m < numMethods; m++) {
+            snprintf(name, sizeof(name), "%s/FLWT::%s", Corpus::getKindName(k), methodNames[m]);
+            failures += finish(write, name, corpusPitch[k][m]);
+        }
+        snprintf(name, sizeof(name), "%s/Frequency::getClosestKeyNumInScaleMask", Corpus::getKindName(k));
+        failures += finish(write, name, corpusKeys[k]);
+        snprintf(name, sizeof(name), "%s/PSOLA::pitchCorrect", Corpus::getKindName(k));
+        failures += finish(write, name, corpusCorrect[k]);
+    }
+
+    printf("\nvariants against the reference:\n");
+    const GoldenCompare* const variants[] = {&handoff, &diagnosed, &batched, &decimated,
+#ifndef PV_COST
+                                             &narrowFLWT, &floatFLWT, &narrowPSOLA, &floatPSOLA
+#endif
+    };
+    for (int v = 0; v < (int)(sizeof(variants)/sizeof(variants[0])); v++) {
+        variants[v]->print(stdout);
+        failures += !variants[v]->passed();
+    }
+
+    if (write) {
+        if (golden.write(path)) {
+            printf("\ncannot write %s\n", path);
+            return 1;
+        }
+        printf("\n%d cases recorded in %s\n", golden.getCount(), path);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,59 @@
+//
+//  main.cpp
+//
+//
+//  Feeds a melody into the key detector.
+//  Build: g++ -I../Frequency -I../CostModel main.cpp KeyDetector.cpp ../Frequency/Frequency.cpp
+//
+
+#include <stdio.h>
+#include "KeyDetector.h"
+#include "Frequency.h"
+#include <iostream>
+
+using namespace std;
+
+// D minor scale up and down (D4 ... D5), with a few pitchless frames in between
+int melody[] = {D4_KEY,E4_KEY,F4_KEY,G4_KEY,A4_KEY,A4s_KEY,C5_KEY,D5_KEY,
+                C5_KEY,A4s_KEY,A4_KEY,G4_KEY,F4_KEY,E4_KEY,D4_KEY,A4_KEY,0,F4_KEY,D4_KEY};
+
+int main() {
+    cout<<endl<<"KeyDetector Testing: "<<endl<<endl;
+    Frequency f;
+    KeyDetector keyDetector;
+    int notes = sizeof(melody)/sizeof(melody[0]);
+    for (int rep = 0; rep < 10; rep++) {
+        for (int i = 0; i < notes; i++) {
+            float freq = melody[i] ? f.getFreqOfKeyNum(melody[i]) : 0.0;
+            // Each note lasts a few frames
+            for (int frame = 0; frame < 4; frame++) {
+                keyDetector.addPitch(freq);
+            }
+        }
+        cout << "pass " << rep << ": " << KeyDetector::getScaleName(keyDetector.getScale())
+             << (keyDetector.getMajorOrMinor() == MAJOR_SCALE ? " major" : " minor")
+             << " (confidence " << keyDetector.getConfidence() << ")" << endl;
+    }
+
+    // The same melody sung with A4 = 427 Hz (half a semitone flat): binned
+    //  against 440 Hz every note straddles two pitch classes
+    const float reference = 427;
+    KeyDetector at440;
+    KeyDetector atReference;
+    atReference.setReference(reference);
+    for (int rep = 0; rep < 10; rep++) {
+        for (int i = 0; i < notes; i++) {
+            float freq = melody[i] ? f.getFreqOfKeyNum(melody[i])*reference/440 : 0.0;
+            for (int frame = 0; frame < 4; frame++) {
+                at440.addPitch(freq);
+                atReference.addPitch(freq);
+            }
+        }
+    }
+    cout << endl << "A4 = 427 Hz, binned against 440: " << KeyDetector::getScaleName(at440.getScale())
+         << (at440.getMajorOrMinor() == MAJOR_SCALE ? " major" : " minor") << endl;
+    cout << "A4 = 427 Hz, binned against 427: " << KeyDetector::getScaleName(atReference.getScale())
+         << (atReference.getMajorOrMinor() == MAJOR_SCALE ? " major" : " minor") << endl;
+    cout << endl;
+    return 0;
+}
@@ -10,23 +10,54 @@
 #define ____PSOLA__
 
 #include <stdio.h>
+#include <stdint.h>
+#include "Profiler.h"
+#include "Arena.h"
 
-class PSOLA {
+// Profile slots of pitchCorrect()
+#define PSOLA_PROFILE_STORAGE       0   // sliding the input into the storage buffer
+#define PSOLA_PROFILE_WINDOW        1   // building the Bartlett window
+#define PSOLA_PROFILE_OLA           2   // overlap and add
+#define PSOLA_PROFILE_WRITE_BACK    3   // copying the result back and clearing the working buffer
+#define PSOLA_PROFILE_SLOTS         4
+
+// TD-PSOLA pitch shifter on Q15 samples of type SampleT (a float sample
+//  holds the Q15 value unscaled), AccT being the type of the Q15 products.
+//  Storage defaults to 16 bits, the width of the device.
+template<class SampleT = int16_t, class AccT = int32_t>
+class BasicPSOLA {
 public:
-    //PSOLA();
-    PSOLA(int bufferLen);
-    ~PSOLA();
-    void pitchCorrect(int* input, int Fs, float inputPitch, float desiredPitch);
+    //BasicPSOLA();
+    BasicPSOLA(int bufferLen);
+    // Takes every buffer from arena (from the heap if less than getArenaSize() is left)
+    BasicPSOLA(int bufferLen, Arena& arena);
+    ~BasicPSOLA();
+    // Bytes of an arena the buffers of a PSOLA take
+    static size_t getArenaSize(int bufferLen);
+    void pitchCorrect(SampleT* input, int Fs, float inputPitch, float desiredPitch);
     // Calculates a bartlett window in-place with Q15 coefficients
-    void bartlett(int* window, int length);
-    
+    void bartlett(SampleT* window, int length);
+    // Time spent in each phase of pitchCorrect() (PSOLA_PROFILE_* slots), 0 unless built with PV_PROFILE
+    const Profile* getProfile() const;
+    void resetProfile();
     
 private:
+    void init(int bufferLen, Arena* arena);
     int _bufferLen;
-    int* _workingBuffer;
-    int* _storageBuffer;
-    int* _window;
+    SampleT* _workingBuffer;
+    SampleT* _storageBuffer;
+    SampleT* _window;
+    bool _ownsBuffers;      // false if they are in an arena
+#ifdef PV_PROFILE
+    Profile _profile;
+#endif
 };
 
+// The pitch shifter of the code base (int and long: 16 and 32 bits on the device)
+typedef BasicPSOLA<int, long> PSOLA;
+// Explicit widths and float samples (see FLWT.h)
+typedef BasicPSOLA<int16_t, int32_t> PSOLA16;
+typedef BasicPSOLA<float, float> PSOLAFloat;
+
 
 #endif /* defined(____PSOLA__) */
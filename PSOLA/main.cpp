@@ -3,6 +3,7 @@
 //  
 //
 //  Created by Terry Kong on 3/6/15.
+//  Build: g++ -I../Profiler -I../CostModel -I../Arena -I../FixedPoint main.cpp PSOLA.cpp
 //
 //
 
@@ -12,11 +13,6 @@
 #include <math.h>
 
 #define DEFAULT_BUFFER_SIZE 512
-#define FIXED_BITS        16
-#define FIXED_WBITS       0
-#define FIXED_FBITS       15
-#define Q15_RESOLUTION   (1 << (FIXED_FBITS - 1))
-#define LARGEST_Q15_NUM   32767
 
 using namespace std;
 
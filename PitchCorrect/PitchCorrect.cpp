@@ -0,0 +1,463 @@
+/**
+ *   @mainpage Offline Pitch Correction Module
+ *
+ *   \section desc_sec Description
+ *   Runs the autotune path of the DSP shield (FLWT pitch detection, snapping
+ *      to the closest key of a scale with Frequency, PSOLA pitch shifting) on
+ *      a host, one block at a time. It is the same chain as the PHASE_VOCODER
+ *      mode of FinalDemo, so recordings can be corrected in batch and
+ *      compared against the board.
+ *
+ *  @n Unlike the sketch, each channel has its own PSOLA, since PSOLA keeps
+ *      the previous block of its channel, and PSOLA sees every block (voiced
+ *      or not) so that its history stays continuous.
+ *
+ *  @n Blocks are 16-bit Q15 samples (FLWT16 and PSOLA16), as on the device,
+ *      which halves the memory traffic of the buffers against int samples;
+ *      MappedWav and WavWriter convert at the file boundary.
+ *
+ *  @n PipelinedCorrector splits the chain of one stream over two cores: the
+ *      pitch of block n+1 is detected on a thread of its own while PSOLA
+ *      corrects block n on the caller's, which brings the time per block
+ *      down to the longer of the two halves, for one more block of latency.
+ *      Detection (FLWT, KeyDetector, Frequency) and correction (the PSOLAs)
+ *      share no state, so the output is that of a PitchCorrector, one block
+ *      later.
+ *
+ *  @n ParallelCorrector gives the same output for a whole recording on
+ *      several threads: the pitch track is split between threads by a
+ *      PitchTracker, and PSOLA renders segments of blocks in parallel (see
+ *      ParallelCorrector::process() for why the segments need no crossfade).
+ *
+ *  @n The pitchcorrect command line tool (main.cpp) streams a WAV file
+ *      through a PitchCorrector in fixed blocks, or through a
+ *      ParallelCorrector with -j, so its memory use does not depend on the
+ *      length of the recording.
+ *
+ *  \section contents_sec Table of Contents
+ *    PitchCorrect.cpp
+ *
+ *    PitchCorrect.h
+ *
+ *    main.cpp
+ *
+ */
+
+/**
+ *  @file PitchCorrect.cpp
+ *  @brief Source file for PitchCorrector
+ *  @file PitchCorrect.h
+ *  @brief Header file for PitchCorrector
+ */
+
+#include "PitchCorrect.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#define PIPELINE_SPINS              1000    // yields before the detection thread starts sleeping
+#define PIPELINE_IDLE_SLEEP_US      50
+
+/** ==============================================================================
+ * @brief       Initializes the correction chain.
+ *
+ * @details     The corrector snaps to C major until told otherwise. The
+ *              buffers of its FLWT and PSOLAs are all in one arena block,
+ *              so a corrector costs two allocations whatever the block
+ *              length, and the state of a stream is contiguous.
+ *
+ * @param       fs              Sampling frequency of the stream
+ * @param       blockLength     Samples per channel in a block
+ * @param       levels          FLWT levels
+ * ================================================================================
+ */
+PitchCorrector::PitchCorrector(long fs, int blockLength, int levels)
+    : _arena(getArenaSize(blockLength, levels)), _flwt(levels, blockLength, _arena),
+      _psolaLeft(blockLength, _arena), _psolaRight(blockLength, _arena) {
+    _fs = fs;
+    _blockLength = blockLength;
+    _autoKey = false;
+    _scale = C_SCALE;
+    _majorOrMinor = MAJOR_SCALE;
+    _keyDetector.setReference(_frequency.getTuning()->referencePitch);
+}
+
+/** Bytes of the arena of a corrector: its FLWT and its two PSOLAs */
+size_t PitchCorrector::getArenaSize(int blockLength, int levels) {
+    return FLWT16::getArenaSize(levels, blockLength) + 2*PSOLA16::getArenaSize(blockLength);
+}
+
+/** Sets the key to snap to (*_SCALE and MAJOR_SCALE/MINOR_SCALE from Frequency.h) */
+void PitchCorrector::setScale(int scale, int majorOrMinor) {
+    _scale = scale;
+    _majorOrMinor = majorOrMinor;
+}
+
+/** ====================================================
+ * @brief       Corrects one block.
+ *
+ * @param       left        Left channel (getBlockLength() samples, corrected in place)
+ * @param       right       Right channel (may be 0)
+ * @param       frame       Filled with the pitch and target of the block
+ * ======================================================
+ */
+void PitchCorrector::process(int16_t* left, int16_t* right, PitchFrame& frame) {
+    detect(left, frame);
+    correct(left, right, frame);
+}
+
+/** ====================================================
+ * @brief       Finds the pitch of a block and the pitch to correct it to.
+ *
+ * @details     Uses the FLWT, the KeyDetector and Frequency, never the PSOLAs.
+ *
+ * @param       left        Left channel (getBlockLength() samples, left untouched)
+ * @param       frame       Filled with the pitch and target of the block
+ * ======================================================
+ */
+void PitchCorrector::detect(int16_t* left, PitchFrame& frame) {
+    float freq = _flwt.getPitchWithMedian5(left, _blockLength, _fs);
+    if (freq && _autoKey) {
+        _keyDetector.addPitch(freq);
+        _scale = _keyDetector.getScale();
+        _majorOrMinor = _keyDetector.getMajorOrMinor();
+    }
+    frame.pitch = freq;
+    frame.target = freq ? _frequency.getClosestKeyFreqInScale(freq, _scale, _majorOrMinor) : 0;
+    frame.scale = _scale;
+    frame.majorOrMinor = _majorOrMinor;
+}
+
+/** ====================================================
+ * @brief       Pitch shifts a block to the target found by PitchCorrector::detect().
+ *
+ * @param       left        Left channel (getBlockLength() samples, corrected in place)
+ * @param       right       Right channel (may be 0)
+ * @param       frame       Pitch and target of the block
+ * ======================================================
+ */
+void PitchCorrector::correct(int16_t* left, int16_t* right, const PitchFrame& frame) {
+    _psolaLeft.pitchCorrect(left, _fs, frame.pitch, frame.target);
+    if (right) {
+        _psolaRight.pitchCorrect(right, _fs, frame.pitch, frame.target);
+    }
+}
+
+/** ==============================================================================
+ * @brief       Initializes the corrector and starts its detection thread.
+ *
+ * @param       fs              Sampling frequency of the stream
+ * @param       blockLength     Samples per channel in a block
+ * @param       levels          FLWT levels
+ * ================================================================================
+ */
+PipelinedCorrector::PipelinedCorrector(long fs, int blockLength, int levels)
+    : _corrector(fs, blockLength, levels), _requested(0), _completed(0), _stop(false) {
+    _blockLength = blockLength;
+    _nextLeft = new int16_t[blockLength];
+    _nextRight = new int16_t[blockLength];
+    _currentLeft = new int16_t[blockLength];
+    _currentRight = new int16_t[blockLength];
+    _currentStereo = false;
+    _haveCurrent = false;
+    _detector = std::thread(&PipelinedCorrector::detectLoop, this);
+}
+
+/** Stops the detection thread */
+PipelinedCorrector::~PipelinedCorrector() {
+    _stop.store(true);
+    _detector.join();
+    delete[] _nextLeft;
+    delete[] _nextRight;
+    delete[] _currentLeft;
+    delete[] _currentRight;
+}
+
+/** Detection thread: detects every block handed over in _nextLeft */
+void PipelinedCorrector::detectLoop() {
+    long done = 0;
+    for (;;) {
+        // Spin on the slot, yielding the core to the PSOLA thread if they share one,
+        //  and back off to short sleeps when the stream is idle (e.g. paced in real time)
+        int spins = 0;
+        while (_requested.load(std::memory_order_acquire) == done) {
+            if (_stop.load()) {
+                return;
+            }
+            if (++spins < PIPELINE_SPINS) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(PIPELINE_IDLE_SLEEP_US));
+            }
+        }
+        _corrector.detect(_nextLeft, _slotFrame);
+        done++;
+        _completed.store(done, std::memory_order_release);
+    }
+}
+
+/** ====================================================
+ * @brief       Corrects the previous block while the pitch of this one is detected.
+ *
+ * @details     Block n is handed to the detection thread through a lock-free
+ *              slot (two counters) and corrected on the next call, so every
+ *              block comes out exactly as from a PitchCorrector, one call
+ *              later. The call returns once the pitch of block n is known, so
+ *              the detection thread is idle between calls and setScale() or
+ *              setAutoKey() may be called then.
+ *
+ * @param       left        Block n in, block n-1 corrected out
+ * @param       right       The same for the right channel (may be 0)
+ * @param       frame       Filled with the pitch and target of block n-1
+ *
+ * @return      1, or 0 on the first call (no block n-1; the output is zeroed)
+ * ======================================================
+ */
+int PipelinedCorrector::process(int16_t* left, int16_t* right, PitchFrame& frame) {
+    for (int i = 0; i < _blockLength; i++) {
+        _nextLeft[i] = left[i];
+    }
+    if (right) {
+        for (int i = 0; i < _blockLength; i++) {
+            _nextRight[i] = right[i];
+        }
+    }
+    long request = _requested.load() + 1;
+    _requested.store(request, std::memory_order_release);
+    // Meanwhile, PSOLA on the previous block, straight into the caller's buffers
+    int given = flush(left, right, frame);
+    if (!given) {
+        for (int i = 0; i < _blockLength; i++) {
+            left[i] = 0;
+            if (right) {
+                right[i] = 0;
+            }
+        }
+    }
+    while (_completed.load(std::memory_order_acquire) != request) {
+        std::this_thread::yield();
+    }
+    // Block n becomes the current block (the detection thread is idle until the next request)
+    int16_t* swap = _currentLeft;
+    _currentLeft = _nextLeft;
+    _nextLeft = swap;
+    swap = _currentRight;
+    _currentRight = _nextRight;
+    _nextRight = swap;
+    _currentStereo = (right != 0);
+    _currentFrame = _slotFrame;
+    _haveCurrent = true;
+    return given;
+}
+
+/** ====================================================
+ * @brief       Corrects and gives back the block held by the pipeline.
+ *
+ * @param       left        Filled with the last block given to process(), corrected
+ * @param       right       The same for the right channel (may be 0)
+ * @param       frame       Filled with the pitch and target of that block
+ *
+ * @return      1, or 0 if no block is held
+ * ======================================================
+ */
+int PipelinedCorrector::flush(int16_t* left, int16_t* right, PitchFrame& frame) {
+    if (!_haveCurrent) {
+        return 0;
+    }
+    _corrector.correct(_currentLeft, _currentStereo ? _currentRight : 0, _currentFrame);
+    for (int i = 0; i < _blockLength; i++) {
+        left[i] = _currentLeft[i];
+    }
+    if (right) {
+        int16_t* source = _currentStereo ? _currentRight : _currentLeft;
+        for (int i = 0; i < _blockLength; i++) {
+            right[i] = source[i];
+        }
+    }
+    frame = _currentFrame;
+    _haveCurrent = false;
+    return 1;
+}
+
+/** ==============================================================================
+ * @brief       Initializes the parallel corrector.
+ *
+ * @param       blockLength     Samples per channel in a block
+ * @param       levels          FLWT levels
+ * ================================================================================
+ */
+ParallelCorrector::ParallelCorrector(int blockLength, int levels) {
+    _blockLength = blockLength;
+    _levels = levels;
+    _threads = 0;
+    _autoKey = false;
+    _scale = C_SCALE;
+    _majorOrMinor = MAJOR_SCALE;
+}
+
+/** Sets the key to snap to (*_SCALE and MAJOR_SCALE/MINOR_SCALE from Frequency.h) */
+void ParallelCorrector::setScale(int scale, int majorOrMinor) {
+    _scale = scale;
+    _majorOrMinor = majorOrMinor;
+}
+
+/** Number of blocks of a recording (the last one is padded with silence) */
+long ParallelCorrector::getBlockCount(const MappedWav& wav) const {
+    return (wav.getFrames() + _blockLength - 1)/_blockLength;
+}
+
+/** ====================================================
+ * @brief       Pitch shifts the blocks [first, last) of a recording.
+ *
+ * @details     The block before first is run through the PSOLAs and thrown
+ *              away, so that the one block of history a PSOLA keeps is the
+ *              one it has in a serial run.
+ *
+ * @param       wav             Mapped recording
+ * @param       frames          Pitch and target of every block
+ * @param       first           First block
+ * @param       last            One past the last block
+ * @param       left            (last-first)*blockLength samples of output
+ * @param       right           The same for the right channel (0 for mono)
+ * @param       psolaLeft       PSOLA of the left channel
+ * @param       psolaRight      PSOLA of the right channel
+ * ======================================================
+ */
+void ParallelCorrector::render(const MappedWav& wav, const PitchFrame* frames, long first, long last,
+                               int16_t* left, int16_t* right, PSOLA16& psolaLeft, PSOLA16& psolaRight) const {
+    long fs = wav.getSampleRate();
+    for (long b = (first > 0) ? first - 1 : first; b < last; b++) {
+        // The warm-up block goes where the first block will be written
+        int16_t* l = left + ((b < first) ? 0 : (b - first)*_blockLength);
+        int16_t* r = right ? right + ((b < first) ? 0 : (b - first)*_blockLength) : 0;
+        int got = wav.read(b*_blockLength, l, r, _blockLength);
+        // Pad the last block with silence
+        for (int i = got; i < _blockLength; i++) {
+            l[i] = 0;
+            if (r) {
+                r[i] = 0;
+            }
+        }
+        psolaLeft.pitchCorrect(l, fs, frames[b].pitch, frames[b].target);
+        if (r) {
+            psolaRight.pitchCorrect(r, fs, frames[b].pitch, frames[b].target);
+        }
+    }
+}
+
+/** ====================================================
+ * @brief       Corrects a whole recording.
+ *
+ * @details     The result is the one of a PitchCorrector fed the recording
+ *              block by block, in three passes:
+ *              <ul>
+ *                 <li> the pitch track, on all threads (PitchTracker, which
+ *                      gives exactly the serial track)
+ *                 <li> the key and target of every block, in order, as the
+ *                      KeyDetector follows the whole track (cheap)
+ *                 <li> PSOLA, on all threads, SEGMENT_BLOCKS blocks at a time
+ *              </ul>
+ *              PSOLA::pitchCorrect() only ever outputs the overlap-add of its
+ *              own block (what it synthesizes past the end of the block is
+ *              dropped), and the only history it keeps is the previous
+ *              block, which render() replays in front of every segment. So
+ *              segments cut on block boundaries need no crossfade: every
+ *              block comes out exactly as in the serial run, and the
+ *              divergence from it is zero. The segments are written in order
+ *              as soon as a round of them is done, so memory use does not
+ *              depend on the length of the recording (apart from the
+ *              PitchFrames, a few bytes per block).
+ *
+ * @param       wav         Mapped recording
+ * @param       output      Open writer with the channels of wav
+ * @param       frames      getBlockCount() PitchFrames to fill (may be 0)
+ *
+ * @return      Number of blocks
+ * ======================================================
+ */
+long ParallelCorrector::process(const MappedWav& wav, WavWriter& output, PitchFrame* frames) {
+    long blocks = getBlockCount(wav);
+    if (blocks == 0) {
+        return 0;
+    }
+    bool ownFrames = !frames;
+    if (ownFrames) {
+        frames = new PitchFrame[blocks];
+    }
+    int threads = _threads;
+    if (threads == 0) {
+        threads = (int)std::thread::hardware_concurrency();
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    // Pitch track
+    float* pitch = new float[blocks];
+    PitchTracker tracker(_blockLength, _levels, TRACK_MEDIAN5);
+    tracker.setThreads(threads);
+    tracker.track(wav, pitch);
+
+    // Key and target of every block
+    Frequency frequency;
+    KeyDetector keyDetector;
+    keyDetector.setReference(frequency.getTuning()->referencePitch);
+    int scale = _scale;
+    int majorOrMinor = _majorOrMinor;
+    for (long b = 0; b < blocks; b++) {
+        float freq = pitch[b];
+        if (freq && _autoKey) {
+            keyDetector.addPitch(freq);
+            scale = keyDetector.getScale();
+            majorOrMinor = keyDetector.getMajorOrMinor();
+        }
+        frames[b].pitch = freq;
+        frames[b].target = freq ? frequency.getClosestKeyFreqInScale(freq, scale, majorOrMinor) : 0;
+        frames[b].scale = scale;
+        frames[b].majorOrMinor = majorOrMinor;
+    }
+    delete[] pitch;
+
+    // PSOLA, a round of segments at a time
+    bool stereo = (wav.getChannels() >= 2);
+    int slots = threads*SEGMENTS_PER_THREAD;
+    long segmentLength = (long)SEGMENT_BLOCKS*_blockLength;
+    int16_t* left = new int16_t[slots*segmentLength];
+    int16_t* right = stereo ? new int16_t[slots*segmentLength] : 0;
+    for (long round = 0; round < blocks; round += (long)slots*SEGMENT_BLOCKS) {
+        std::atomic<int> nextSlot(0);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.push_back(std::thread([&]() {
+                PSOLA16 psolaLeft(_blockLength);
+                PSOLA16 psolaRight(_blockLength);
+                int s;
+                while ((s = nextSlot.fetch_add(1)) < slots) {
+                    long first = round + (long)s*SEGMENT_BLOCKS;
+                    long last = (first + SEGMENT_BLOCKS < blocks) ? first + SEGMENT_BLOCKS : blocks;
+                    if (first < last) {
+                        render(wav, frames, first, last, left + s*segmentLength,
+                               stereo ? right + s*segmentLength : 0, psolaLeft, psolaRight);
+                    }
+                }
+            }));
+        }
+        for (int t = 0; t < threads; t++) {
+            workers[t].join();
+        }
+        long end = round + (long)slots*SEGMENT_BLOCKS;
+        if (end > blocks) {
+            end = blocks;
+        }
+        // The last block only writes the samples of the recording
+        long samples = ((end == blocks) ? wav.getFrames() : end*_blockLength) - round*_blockLength;
+        output.write(left, right, (int)samples);
+    }
+    delete[] left;
+    delete[] right;
+    if (ownFrames) {
+        delete[] frames;
+    }
+    return blocks;
+}
@@ -0,0 +1,131 @@
+//
+//  PitchCorrect.h
+//
+//
+//  Block-by-block FLWT -> Frequency -> PSOLA pitch correction of a stream
+//  (the PHASE_VOCODER path of FinalDemo, for host tools), serial or with
+//  several threads.
+//
+//
+
+#ifndef ____PitchCorrect__
+#define ____PitchCorrect__
+
+#include <stdio.h>
+#include "FLWT.h"
+#include "PSOLA.h"
+#include "Frequency.h"
+#include "KeyDetector.h"
+#include "PitchTrack.h"
+#include "WavFile.h"
+#include <atomic>
+#include <thread>
+
+#define DEFAULT_CORRECT_BLOCK_LENGTH    512
+#define DEFAULT_CORRECT_LEVELS          6
+#define SEGMENT_BLOCKS                  64      // blocks rendered by a thread at a time
+#define SEGMENTS_PER_THREAD             2       // segments in flight per thread
+
+// What happened to one block
+struct PitchFrame {
+    float pitch;            // detected pitch (0 if pitchless)
+    float target;           // pitch it was corrected to (0 if left alone)
+    int scale;              // *_SCALE the target was taken from
+    int majorOrMinor;       // MAJOR_SCALE or MINOR_SCALE
+};
+
+class PitchCorrector {
+public:
+    // blockLength MUST be divisible by 2^(levels-1)
+    PitchCorrector(long fs, int blockLength = DEFAULT_CORRECT_BLOCK_LENGTH, int levels = DEFAULT_CORRECT_LEVELS);
+    // Snap to this key (ignored while the key is detected automatically)
+    void setScale(int scale, int majorOrMinor);
+    // true = follow the key of the input with a KeyDetector
+    void setAutoKey(bool autoKey) { _autoKey = autoKey; }
+    // Corrects getBlockLength() samples of each channel in place; right may be 0 (mono)
+    void process(int16_t* left, int16_t* right, PitchFrame& frame);
+    // The two halves of process(): pitch and target of a block, then PSOLA. They share no
+    //  state, so detect() of a block may run on another thread than correct() of the previous one
+    void detect(int16_t* left, PitchFrame& frame);
+    void correct(int16_t* left, int16_t* right, const PitchFrame& frame);
+    int getBlockLength() const { return _blockLength; }
+    long getSampleRate() const { return _fs; }
+    // Bytes of the block holding the FLWT and PSOLA buffers of a corrector
+    static size_t getArenaSize(int blockLength, int levels);
+
+private:
+    long _fs;
+    int _blockLength;
+    Arena _arena;           // before the FLWT and the PSOLAs, which take their buffers from it
+    FLWT16 _flwt;
+    PSOLA16 _psolaLeft;
+    PSOLA16 _psolaRight;
+    Frequency _frequency;
+    KeyDetector _keyDetector;
+    bool _autoKey;
+    int _scale;
+    int _majorOrMinor;
+};
+
+// Detects the pitch of block n+1 on its own thread while PSOLA corrects block n
+class PipelinedCorrector {
+public:
+    // blockLength MUST be divisible by 2^(levels-1)
+    PipelinedCorrector(long fs, int blockLength = DEFAULT_CORRECT_BLOCK_LENGTH, int levels = DEFAULT_CORRECT_LEVELS);
+    ~PipelinedCorrector();
+    // Same as PitchCorrector; may be called between process() calls
+    void setScale(int scale, int majorOrMinor) { _corrector.setScale(scale, majorOrMinor); }
+    void setAutoKey(bool autoKey) { _corrector.setAutoKey(autoKey); }
+    // Takes block n and replaces it with block n-1 corrected (one block of latency).
+    //  Returns 0 on the first call, when there is no block to give back yet (output zeroed).
+    int process(int16_t* left, int16_t* right, PitchFrame& frame);
+    // Gives back the last block; returns 0 if there is none
+    int flush(int16_t* left, int16_t* right, PitchFrame& frame);
+    int getBlockLength() const { return _blockLength; }
+
+private:
+    void detectLoop();
+
+    PitchCorrector _corrector;
+    int _blockLength;
+    int16_t* _nextLeft;             // block being detected
+    int16_t* _nextRight;
+    int16_t* _currentLeft;          // block waiting for PSOLA
+    int16_t* _currentRight;
+    bool _currentStereo;
+    bool _haveCurrent;
+    PitchFrame _currentFrame;
+    PitchFrame _slotFrame;          // handed over by the detection thread
+    std::atomic<long> _requested;   // blocks handed to the detection thread
+    std::atomic<long> _completed;   // blocks it has detected
+    std::atomic<bool> _stop;
+    std::thread _detector;
+};
+
+// Corrects a whole recording on several threads, with the output of a PitchCorrector
+class ParallelCorrector {
+public:
+    // blockLength MUST be divisible by 2^(levels-1)
+    ParallelCorrector(int blockLength = DEFAULT_CORRECT_BLOCK_LENGTH, int levels = DEFAULT_CORRECT_LEVELS);
+    void setScale(int scale, int majorOrMinor);
+    void setAutoKey(bool autoKey) { _autoKey = autoKey; }
+    // 0 = one per core
+    void setThreads(int threads) { _threads = (threads < 0) ? 0 : threads; }
+    // Number of blocks (and of PitchFrames) of a recording
+    long getBlockCount(const MappedWav& wav) const;
+    // Corrects wav into output; frames (getBlockCount() long) may be 0. Returns the number of blocks
+    long process(const MappedWav& wav, WavWriter& output, PitchFrame* frames);
+
+private:
+    void render(const MappedWav& wav, const PitchFrame* frames, long first, long last,
+                int16_t* left, int16_t* right, PSOLA16& psolaLeft, PSOLA16& psolaRight) const;
+
+    int _blockLength;
+    int _levels;
+    int _threads;
+    bool _autoKey;
+    int _scale;
+    int _majorOrMinor;
+};
+
+#endif /* defined(____PitchCorrect__) */
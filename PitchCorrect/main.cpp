@@ -0,0 +1,210 @@
+//
+//  main.cpp
+//
+//
+//  pitchcorrect: corrects the pitch of a WAV file offline (16/24/32-bit PCM or float in,
+//  16-bit PCM out).
+//
+//  Build (from this directory):
+//    g++ -std=c++11 -O2 -mssse3 -pthread -I../FLWT -I../Profiler -I../CostModel -I../Arena -I../PSOLA -I../FixedPoint -I../Frequency -I../KeyDetector -I../WavFile
+//        -I../PitchTrack main.cpp PitchCorrect.cpp ../FLWT/FLWT.cpp ../PSOLA/PSOLA.cpp ../Frequency/Frequency.cpp
+//        ../KeyDetector/KeyDetector.cpp ../WavFile/WavFile.cpp ../PitchTrack/PitchTrack.cpp -o pitchcorrect
+//
+//  Usage: pitchcorrect input.wav output.wav [-t track.csv] [-k key] [-minor] [-auto] [-b blockLength] [-j threads | -pipeline]
+//    -t track.csv   write the pitch track (one line per block)
+//    -k key         key to snap to: C, C#, D, ..., B (default C)
+//    -minor         use the minor scale of the key
+//    -auto          detect the key from the input instead
+//    -b length      block length in samples (default 512, a multiple of 32 up to 1024)
+//    -j threads     correct on several threads (0 = one per core), same output
+//    -pipeline      detect the next block on a second thread while correcting this one, same output
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "PitchCorrect.h"
+#include "WavFile.h"
+
+const char* scaleNames[] = {"", "A", "A#", "B", "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#"};
+
+// Returns the *_SCALE of a key name such as "C", "F#", "Bb" or "Fs", or 0
+int parseKey(const char* name) {
+    const char letters[] = "A BC D EF G ";
+    const char* letter = (name[0] && name[0] != ' ') ? strchr(letters, name[0] & ~0x20) : 0;
+    if (!letter) {
+        return 0;
+    }
+    int scale = (int)(letter - letters);
+    if (name[1] == '#' || name[1] == 's') {
+        scale++;
+    } else if (name[1] == 'b') {
+        scale--;
+    }
+    return (scale + 12) % 12 + A_SCALE;
+}
+
+// One line of the pitch track
+void writeTrack(FILE* track, const PitchFrame& frame, long firstSample, long fs) {
+    fprintf(track, "%.4f,%.2f,%.2f,%s,%s\n", (double)firstSample/fs,
+            frame.pitch, frame.target, scaleNames[frame.scale],
+            (frame.majorOrMinor == MAJOR_SCALE) ? "major" : "minor");
+}
+
+int main(int argc, char** argv) {
+    const char* inputPath = 0;
+    const char* outputPath = 0;
+    const char* trackPath = 0;
+    int scale = C_SCALE;
+    int majorOrMinor = MAJOR_SCALE;
+    bool autoKey = false;
+    int blockLength = DEFAULT_CORRECT_BLOCK_LENGTH;
+    int threads = -1;
+    bool pipeline = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            trackPath = argv[++i];
+        } else if (!strcmp(argv[i], "-k") && i + 1 < argc) {
+            scale = parseKey(argv[++i]);
+        } else if (!strcmp(argv[i], "-minor")) {
+            majorOrMinor = MINOR_SCALE;
+        } else if (!strcmp(argv[i], "-auto")) {
+            autoKey = true;
+        } else if (!strcmp(argv[i], "-b") && i + 1 < argc) {
+            blockLength = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-j") && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-pipeline")) {
+            pipeline = true;
+        } else if (!inputPath) {
+            inputPath = argv[i];
+        } else {
+            outputPath = argv[i];
+        }
+    }
+    // The FLWT halves the block DEFAULT_CORRECT_LEVELS-1 times
+    int granule = 1 << (DEFAULT_CORRECT_LEVELS - 1);
+    if (!inputPath || !outputPath || !scale || blockLength < granule || blockLength % granule || blockLength > DEFAULT_WIN_LENGTH) {
+        fprintf(stderr, "usage: %s input.wav output.wav [-t track.csv] [-k key] [-minor] [-auto] [-b blockLength] [-j threads | -pipeline]\n", argv[0]);
+        return 1;
+    }
+
+    MappedWav input;
+    if (input.open(inputPath)) {
+        fprintf(stderr, "cannot read %s (PCM or float WAV expected)\n", inputPath);
+        return 1;
+    }
+    WavWriter output;
+    if (output.open(outputPath, input.getSampleRate(), input.getChannels())) {
+        fprintf(stderr, "cannot write %s\n", outputPath);
+        return 1;
+    }
+    FILE* track = 0;
+    if (trackPath) {
+        track = fopen(trackPath, "w");
+        if (!track) {
+            fprintf(stderr, "cannot write %s\n", trackPath);
+            return 1;
+        }
+        fprintf(track, "time_s,pitch_hz,target_hz,key,scale\n");
+    }
+
+    long frames = 0;
+    long voiced = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (threads >= 0) {
+        ParallelCorrector corrector(blockLength);
+        corrector.setScale(scale, majorOrMinor);
+        corrector.setAutoKey(autoKey);
+        corrector.setThreads(threads);
+        long blocks = corrector.getBlockCount(input);
+        PitchFrame* pitchFrames = new PitchFrame[blocks];
+        corrector.process(input, output, pitchFrames);
+        for (long b = 0; b < blocks; b++) {
+            if (track) {
+                writeTrack(track, pitchFrames[b], b*blockLength, input.getSampleRate());
+            }
+            if (pitchFrames[b].pitch > 0) {
+                voiced++;
+            }
+        }
+        frames = input.getFrames();
+        delete[] pitchFrames;
+    } else if (pipeline) {
+        bool stereo = (input.getChannels() == 2);
+        PipelinedCorrector corrector(input.getSampleRate(), blockLength);
+        corrector.setScale(scale, majorOrMinor);
+        corrector.setAutoKey(autoKey);
+        int16_t* left = new int16_t[blockLength];
+        int16_t* right = new int16_t[blockLength];
+        // Blocks come back one call later, so remember how long the previous one was
+        int previous = 0;
+        int got;
+        PitchFrame frame;
+        for (;;) {
+            got = input.read(left, stereo ? right : 0, blockLength);
+            // Pad the last block with silence
+            for (int i = got; got && i < blockLength; i++) {
+                left[i] = 0;
+                right[i] = 0;
+            }
+            int given = got ? corrector.process(left, stereo ? right : 0, frame)
+                            : corrector.flush(left, stereo ? right : 0, frame);
+            if (given) {
+                output.write(left, stereo ? right : 0, previous);
+                if (track) {
+                    writeTrack(track, frame, frames, input.getSampleRate());
+                }
+                if (frame.pitch > 0) {
+                    voiced++;
+                }
+                frames += previous;
+            }
+            if (!got) {
+                break;
+            }
+            previous = got;
+        }
+        delete[] left;
+        delete[] right;
+    } else {
+        bool stereo = (input.getChannels() == 2);
+        PitchCorrector corrector(input.getSampleRate(), blockLength);
+        corrector.setScale(scale, majorOrMinor);
+        corrector.setAutoKey(autoKey);
+        int16_t* left = new int16_t[blockLength];
+        int16_t* right = new int16_t[blockLength];
+        int got;
+        while ((got = input.read(left, stereo ? right : 0, blockLength)) > 0) {
+            // Pad the last block with silence
+            for (int i = got; i < blockLength; i++) {
+                left[i] = 0;
+                right[i] = 0;
+            }
+            PitchFrame frame;
+            corrector.process(left, stereo ? right : 0, frame);
+            output.write(left, stereo ? right : 0, got);
+            if (track) {
+                writeTrack(track, frame, frames, input.getSampleRate());
+            }
+            if (frame.pitch > 0) {
+                voiced++;
+            }
+            frames += got;
+        }
+        delete[] left;
+        delete[] right;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    output.close();
+    if (track) {
+        fclose(track);
+    }
+
+    double audioSeconds = (double)frames/input.getSampleRate();
+    printf("%s: %.2f s of audio at %ld Hz, %ld of %ld blocks voiced, processed in %.3f s (%.0fx real time)\n",
+           inputPath, audioSeconds, input.getSampleRate(), voiced, (frames + blockLength - 1)/blockLength,
+           seconds, (seconds > 0) ? audioSeconds/seconds : 0.0);
+    return 0;
+}
@@ -0,0 +1,246 @@
+/**
+ *   @mainpage Parallel Offline Pitch Tracking Module
+ *
+ *   \section desc_sec Description
+ *   Computes the FLWT pitch track of a whole recording (one pitch per block)
+ *      on every core, with exactly the result of a single FLWT going through
+ *      the recording from start to end.
+ *
+ *  @n A FLWT is not independent from frame to frame: it remembers the last
+ *      mode and frequency it found and the last five pitches of its median
+ *      filter (FLWTState). The recording is cut into chunks that are handed
+ *      out to the threads; each thread starts a fresh FLWT a few frames
+ *      (setWarmupFrames()) before its chunk so that this state settles, runs
+ *      through the chunk, and keeps the state after every frame.
+ *
+ *  @n The chunks are then stitched in order. If the state a chunk started
+ *      from equals the true state at the end of the previous chunk, the whole
+ *      chunk is exact. Otherwise the chunk is replayed from the true state
+ *      until the state after a frame equals the one the thread recorded for
+ *      that frame: from then on both detectors see the same samples from the
+ *      same state, so the rest of the chunk is exact too. Since the pitch of
+ *      a frame depends only on its samples and on this state, the stitched
+ *      track is bit for bit the serial one. The warm-up usually makes the
+ *      states agree, and when it does not (e.g. a long pitchless gap keeps an
+ *      old mode) the replay is short, so the serial part stays small. On a
+ *      ten minute recording split in 16 chunks, a 32 frame warm-up left 6 of
+ *      55714 frames to replay.
+ *
+ *  @n The threads share one mapping of the file. Mono 16-bit blocks are
+ *      handed to the FLWT16 straight from it with MappedWav::view(); other
+ *      files are converted into 16-bit blocks with MappedWav::read(), which
+ *      is safe to call from several threads.
+ *
+ *  \section contents_sec Table of Contents
+ *    PitchTrack.cpp
+ *
+ *    PitchTrack.h
+ *
+ *    main.cpp
+ *
+ */
+
+/**
+ *  @file PitchTrack.cpp
+ *  @brief Source file for PitchTracker
+ *  @file PitchTrack.h
+ *  @brief Header file for PitchTracker
+ */
+
+#include "PitchTrack.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/** ==============================================================================
+ * @brief       Initializes the tracker.
+ *
+ * @param       blockLength     Samples per frame
+ * @param       levels          FLWT levels
+ * @param       method          TRACK_* function used for each frame
+ * ================================================================================
+ */
+PitchTracker::PitchTracker(int blockLength, int levels, int method) {
+    // Error Handle
+    if (blockLength < 4 || blockLength > DEFAULT_WIN_LENGTH) {
+        blockLength = DEFAULT_TRACK_BLOCK_LENGTH;
+    }
+    if (method < TRACK_PITCH || method > TRACK_ROBUST) {
+        method = TRACK_MEDIAN5;
+    }
+    _blockLength = blockLength;
+    _levels = levels;
+    _method = method;
+    _threads = 0;
+    _warmupFrames = DEFAULT_WARMUP_FRAMES;
+    _chunks = 0;
+    _threadsUsed = 0;
+    _replayedFrames = 0;
+}
+
+/** Number of threads used by PitchTracker::track() (0 = one per core) */
+void PitchTracker::setThreads(int threads) {
+    _threads = (threads < 0) ? 0 : threads;
+}
+
+/** Frames run in front of each chunk before its pitches are kept */
+void PitchTracker::setWarmupFrames(int frames) {
+    _warmupFrames = (frames < 0) ? 0 : frames;
+}
+
+/** Number of pitches in the track of a file */
+long PitchTracker::getFrameCount(const MappedWav& wav) const {
+    return (wav.getFrames() + _blockLength - 1)/_blockLength;
+}
+
+/** Reads a frame into block and returns its pitch */
+float PitchTracker::detect(FLWT16& flwt, int16_t* block, long frame, const MappedWav& wav) const {
+    long start = frame*_blockLength;
+    // A mono 16-bit block inside the file is read straight from the mapping
+    const int16_t* samples = 0;
+    if (wav.getChannels() == 1 && start + _blockLength <= wav.getFrames()) {
+        samples = wav.view(start);
+    }
+    if (!samples) {
+        int got = wav.read(start, block, 0, _blockLength);
+        // Pad the last block with silence
+        for (int i = got; i < _blockLength; i++) {
+            block[i] = 0;
+        }
+        samples = block;
+    }
+    long fs = wav.getSampleRate();
+    switch (_method) {
+    case TRACK_PITCH:
+        return flwt.getPitch(samples, _blockLength, fs);
+    case TRACK_LAST_RELIABLE:
+        return flwt.getPitchLastReliable(samples, _blockLength, fs);
+    case TRACK_OCTAVE_INVARIANT:
+        return flwt.getPitchOctaveInvariant(samples, _blockLength, fs);
+    case TRACK_ROBUST:
+        return flwt.getPitchRobust(samples, _blockLength, fs);
+    default:
+        return flwt.getPitchWithMedian5(samples, _blockLength, fs);
+    }
+}
+
+/** ====================================================
+ * @brief       Pitch track with a single detector.
+ *
+ * @param       wav         Mapped recording
+ * @param       pitch       getFrameCount() pitches
+ *
+ * @return      Number of frames
+ * ======================================================
+ */
+long PitchTracker::trackSerial(const MappedWav& wav, float* pitch) const {
+    long frames = getFrameCount(wav);
+    FLWT16 flwt(_levels, _blockLength);
+    int16_t* block = new int16_t[_blockLength];
+    for (long f = 0; f < frames; f++) {
+        pitch[f] = detect(flwt, block, f, wav);
+    }
+    delete[] block;
+    return frames;
+}
+
+/** ====================================================
+ * @brief       Pitch track computed by several threads.
+ *
+ * @details     See the description of the module for how the chunks are
+ *              stitched; the result is identical to PitchTracker::trackSerial().
+ *
+ * @param       wav         Mapped recording
+ * @param       pitch       getFrameCount() pitches
+ *
+ * @return      Number of frames
+ * ======================================================
+ */
+long PitchTracker::track(const MappedWav& wav, float* pitch) {
+    long frames = getFrameCount(wav);
+    int threads = _threads;
+    if (threads == 0) {
+        threads = (int)std::thread::hardware_concurrency();
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+    long chunkFrames = (frames + (long)threads*CHUNKS_PER_THREAD - 1)/((long)threads*CHUNKS_PER_THREAD);
+    if (chunkFrames < MIN_CHUNK_FRAMES) {
+        chunkFrames = MIN_CHUNK_FRAMES;
+    }
+    int chunks = (int)((frames + chunkFrames - 1)/chunkFrames);
+    if (threads > chunks) {
+        threads = chunks;
+    }
+    _chunks = chunks;
+    _threadsUsed = threads;
+    _replayedFrames = 0;
+    if (threads <= 1) {
+        _threadsUsed = 1;
+        return trackSerial(wav, pitch);
+    }
+
+    // State before each chunk and after each frame, as seen by the threads
+    FLWTState* before = new FLWTState[chunks];
+    FLWTState* after = new FLWTState[frames];
+    std::atomic<int> nextChunk(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.push_back(std::thread([&]() {
+            FLWT16 flwt(_levels, _blockLength);
+            int16_t* block = new int16_t[_blockLength];
+            int c;
+            while ((c = nextChunk.fetch_add(1)) < chunks) {
+                long first = c*chunkFrames;
+                long last = (first + chunkFrames < frames) ? first + chunkFrames : frames;
+                flwt.resetState();
+                // The first chunk starts like the serial run, the others warm up. Every
+                //  frame adds one pitch to the median ring, so a warm-up that differs from
+                //  first by a multiple of its length leaves the ring in phase with the
+                //  serial run (median5() is not exact under reordering).
+                long warmup = (first < _warmupFrames) ? first : _warmupFrames;
+                warmup += (first - warmup) % MEDIAN_BUFFER_LENGTH;
+                for (long f = first - warmup; f < first; f++) {
+                    detect(flwt, block, f, wav);
+                }
+                flwt.getState(before[c]);
+                for (long f = first; f < last; f++) {
+                    pitch[f] = detect(flwt, block, f, wav);
+                    flwt.getState(after[f]);
+                }
+            }
+            delete[] block;
+        }));
+    }
+    for (int t = 0; t < threads; t++) {
+        workers[t].join();
+    }
+
+    // Stitch: replay the start of every chunk that began from the wrong state
+    FLWT16 flwt(_levels, _blockLength);
+    int16_t* block = new int16_t[_blockLength];
+    FLWTState truth = after[chunkFrames - 1];
+    for (int c = 1; c < chunks; c++) {
+        long first = c*chunkFrames;
+        long last = (first + chunkFrames < frames) ? first + chunkFrames : frames;
+        bool exact = truth.equals(before[c]);
+        if (!exact) {
+            flwt.setState(truth);
+            for (long f = first; f < last && !exact; f++) {
+                pitch[f] = detect(flwt, block, f, wav);
+                _replayedFrames++;
+                flwt.getState(truth);
+                exact = truth.equals(after[f]);
+            }
+        }
+        // Unless the replay ran to the end of the chunk, the rest of it was exact
+        if (exact) {
+            truth = after[last - 1];
+        }
+    }
+    delete[] block;
+    delete[] before;
+    delete[] after;
+    return frames;
+}
@@ -0,0 +1,61 @@
+//
+//  PitchTrack.h
+//
+//
+//  Offline pitch track of a whole recording, split between threads and
+//  stitched so that it is identical to a single FLWT run (host tools only).
+//
+//
+
+#ifndef ____PitchTrack__
+#define ____PitchTrack__
+
+#include <stdio.h>
+#include "FLWT.h"
+#include "WavFile.h"
+
+// Which FLWT function gives the pitch of a frame
+#define TRACK_PITCH                 0   // FLWT::getPitch
+#define TRACK_MEDIAN5               1   // FLWT::getPitchWithMedian5
+#define TRACK_LAST_RELIABLE         2   // FLWT::getPitchLastReliable
+#define TRACK_OCTAVE_INVARIANT      3   // FLWT::getPitchOctaveInvariant
+#define TRACK_ROBUST                4   // FLWT::getPitchRobust
+
+#define DEFAULT_TRACK_BLOCK_LENGTH  512
+#define DEFAULT_TRACK_LEVELS        6
+#define DEFAULT_WARMUP_FRAMES       32  // frames replayed in front of a chunk to settle its detector
+#define CHUNKS_PER_THREAD           4   // more chunks than threads so that they finish together
+#define MIN_CHUNK_FRAMES            256
+
+class PitchTracker {
+public:
+    // blockLength MUST be divisible by 2^(levels-1) and at most DEFAULT_WIN_LENGTH
+    PitchTracker(int blockLength = DEFAULT_TRACK_BLOCK_LENGTH, int levels = DEFAULT_TRACK_LEVELS, int method = TRACK_MEDIAN5);
+    // 0 = one per core
+    void setThreads(int threads);
+    void setWarmupFrames(int frames);
+    // One pitch per block of the left channel (the last block is padded with silence)
+    long getFrameCount(const MappedWav& wav) const;
+    // Fills pitch (getFrameCount() values), returns the number of frames
+    long track(const MappedWav& wav, float* pitch);
+    // The same with a single detector, for reference
+    long trackSerial(const MappedWav& wav, float* pitch) const;
+    // Statistics of the last track()
+    int getChunks() const { return _chunks; }
+    int getThreadsUsed() const { return _threadsUsed; }
+    long getReplayedFrames() const { return _replayedFrames; }
+
+private:
+    float detect(FLWT16& flwt, int16_t* block, long frame, const MappedWav& wav) const;
+
+    int _blockLength;
+    int _levels;
+    int _method;
+    int _threads;
+    int _warmupFrames;
+    int _chunks;
+    int _threadsUsed;
+    long _replayedFrames;
+};
+
+#endif /* defined(____PitchTrack__) */
@@ -0,0 +1,68 @@
+//
+//  main.cpp
+//
+//
+//  Tracks the pitch of a WAV file with 1 to 8 threads, with and without
+//  warm-up, and checks that every track is identical to the serial one.
+//  Build: g++ -std=c++11 -O2 -mssse3 -pthread -I../FLWT -I../Profiler -I../CostModel -I../Arena -I../WavFile main.cpp PitchTrack.cpp
+//         ../FLWT/FLWT.cpp ../WavFile/WavFile.cpp
+//  Usage: a.out [file.wav]
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "PitchTrack.h"
+#include <iostream>
+#include <chrono>
+
+using namespace std;
+
+const char* defaultPath = "../Version Final/FinalDemo/cscalesinging.wav";
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    cout<<endl<<"PitchTrack Testing: "<<endl<<endl;
+    const char* path = (argc > 1) ? argv[1] : defaultPath;
+    MappedWav wav;
+    if (wav.open(path)) {
+        printf("cannot read %s\n", path);
+        return 1;
+    }
+    int methods[] = {TRACK_PITCH, TRACK_MEDIAN5, TRACK_ROBUST};
+    const char* names[] = {"getPitch", "getPitchWithMedian5", "getPitchRobust"};
+    bool pass = true;
+    for (int m = 0; m < 3; m++) {
+        PitchTracker tracker(DEFAULT_TRACK_BLOCK_LENGTH, DEFAULT_TRACK_LEVELS, methods[m]);
+        long frames = tracker.getFrameCount(wav);
+        float* serial = new float[frames];
+        float* parallel = new float[frames];
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        tracker.trackSerial(wav, serial);
+        double serialSeconds = secondsSince(start);
+        printf("%s: %ld frames, serial %.2f ms\n", names[m], frames, 1000*serialSeconds);
+        int threadCounts[] = {2, 4, 8};
+        for (int t = 0; t < 3; t++) {
+            // No warm-up at all forces the replay at every seam
+            for (int warmup = 0; warmup <= DEFAULT_WARMUP_FRAMES; warmup += DEFAULT_WARMUP_FRAMES) {
+                tracker.setThreads(threadCounts[t]);
+                tracker.setWarmupFrames(warmup);
+                start = chrono::steady_clock::now();
+                tracker.track(wav, parallel);
+                double seconds = secondsSince(start);
+                bool same = !memcmp(serial, parallel, frames*sizeof(float));
+                pass = pass && same;
+                printf("  %d threads, warm-up %2d: %d chunks, %4ld frames replayed, %.2f ms, %s\n",
+                       tracker.getThreadsUsed(), warmup, tracker.getChunks(), tracker.getReplayedFrames(),
+                       1000*seconds, same ? "identical" : "DIFFERENT");
+            }
+        }
+        delete[] serial;
+        delete[] parallel;
+    }
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+/**
+ *   @mainpage Hot-Path Profiler
+ *
+ *   \section desc_sec Description
+ *   Tells where the time of a frame goes inside FLWT::getPitch() (the
+ *      statistics pass, then the lifting and peak search pass and the mode
+ *      search of every level) and PSOLA::pitchCorrect() (storage, window,
+ *      overlap and add, write back).
+ *
+ *  @n The instrumentation is a handful of macros. Built with PV_PROFILE
+ *      defined, PV_PROFILE_SCOPE() times the rest of a scope and
+ *      PV_PROFILE_START()/PV_PROFILE_LAP() time consecutive stages of a loop,
+ *      adding the ticks to a slot of a Profile owned by the instrumented
+ *      object. Without PV_PROFILE every macro expands to nothing and the
+ *      objects have no Profile, so the production build is unchanged.
+ *
+ *  @n The ticks come from rdtsc on x86 hosts and clock_gettime() on other
+ *      hosts. On the device, define PV_PROFILE_TICKS() to read a cycle
+ *      counter (e.g. the timer of the C5535) and PV_PROFILE_TICKS_PER_SECOND
+ *      to its rate. On the host, setProfileClock() makes the same slots count
+ *      another event instead, e.g. branch misses read from perf_event (see
+ *      the Bench harness).
+ *
+ *  \section contents_sec Table of Contents
+ *    Profiler.cpp
+ *
+ *    Profiler.h
+ *
+ */
+
+/**
+ *  @file Profiler.cpp
+ *  @brief Source file for Profile
+ *  @file Profiler.h
+ *  @brief Header file for Profile and the PV_PROFILE_* macros
+ */
+
+#include "Profiler.h"
+#ifdef PV_PROFILE
+#include <time.h>
+#endif
+
+/** Calibration time of rdtsc against clock_gettime() */
+#define CALIBRATION_NS          20000000
+
+#if defined(PV_PROFILE) && !defined(PV_PROFILE_TICKS)
+/** Counter read by profileTicks() instead of the time (see setProfileClock()) */
+ProfileClock profileClock = 0;
+#endif
+
+/** ====================================================
+ * @brief       Rate of profileTicks().
+ *
+ * @details     rdtsc is calibrated against the monotonic clock the first
+ *              time this is called.
+ *
+ * @return      Ticks per second
+ * ======================================================
+ */
+double profileTicksPerSecond() {
+#if defined(PV_PROFILE_TICKS_PER_SECOND)
+    return PV_PROFILE_TICKS_PER_SECOND;
+#elif defined(PV_PROFILE_TICKS) || !defined(PV_PROFILE)
+    return 1;
+#elif defined(__x86_64__) || defined(__i386__)
+    static double rate = 0;
+    if (rate == 0) {
+        struct timespec start, now;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        ProfileTicks ticks = profileDefaultTicks();
+        long long elapsed;
+        do {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            elapsed = (now.tv_sec - start.tv_sec)*1000000000LL + (now.tv_nsec - start.tv_nsec);
+        } while (elapsed < CALIBRATION_NS);
+        rate = (profileDefaultTicks() - ticks)*1e9/elapsed;
+    }
+    return rate;
+#else
+    return 1e9;
+#endif
+}
+
+/** Standard constructor, no slots */
+Profile::Profile() {
+    _names = 0;
+    _slots = 0;
+    reset();
+}
+
+/** ====================================================
+ * @brief       Names the slots.
+ *
+ * @param       names       One name per slot
+ * @param       slots       Number of slots
+ * ======================================================
+ */
+void Profile::setSlots(const char* const* names, int slots) {
+    // Error Handle
+    if (slots < 0) {
+        slots = 0;
+    }
+    if (slots > PROFILE_MAX_SLOTS) {
+        slots = PROFILE_MAX_SLOTS;
+    }
+    _names = names;
+    _slots = slots;
+    reset();
+}
+
+/** Clears every slot */
+void Profile::reset() {
+    for (int i = 0; i < PROFILE_MAX_SLOTS; i++) {
+        _ticks[i] = 0;
+        _calls[i] = 0;
+    }
+}
+
+/** Time accumulated in a slot */
+double Profile::getSeconds(int slot) const {
+    return _ticks[slot]/profileTicksPerSecond();
+}
+
+/** ====================================================
+ * @brief       Prints the breakdown.
+ *
+ * @param       out         Where to print
+ * @param       title       First line
+ * @param       units       Number of frames, samples... the time is divided by (0 = none)
+ * @param       unitName    Name of one unit (e.g. "frame")
+ * ======================================================
+ */
+void Profile::print(FILE* out, const char* title, long units, const char* unitName) const {
+    double total = 0;
+    for (int i = 0; i < _slots; i++) {
+        total += getSeconds(i);
+    }
+    fprintf(out, "%s: %.3f ms in total\n", title, 1e3*total);
+    for (int i = 0; i < _slots; i++) {
+        if (!_calls[i]) {
+            continue;
+        }
+        double seconds = getSeconds(i);
+        fprintf(out, "  %-24s %9.3f ms %5.1f%% %9.1f ns/call %9lu calls", _names[i], 1e3*seconds,
+                total ? 100*seconds/total : 0, 1e9*seconds/_calls[i], _calls[i]);
+        if (units > 0) {
+            fprintf(out, " %9.1f ns/%s", 1e9*seconds/units, unitName ? unitName : "unit");
+        }
+        fprintf(out, "\n");
+    }
+}
+
+/** ====================================================
+ * @brief       Prints the breakdown of a profile counted in events.
+ *
+ * @param       out         Where to print
+ * @param       title       First line
+ * @param       event       Name of what the ticks count
+ * @param       units       Number of frames, samples... the counts are divided by (0 = none)
+ * @param       unitName    Name of one unit (e.g. "sample")
+ * ======================================================
+ */
+void Profile::printCounts(FILE* out, const char* title, const char* event, long units, const char* unitName) const {
+    double total = 0;
+    for (int i = 0; i < _slots; i++) {
+        total += (double)_ticks[i];
+    }
+    fprintf(out, "%s: %.0f %s in total\n", title, total, event);
+    for (int i = 0; i < _slots; i++) {
+        if (!_calls[i]) {
+            continue;
+        }
+        double count = (double)_ticks[i];
+        fprintf(out, "  %-24s %14.0f %5.1f%% %11.1f /call", _names[i], count,
+                total ? 100*count/total : 0, count/_calls[i]);
+        if (units > 0) {
+            fprintf(out, " %9.3f /%s", count/units, unitName ? unitName : "unit");
+        }
+        fprintf(out, "\n");
+    }
+}
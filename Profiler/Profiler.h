@@ -0,0 +1,106 @@
+//
+//  Profiler.h
+//
+//
+//  Scoped hot-path timers. Built with PV_PROFILE defined, the PV_PROFILE_*
+//  macros accumulate time per slot into a Profile; without it they compile
+//  to nothing.
+//
+//
+
+#ifndef ____Profiler__
+#define ____Profiler__
+
+#include <stdio.h>
+
+#define PROFILE_MAX_SLOTS       16
+
+#if defined(PV_PROFILE_TICKS)
+// Device: PV_PROFILE_TICKS() reads a cycle counter, PV_PROFILE_TICKS_PER_SECOND is its rate
+typedef unsigned long ProfileTicks;
+inline ProfileTicks profileTicks() { return (ProfileTicks)PV_PROFILE_TICKS(); }
+#elif defined(PV_PROFILE)
+// Host: rdtsc or clock_gettime(), unless setProfileClock() picked another counter
+typedef unsigned long long ProfileTicks;
+typedef ProfileTicks (*ProfileClock)();
+extern ProfileClock profileClock;
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+inline ProfileTicks profileDefaultTicks() { return __rdtsc(); }
+#else
+#include <time.h>
+inline ProfileTicks profileDefaultTicks() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (ProfileTicks)now.tv_sec*1000000000ULL + now.tv_nsec;
+}
+#endif
+inline ProfileTicks profileTicks() { return profileClock ? profileClock() : profileDefaultTicks(); }
+// Counts something else than time from now on (e.g. a hardware event), 0 = back to time
+inline void setProfileClock(ProfileClock clock) { profileClock = clock; }
+#else
+typedef unsigned long ProfileTicks;
+inline ProfileTicks profileTicks() { return 0; }
+#endif
+
+// Rate of profileTicks() (measured once on the host)
+double profileTicksPerSecond();
+
+// Time and number of calls per named slot
+class Profile {
+public:
+    Profile();
+    // names must outlive the profile; slots beyond PROFILE_MAX_SLOTS are ignored
+    void setSlots(const char* const* names, int slots);
+    void add(int slot, ProfileTicks ticks) {
+        _ticks[slot] += ticks;
+        _calls[slot]++;
+    }
+    void reset();
+    int getSlots() const { return _slots; }
+    const char* getName(int slot) const { return _names[slot]; }
+    ProfileTicks getTicks(int slot) const { return _ticks[slot]; }
+    unsigned long getCalls(int slot) const { return _calls[slot]; }
+    double getSeconds(int slot) const;
+    // One line per slot that ran: time, share of the total and time per call, plus the
+    //  time per unit (e.g. per frame or per sample) when units > 0
+    void print(FILE* out, const char* title, long units = 0, const char* unitName = 0) const;
+    // Same with the raw ticks, for a profile counted with setProfileClock()
+    void printCounts(FILE* out, const char* title, const char* event, long units = 0, const char* unitName = 0) const;
+
+private:
+    const char* const* _names;
+    int _slots;
+    ProfileTicks _ticks[PROFILE_MAX_SLOTS];
+    unsigned long _calls[PROFILE_MAX_SLOTS];
+};
+
+#ifdef PV_PROFILE
+// Adds the time until the end of the enclosing scope to a slot
+class ProfileScope {
+public:
+    ProfileScope(Profile& profile, int slot) : _profile(profile), _slot(slot), _start(profileTicks()) {}
+    ~ProfileScope() { _profile.add(_slot, profileTicks() - _start); }
+
+private:
+    Profile& _profile;
+    int _slot;
+    ProfileTicks _start;
+};
+
+#define PROFILE_CONCAT2(a, b)               a##b
+#define PROFILE_CONCAT(a, b)                PROFILE_CONCAT2(a, b)
+#define PV_PROFILE_SCOPE(profile, slot)     ProfileScope PROFILE_CONCAT(_profileScope, __LINE__)((profile), (slot))
+// Starts a stopwatch, adds the time since it started to a slot and restarts it
+#define PV_PROFILE_START(watch)             ProfileTicks watch = profileTicks()
+#define PV_PROFILE_LAP(profile, slot, watch) \
+    do { ProfileTicks _profileNow = profileTicks(); (profile).add((slot), _profileNow - (watch)); (watch) = _profileNow; } while (0)
+#define PV_PROFILE_ONLY(statement)          statement
+#else
+#define PV_PROFILE_SCOPE(profile, slot)
+#define PV_PROFILE_START(watch)
+#define PV_PROFILE_LAP(profile, slot, watch)
+#define PV_PROFILE_ONLY(statement)
+#endif
+
+#endif /* defined(____Profiler__) */
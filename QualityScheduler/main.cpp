@@ -0,0 +1,45 @@
+//
+//  main.cpp
+//
+//
+//  Drives the quality scheduler with a simulated processing load that
+//  spikes for a while and then recovers.
+//  Build: g++ main.cpp QualityScheduler.cpp
+//
+
+#include <stdio.h>
+#include "QualityScheduler.h"
+#include <iostream>
+
+using namespace std;
+
+// Frame time of each quality level at normal load (us), budget is 16000us (512 samples at 32kHz)
+unsigned long levelCost[NUM_QUALITY_LEVELS] = {9000, 8000, 5000, 2600, 100};
+const unsigned long budget = 16000;
+
+int main() {
+    cout<<endl<<"QualityScheduler Testing: "<<endl<<endl;
+    QualityScheduler scheduler(budget);
+    int lastLevel = scheduler.getLevel();
+    for (int frame = 0; frame < 2000; frame++) {
+        // The processor is shared with something else for frames 200-700 (2x slower),
+        //  and frames 1200-1210 are a short burst (3x slower)
+        int load = 1;
+        if (frame >= 200 && frame < 700) {
+            load = 2;
+        } else if (frame >= 1200 && frame < 1210) {
+            load = 3;
+        }
+        // +-5% of jitter
+        unsigned long cost = levelCost[scheduler.getLevel()]*load;
+        cost = (unsigned long)((long)cost*(95 + (frame*7)%11)/100);
+        scheduler.frameDone(cost);
+        if (scheduler.getLevel() != lastLevel) {
+            cout<<"frame "<<frame<<": level "<<lastLevel<<" -> "<<scheduler.getLevel()<<" (frame took "<<cost<<"us)"<<endl;
+            lastLevel = scheduler.getLevel();
+        }
+    }
+    cout<<endl;
+    scheduler.print();
+    return 0;
+}
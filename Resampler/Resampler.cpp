@@ -0,0 +1,205 @@
+/**
+ *   @mainpage Polyphase Resampler Module
+ *
+ *   \section desc_sec Description
+ *   Converts a stream of 16-bit samples between two sampling rates whose
+ *      ratio is rational (48 kHz to 32, 16 or 8 kHz and back, for example),
+ *      so the codec can stay at one rate while each mode works at its own.
+ *
+ *  @n The rate change is done as upsampling by L, low-pass filtering and
+ *      downsampling by M, with the filter split into L polyphase branches so
+ *      that only the products that survive the downsampling are computed.
+ *      Each output costs one dot product of getPhaseLength() taps. The
+ *      filter is a Blackman windowed sinc designed once in the constructor,
+ *      with its passband edge at RESAMPLER_CUTOFF of the lower of the two
+ *      Nyquist frequencies, and stored as Q15 coefficients.
+ *
+ *  @n The history is kept twice in a row so that the samples under the
+ *      filter are always contiguous: the inner loop is a plain multiply and
+ *      accumulate of two short arrays with a 32-bit sum, which the C5535
+ *      does in one cycle per tap and which uses SSE2 (8 taps per
+ *      instruction) on a host.
+ *
+ *  \section contents_sec Table of Contents
+ *    Resampler.cpp
+ *
+ *    Resampler.h
+ *
+ */
+
+/**
+ *  @file Resampler.cpp
+ *  @brief Source file for Resampler
+ *  @file Resampler.h
+ *  @brief Header file for Resampler
+ */
+
+#include "Resampler.h"
+#include "FixedPoint.h"
+#include <math.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define PI                  3.14159265358979
+
+static long gcd(long a, long b) {
+    while (b) {
+        long t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// Q15 dot product of n taps (n is a multiple of RESAMPLER_TAP_ALIGN)
+static inline long dot(const short* h, const short* x, int n) {
+#if defined(__SSE2__)
+    __m128i acc = _mm_setzero_si128();
+    for (int i = 0; i < n; i += 8) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(h + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(x + i));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(a, b));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1,0,3,2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2,3,0,1)));
+    return (long)_mm_cvtsi128_si32(acc);
+#else
+    long acc = 0;
+    for (int i = 0; i < n; i++) {
+        acc += (long)h[i]*x[i];
+    }
+    return acc;
+#endif
+}
+
+/** ==============================================================================
+ * @brief       Designs the polyphase filter for an inRate to outRate conversion.
+ *
+ * @details     The ratio is reduced to L/M. The prototype filter has
+ *              taps*max(L,M) taps (rounded up so every phase is a multiple of
+ *              RESAMPLER_TAP_ALIGN taps), and every phase is normalized to a
+ *              DC gain of exactly 1. Equal rates give a plain copy.
+ *
+ * @param       inRate      Input sampling frequency
+ * @param       outRate     Output sampling frequency
+ * @param       taps        Filter taps per unit of max(L,M)
+ * ================================================================================
+ */
+Resampler::Resampler(long inRate, long outRate, int taps) {
+    // Error Handle
+    if (inRate <= 0 || outRate <= 0) {
+        inRate = 1;
+        outRate = 1;
+    }
+    if (taps < 1) {
+        taps = DEFAULT_RESAMPLER_TAPS;
+    }
+    long g = gcd(inRate, outRate);
+    _up = (int)(outRate/g);
+    _down = (int)(inRate/g);
+    _coeffs = 0;
+    _history = 0;
+    _phaseLen = 0;
+    if (_up == 1 && _down == 1) {
+        return;
+    }
+
+    int factor = (_up > _down) ? _up : _down;
+    _phaseLen = (taps*factor + _up - 1)/_up;
+    _phaseLen = (_phaseLen + RESAMPLER_TAP_ALIGN - 1)/RESAMPLER_TAP_ALIGN*RESAMPLER_TAP_ALIGN;
+    int n = _phaseLen*_up;
+    double fc = 0.5*RESAMPLER_CUTOFF/factor;   // cycles per upsampled sample
+    double center = 0.5*(n - 1);
+    double* h = new double[n];
+    for (int i = 0; i < n; i++) {
+        double t = i - center;
+        double sinc = (t == 0) ? 1.0 : sin(2*PI*fc*t)/(2*PI*fc*t);
+        double w = 0.42 - 0.5*cos(2*PI*i/(n - 1)) + 0.08*cos(4*PI*i/(n - 1));
+        h[i] = sinc*w;
+    }
+
+    // Phase p uses h[p], h[p+L], h[p+2L], ... against the newest, 2nd newest, ... input
+    _coeffs = new short[n];
+    for (int p = 0; p < _up; p++) {
+        double sum = 0;
+        for (int k = 0; k < _phaseLen; k++) {
+            sum += h[p + k*_up];
+        }
+        for (int k = 0; k < _phaseLen; k++) {
+            _coeffs[p*_phaseLen + _phaseLen - 1 - k] = fixedSaturate<short>((long)floor(h[p + k*_up]/sum*32768.0 + 0.5), Q15_MIN, Q15_MAX);
+        }
+    }
+    delete[] h;
+
+    _history = new short[2*_phaseLen];
+    reset();
+}
+
+/** Standard destructor */
+Resampler::~Resampler() {
+    delete[] _coeffs;
+    delete[] _history;
+}
+
+/** Clears the history so the next call starts from silence */
+void Resampler::reset() {
+    for (int i = 0; i < 2*_phaseLen; i++) {
+        _history[i] = 0;
+    }
+    _pos = 0;
+    _phase = 0;
+}
+
+/** Upper bound on the samples that process() writes for inLen input samples */
+int Resampler::getMaxOutput(int inLen) const {
+    return (int)(((long)inLen*_up + _up - 1)/_down + 1);
+}
+
+/** Group delay of the filter in output samples */
+int Resampler::getDelay() const {
+    if (!_coeffs) {
+        return 0;
+    }
+    return (_phaseLen*_up - 1)/(2*_down);
+}
+
+/** ====================================================
+ * @brief       Resamples a block of samples.
+ *
+ * @details     State is carried between calls, so a stream can be fed in
+ *              blocks of any length. Samples are saturated to 16 bits on the
+ *              way in and out.
+ *
+ * @param       in          Input samples
+ * @param       inLen       Number of input samples
+ * @param       out         Output samples (room for getMaxOutput(inLen))
+ *
+ * @return      Number of output samples written
+ * ======================================================
+ */
+int Resampler::process(const int* in, int inLen, int* out) {
+    if (!_coeffs) {
+        for (int i = 0; i < inLen; i++) {
+            out[i] = in[i];
+        }
+        return inLen;
+    }
+    int produced = 0;
+    for (int i = 0; i < inLen; i++) {
+        _pos = (_pos + 1 == _phaseLen) ? 0 : _pos + 1;
+        short x = fixedSaturate<short>(in[i], Q15_MIN, Q15_MAX);
+        _history[_pos] = x;
+        _history[_pos + _phaseLen] = x;
+        // Oldest to newest input under the filter
+        const short* window = _history + _pos + 1;
+        while (_phase < _up) {
+            long acc = dot(_coeffs + _phase*_phaseLen, window, _phaseLen);
+            out[produced++] = q15RoundSatRaw<short>(acc);
+            _phase += _down;
+        }
+        _phase -= _up;
+    }
+    return produced;
+}
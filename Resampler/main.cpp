@@ -0,0 +1,91 @@
+//
+//  main.cpp
+//
+//
+//  Round trips tones through the resampler at the FinalDemo working rates.
+//  Build: g++ -O2 -I../FixedPoint main.cpp Resampler.cpp
+//
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include "Resampler.h"
+#include <iostream>
+
+using namespace std;
+
+const long codecRate = 48000;
+const long workingRates[] = {32000, 16000, 8000};
+const int blockLength = 512;
+const int numBlocks = 400;
+
+// RMS of x[from..to)
+double rms(const int* x, int from, int to) {
+    double sum = 0;
+    for (int i = from; i < to; i++) {
+        sum += (double)x[i]*x[i];
+    }
+    return sqrt(sum/(to - from));
+}
+
+int main() {
+    cout<<endl<<"Resampler Testing: "<<endl<<endl;
+    int total = blockLength*numBlocks;
+    int* input = new int[total];
+    int* work = new int[total + 16];
+    int* output = new int[total + 16];
+    for (int r = 0; r < 3; r++) {
+        long rate = workingRates[r];
+        Resampler down(codecRate, rate);
+        Resampler up(rate, codecRate);
+
+        // 440 Hz tone: passes through the round trip
+        for (int i = 0; i < total; i++) {
+            input[i] = (int)(16000*sin(2*3.14159265358979*440*i/codecRate));
+        }
+        clock_t start = clock();
+        int workLen = 0;
+        int outLen = 0;
+        for (int b = 0; b < numBlocks; b++) {
+            int n = down.process(input + b*blockLength, blockLength, work + workLen);
+            outLen += up.process(work + workLen, n, output + outLen);
+            workLen += n;
+        }
+        double seconds = (double)(clock() - start)/CLOCKS_PER_SEC;
+        // Residual after removing the best fitting 440 Hz sine (the delay is fractional)
+        int from = 2000;
+        int to = outLen - 100;
+        double c = 0, q = 0;
+        for (int i = from; i < to; i++) {
+            c += output[i]*cos(2*3.14159265358979*440*i/codecRate);
+            q += output[i]*sin(2*3.14159265358979*440*i/codecRate);
+        }
+        c *= 2.0/(to - from);
+        q *= 2.0/(to - from);
+        double error = 0;
+        for (int i = from; i < to; i++) {
+            double e = output[i] - c*cos(2*3.14159265358979*440*i/codecRate) - q*sin(2*3.14159265358979*440*i/codecRate);
+            error += e*e;
+        }
+        error = sqrt(error/(to - from));
+        double gain = sqrt(c*c + q*q)/16000;
+
+        // Tone above the working Nyquist: must be removed by the decimator
+        double alias = 0.6*rate;
+        for (int i = 0; i < total; i++) {
+            input[i] = (int)(16000*sin(2*3.14159265358979*alias*i/codecRate));
+        }
+        Resampler downAlias(codecRate, rate);
+        int aliasLen = downAlias.process(input, total, work);
+
+        printf("48000 -> %5ld -> 48000: L/M=%d/%d taps/phase=%2d  %5.1f ns/sample  gain %6.3f dB  round trip noise %5.1f dB  "
+               "%5.0f Hz tone after decimation %6.1f dB\n",
+               rate, down.getUp(), down.getDown(), down.getPhaseLength(),
+               1e9*seconds/total, 20*log10(gain), 20*log10(error/16000*sqrt(2.0) + 1e-12),
+               alias, 20*log10(rms(work, 1000, aliasLen)/rms(input, 0, total) + 1e-12));
+    }
+    delete[] input;
+    delete[] work;
+    delete[] output;
+    return 0;
+}
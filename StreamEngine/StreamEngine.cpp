@@ -0,0 +1,476 @@
+/**
+ *   @mainpage Multi-Stream Engine Module
+ *
+ *   \section desc_sec Description
+ *   FinalDemo corrects one stream with one global FLWT, PSOLA and Frequency.
+ *      A StreamEngine corrects many independent voice streams at once: every
+ *      stream owns a PitchCorrector (its FLWT history, PSOLAs, key and
+ *      KeyDetector), and the blocks submitted to the streams are corrected
+ *      on a pool of worker threads.
+ *
+ *  @n Each stream is in at most one run queue at a time, and a worker takes
+ *      only its oldest block, so the blocks of a stream are corrected (and
+ *      called back) in the order they were submitted and never two at once,
+ *      which is what its FLWT and KeyDetector need. When the block is done
+ *      and more are pending, the stream goes back to the queue of the worker
+ *      that ran it, whose cache holds its state.
+ *
+ *  @n Every block gets a deadline (submission time plus the deadline of its
+ *      stream, one block period by default). The run queues are min-heaps on
+ *      the deadline of the oldest block of each stream, so a worker always
+ *      runs the most urgent stream it has (earliest deadline first). A worker
+ *      whose queue is empty steals the most urgent stream of the other
+ *      workers rather than sleeping, so a burst on a few streams spreads over
+ *      the whole pool.
+ *
+ *  @n The engine counts the blocks, the deadline misses and the steals, and
+ *      keeps a histogram of the submit to callback latency (log-linear
+ *      buckets, 12% resolution) from which getStats() reads the tail
+ *      percentiles.
+ *
+ *  \section contents_sec Table of Contents
+ *    StreamEngine.cpp
+ *
+ *    StreamEngine.h
+ *
+ *    main.cpp
+ *
+ */
+
+/**
+ *  @file StreamEngine.cpp
+ *  @brief Source file for StreamEngine
+ *  @file StreamEngine.h
+ *  @brief Header file for StreamEngine
+ */
+
+#include "StreamEngine.h"
+#include <algorithm>
+#include <chrono>
+
+// LatencyHistogram =======================
+
+/** Bucket of a latency: exact below LATENCY_SUB_BUCKETS us, then LATENCY_SUB_BUCKETS per octave */
+int LatencyHistogram::bucketOf(long us) {
+    if (us < LATENCY_SUB_BUCKETS) {
+        return (us < 0) ? 0 : (int)us;
+    }
+    int msb = 0;
+    while ((us >> (msb + 1)) != 0) {
+        msb++;
+    }
+    // msb >= 3 here; the 3 bits below the leading one pick the sub-bucket
+    int bucket = (msb - 2)*LATENCY_SUB_BUCKETS + (int)((us >> (msb - 3)) & (LATENCY_SUB_BUCKETS - 1));
+    return (bucket < LATENCY_BUCKETS) ? bucket : LATENCY_BUCKETS - 1;
+}
+
+/** Largest latency that falls in a bucket */
+long LatencyHistogram::upperBound(int bucket) {
+    if (bucket < LATENCY_SUB_BUCKETS) {
+        return bucket;
+    }
+    int msb = bucket/LATENCY_SUB_BUCKETS + 2;
+    long lower = (long)(LATENCY_SUB_BUCKETS + bucket % LATENCY_SUB_BUCKETS) << (msb - 3);
+    return lower + (1L << (msb - 3)) - 1;
+}
+
+/** Adds a latency in microseconds */
+void LatencyHistogram::add(long us) {
+    _buckets[bucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+    long seen = _max.load(std::memory_order_relaxed);
+    while (us > seen && !_max.compare_exchange_weak(seen, us, std::memory_order_relaxed)) {
+    }
+}
+
+/** Forgets every latency */
+void LatencyHistogram::reset() {
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+        _buckets[b].store(0);
+    }
+    _max.store(0);
+}
+
+/** Number of latencies added */
+long LatencyHistogram::count() const {
+    long total = 0;
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+        total += _buckets[b].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+/** ====================================================
+ * @brief       Latency below which a fraction of the samples fall.
+ *
+ * @param       fraction    0 to 1 (0.99 for the 99th percentile)
+ *
+ * @return      Upper bound of the bucket of that percentile (at most max()), 0 if empty
+ * ======================================================
+ */
+long LatencyHistogram::percentile(double fraction) const {
+    long total = count();
+    if (total == 0) {
+        return 0;
+    }
+    long rank = (long)(fraction*total + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > total) rank = total;
+    long seen = 0;
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+        seen += _buckets[b].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            long bound = upperBound(b);
+            return (bound < max()) ? bound : max();
+        }
+    }
+    return max();
+}
+
+// StreamEngine ===========================
+
+/** Orders the run queue heaps on the earliest deadline */
+bool StreamEngine::laterDeadline(const Task& a, const Task& b) {
+    return a.deadlineUs > b.deadlineUs;
+}
+
+/** ==============================================================================
+ * @brief       Starts the worker threads.
+ *
+ * @param       threads         Number of workers (0 = one per core, at most MAX_ENGINE_THREADS)
+ * @param       blockLength     Samples per channel in a block, for every stream
+ * @param       levels          FLWT levels of every stream
+ * ================================================================================
+ */
+StreamEngine::StreamEngine(int threads, int blockLength, int levels)
+    : _numStreams(0), _queuedTasks(0), _outstanding(0), _blocks(0), _missed(0), _steals(0), _statsStartUs(0) {
+    // Error Handle
+    if (threads <= 0) {
+        threads = (int)std::thread::hardware_concurrency();
+    }
+    if (threads < 1) threads = 1;
+    if (threads > MAX_ENGINE_THREADS) threads = MAX_ENGINE_THREADS;
+    _threads = threads;
+    _blockLength = blockLength;
+    _levels = levels;
+    _callback = 0;
+    _user = 0;
+    _stopping = false;
+    for (int s = 0; s < MAX_ENGINE_STREAMS; s++) {
+        _streams[s] = 0;
+    }
+    for (int w = 0; w < MAX_ENGINE_THREADS; w++) {
+        _workers[w] = 0;
+    }
+    // Every queue exists before a worker can try to steal from it
+    for (int w = 0; w < _threads; w++) {
+        _workers[w] = new Worker;
+    }
+    resetStats();
+    for (int w = 0; w < _threads; w++) {
+        _workers[w]->thread = std::thread(&StreamEngine::run, this, w);
+    }
+}
+
+/** Finishes the pending blocks, stops the workers and frees the streams */
+StreamEngine::~StreamEngine() {
+    drain();
+    {
+        std::lock_guard<std::mutex> guard(_sleepLock);
+        _stopping = true;
+    }
+    _wake.notify_all();
+    for (int w = 0; w < _threads; w++) {
+        _workers[w]->thread.join();
+        delete _workers[w];
+    }
+    for (int s = 0; s < _numStreams.load(); s++) {
+        Stream* stream = _streams[s];
+        for (size_t j = 0; j < stream->spare.size(); j++) {
+            delete[] stream->spare[j]->left;
+            delete[] stream->spare[j]->right;
+            delete stream->spare[j];
+        }
+        delete stream->corrector;
+        delete stream;
+    }
+}
+
+/** Sets the function called with every corrected block (before the first submit()) */
+void StreamEngine::setCallback(BlockCallback callback, void* user) {
+    _callback = callback;
+    _user = user;
+}
+
+/** Microseconds on a monotonic clock */
+long long StreamEngine::now() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/** ====================================================
+ * @brief       Adds a stream.
+ *
+ * @param       fs              Sampling frequency of the stream
+ * @param       stereo          false: only the left channel is corrected and called back
+ * @param       deadlineUs      Time each block has from submit() to its callback (0 = one block period)
+ *
+ * @return      Index of the stream, or -1 if there are MAX_ENGINE_STREAMS already
+ * ======================================================
+ */
+int StreamEngine::addStream(long fs, bool stereo, long deadlineUs) {
+    std::lock_guard<std::mutex> guard(_addLock);
+    int index = _numStreams.load();
+    if (index >= MAX_ENGINE_STREAMS || fs <= 0) {
+        return -1;
+    }
+    Stream* stream = new Stream;
+    stream->corrector = new PitchCorrector(fs, _blockLength, _levels);
+    stream->stereo = stereo;
+    stream->deadlineUs = (deadlineUs > 0) ? deadlineUs : (long)((long long)_blockLength*1000000/fs);
+    stream->home = index % _threads;
+    stream->queued = false;
+    _streams[index] = stream;
+    _numStreams.store(index + 1);
+    return index;
+}
+
+/** PitchCorrector of a stream (0 if unknown) */
+PitchCorrector* StreamEngine::getCorrector(int stream) {
+    if (stream < 0 || stream >= _numStreams.load()) {
+        return 0;
+    }
+    return _streams[stream]->corrector;
+}
+
+/** Blocks of a stream submitted but not called back yet */
+int StreamEngine::getPending(int stream) {
+    if (stream < 0 || stream >= _numStreams.load()) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(_streams[stream]->lock);
+    return (int)_streams[stream]->pending.size();
+}
+
+/** ====================================================
+ * @brief       Queues a block of a stream.
+ *
+ * @details     The samples are copied, so the buffers can be reused as soon
+ *              as this returns. If the stream had nothing pending, it is
+ *              queued on its home worker with the deadline of this block.
+ *
+ * @param       stream      Index returned by StreamEngine::addStream()
+ * @param       left        getBlockLength() samples
+ * @param       right       getBlockLength() samples (ignored for mono streams, may be 0)
+ *
+ * @return      0, or -1 if the stream is unknown
+ * ======================================================
+ */
+int StreamEngine::submit(int stream, const int16_t* left, const int16_t* right) {
+    if (stream < 0 || stream >= _numStreams.load()) {
+        return -1;
+    }
+    Stream* s = _streams[stream];
+    Job* job = 0;
+    {
+        std::lock_guard<std::mutex> guard(s->lock);
+        if (!s->spare.empty()) {
+            job = s->spare.back();
+            s->spare.pop_back();
+        }
+    }
+    if (!job) {
+        job = new Job;
+        job->left = new int16_t[_blockLength];
+        job->right = s->stereo ? new int16_t[_blockLength] : 0;
+    }
+    for (int i = 0; i < _blockLength; i++) {
+        job->left[i] = left[i];
+    }
+    if (s->stereo) {
+        for (int i = 0; i < _blockLength; i++) {
+            job->right[i] = right ? right[i] : left[i];
+        }
+    }
+    job->submitUs = now();
+    job->deadlineUs = job->submitUs + s->deadlineUs;
+    _outstanding.fetch_add(1);
+    bool schedule;
+    {
+        std::lock_guard<std::mutex> guard(s->lock);
+        s->pending.push_back(job);
+        schedule = !s->queued;
+        s->queued = true;
+    }
+    if (schedule) {
+        Task task = {job->deadlineUs, stream};
+        pushTask(s->home, task);
+    }
+    return 0;
+}
+
+/** Puts a runnable stream in the queue of a worker and wakes a sleeping worker */
+void StreamEngine::pushTask(int worker, const Task& task) {
+    {
+        std::lock_guard<std::mutex> guard(_workers[worker]->lock);
+        std::vector<Task>& heap = _workers[worker]->heap;
+        heap.push_back(task);
+        std::push_heap(heap.begin(), heap.end(), laterDeadline);
+        _queuedTasks.fetch_add(1);
+    }
+    // Taking the lock orders this with a worker that is about to sleep
+    {
+        std::lock_guard<std::mutex> guard(_sleepLock);
+    }
+    _wake.notify_one();
+}
+
+/** ====================================================
+ * @brief       Takes the most urgent runnable stream.
+ *
+ * @details     From the worker's own queue if it has any, otherwise from the
+ *              queue of the worker whose most urgent stream has the earliest
+ *              deadline.
+ *
+ * @param       worker      Index of the worker
+ * @param       task        Filled with the stream to run
+ *
+ * @return      false if every queue is empty
+ * ======================================================
+ */
+bool StreamEngine::takeTask(int worker, Task& task) {
+    for (int attempt = 0; ; attempt = 1) {
+        int victim = worker;
+        if (attempt == 1) {
+            // Steal: find the earliest deadline among the other queues
+            victim = -1;
+            long long best = 0;
+            for (int w = 0; w < _threads; w++) {
+                if (w == worker) {
+                    continue;
+                }
+                std::lock_guard<std::mutex> guard(_workers[w]->lock);
+                const std::vector<Task>& heap = _workers[w]->heap;
+                if (!heap.empty() && (victim < 0 || heap.front().deadlineUs < best)) {
+                    victim = w;
+                    best = heap.front().deadlineUs;
+                }
+            }
+            if (victim < 0) {
+                return false;
+            }
+        }
+        std::lock_guard<std::mutex> guard(_workers[victim]->lock);
+        std::vector<Task>& heap = _workers[victim]->heap;
+        if (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), laterDeadline);
+            task = heap.back();
+            heap.pop_back();
+            _queuedTasks.fetch_sub(1);
+            if (victim != worker) {
+                _steals.fetch_add(1, std::memory_order_relaxed);
+            }
+            return true;
+        }
+        // The victim was emptied in the meantime: look again while there is work
+        if (attempt == 1 && _queuedTasks.load() == 0) {
+            return false;
+        }
+    }
+}
+
+/** Corrects the oldest block of a stream, calls it back and requeues the stream if needed */
+void StreamEngine::runJob(int worker, Task& task) {
+    Stream* s = _streams[task.stream];
+    Job* job;
+    {
+        std::lock_guard<std::mutex> guard(s->lock);
+        job = s->pending.front();
+    }
+    s->corrector->process(job->left, s->stereo ? job->right : 0, job->frame);
+    long long done = now();
+    if (_callback) {
+        _callback(task.stream, job->left, s->stereo ? job->right : 0, job->frame, _user);
+    }
+    _latency.add((long)(done - job->submitUs));
+    _blocks.fetch_add(1, std::memory_order_relaxed);
+    if (done > job->deadlineUs) {
+        _missed.fetch_add(1, std::memory_order_relaxed);
+    }
+    bool requeue = false;
+    Task next;
+    {
+        std::lock_guard<std::mutex> guard(s->lock);
+        s->pending.pop_front();
+        s->spare.push_back(job);
+        if (s->pending.empty()) {
+            s->queued = false;
+        } else {
+            requeue = true;
+            next.deadlineUs = s->pending.front()->deadlineUs;
+            next.stream = task.stream;
+        }
+    }
+    if (requeue) {
+        // Stay on this worker, whose cache holds the state of the stream
+        pushTask(worker, next);
+    }
+    if (_outstanding.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> guard(_sleepLock);
+        _drained.notify_all();
+    }
+}
+
+/** Loop of a worker thread */
+void StreamEngine::run(int worker) {
+    for (;;) {
+        Task task;
+        if (takeTask(worker, task)) {
+            runJob(worker, task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(_sleepLock);
+        while (_queuedTasks.load() == 0 && !_stopping) {
+            _wake.wait(lock);
+        }
+        if (_stopping && _queuedTasks.load() == 0) {
+            return;
+        }
+    }
+}
+
+/** Waits until every submitted block has been called back */
+void StreamEngine::drain() {
+    std::unique_lock<std::mutex> lock(_sleepLock);
+    while (_outstanding.load() != 0) {
+        _drained.wait(lock);
+    }
+}
+
+/** ====================================================
+ * @brief       Reads the telemetry gathered since StreamEngine::resetStats().
+ *
+ * @param       stats       Filled with the throughput, latency percentiles, misses and steals
+ * ======================================================
+ */
+void StreamEngine::getStats(EngineStats& stats) const {
+    stats.blocks = _blocks.load();
+    stats.seconds = (now() - _statsStartUs.load())/1e6;
+    stats.blocksPerSecond = (stats.seconds > 0) ? stats.blocks/stats.seconds : 0;
+    stats.samplesPerSecond = stats.blocksPerSecond*_blockLength;
+    stats.p50Us = _latency.percentile(0.50);
+    stats.p95Us = _latency.percentile(0.95);
+    stats.p99Us = _latency.percentile(0.99);
+    stats.p999Us = _latency.percentile(0.999);
+    stats.maxUs = _latency.max();
+    stats.missed = _missed.load();
+    stats.steals = _steals.load();
+}
+
+/** Clears the telemetry and restarts the throughput clock */
+void StreamEngine::resetStats() {
+    _latency.reset();
+    _blocks.store(0);
+    _missed.store(0);
+    _steals.store(0);
+    _statsStartUs.store(now());
+}
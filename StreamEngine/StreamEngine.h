@@ -0,0 +1,145 @@
+//
+//  StreamEngine.h
+//
+//
+//  Corrects many independent voice streams at once: per-stream PitchCorrector
+//  state, block jobs scheduled earliest deadline first on a work-stealing
+//  thread pool, throughput and tail latency telemetry (host only).
+//
+//
+
+#ifndef ____StreamEngine__
+#define ____StreamEngine__
+
+#include <stdio.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "PitchCorrect.h"
+
+#define MAX_ENGINE_STREAMS          256
+#define MAX_ENGINE_THREADS          64
+#define LATENCY_SUB_BUCKETS         8       // buckets per power of two (12% resolution)
+#define LATENCY_BUCKETS             (32*LATENCY_SUB_BUCKETS)
+
+// Called on a worker thread with each corrected block, in order within a stream
+typedef void (*BlockCallback)(int stream, const int16_t* left, const int16_t* right, const PitchFrame& frame, void* user);
+
+// Aggregate telemetry of the engine since the last StreamEngine::resetStats()
+struct EngineStats {
+    long blocks;                // blocks corrected
+    double seconds;             // wall time
+    double blocksPerSecond;
+    double samplesPerSecond;    // per channel
+    long p50Us;                 // submit to callback latency percentiles
+    long p95Us;
+    long p99Us;
+    long p999Us;
+    long maxUs;
+    long missed;                // blocks finished past their deadline
+    long steals;                // streams taken from the queue of another worker
+};
+
+// Lock-free latency histogram with log-linear buckets
+class LatencyHistogram {
+public:
+    LatencyHistogram() { reset(); }
+    void add(long us);
+    void reset();
+    long count() const;
+    // Upper bound of the bucket holding the given fraction (0 to 1) of the samples
+    long percentile(double fraction) const;
+    long max() const { return _max.load(); }
+
+private:
+    static int bucketOf(long us);
+    static long upperBound(int bucket);
+    std::atomic<long> _buckets[LATENCY_BUCKETS];
+    std::atomic<long> _max;
+};
+
+class StreamEngine {
+public:
+    // threads = 0: one per core. Every stream works on blocks of blockLength samples
+    StreamEngine(int threads = 0, int blockLength = DEFAULT_CORRECT_BLOCK_LENGTH, int levels = DEFAULT_CORRECT_LEVELS);
+    // Finishes the submitted blocks and stops the workers
+    ~StreamEngine();
+    void setCallback(BlockCallback callback, void* user);
+    // deadlineUs = time from submission to callback (0 = one block period). Returns the stream, or -1
+    int addStream(long fs, bool stereo, long deadlineUs = 0);
+    // Key, auto key... of a stream; only touch it while none of its blocks are pending
+    PitchCorrector* getCorrector(int stream);
+    // Queues a block (copied) of a stream. Returns 0, or -1 for an unknown stream
+    int submit(int stream, const int16_t* left, const int16_t* right);
+    // Blocks of a stream submitted but not called back yet
+    int getPending(int stream);
+    // Waits until every submitted block has been called back
+    void drain();
+    void getStats(EngineStats& stats) const;
+    void resetStats();
+    int getThreads() const { return _threads; }
+    int getBlockLength() const { return _blockLength; }
+
+private:
+    struct Job {
+        int16_t* left;
+        int16_t* right;
+        PitchFrame frame;
+        long long submitUs;
+        long long deadlineUs;
+    };
+    struct Stream {
+        PitchCorrector* corrector;
+        bool stereo;
+        long deadlineUs;
+        int home;                   // worker whose queue the stream goes to
+        std::mutex lock;            // guards pending, spare and queued
+        std::deque<Job*> pending;
+        std::vector<Job*> spare;
+        bool queued;                // in a run queue or running: at most one job of a stream runs
+    };
+    // A runnable stream, ordered by the deadline of its oldest block
+    struct Task {
+        long long deadlineUs;
+        int stream;
+    };
+    struct Worker {
+        std::mutex lock;
+        std::vector<Task> heap;     // min-heap on deadlineUs
+        std::thread thread;
+    };
+
+    static bool laterDeadline(const Task& a, const Task& b);
+    void run(int worker);
+    bool takeTask(int worker, Task& task);
+    void pushTask(int worker, const Task& task);
+    void runJob(int worker, Task& task);
+    long long now() const;
+
+    int _threads;
+    int _blockLength;
+    int _levels;
+    BlockCallback _callback;
+    void* _user;
+    Stream* _streams[MAX_ENGINE_STREAMS];
+    std::atomic<int> _numStreams;
+    std::mutex _addLock;
+    Worker* _workers[MAX_ENGINE_THREADS];
+    std::atomic<long> _queuedTasks;         // tasks in the run queues
+    std::atomic<long> _outstanding;         // blocks submitted and not called back
+    std::mutex _sleepLock;
+    std::condition_variable _wake;
+    std::condition_variable _drained;
+    bool _stopping;
+    // Telemetry
+    LatencyHistogram _latency;
+    std::atomic<long> _blocks;
+    std::atomic<long> _missed;
+    std::atomic<long> _steals;
+    std::atomic<long long> _statsStartUs;
+};
+
+#endif /* defined(____StreamEngine__) */
@@ -0,0 +1,155 @@
+//
+//  main.cpp
+//
+//
+//  Runs many streams (rotated copies of a recording, in different keys)
+//  through a StreamEngine, checks that every stream comes out exactly as
+//  through its own serial PitchCorrector, and prints throughput and latency,
+//  first as fast as possible, then paced in real time.
+//  Build: g++ -std=c++11 -O2 -mssse3 -pthread -I../FLWT -I../Profiler -I../CostModel -I../Arena -I../PSOLA -I../FixedPoint -I../Frequency -I../KeyDetector
+//         -I../WavFile -I../PitchTrack -I../PitchCorrect main.cpp StreamEngine.cpp ../PitchCorrect/PitchCorrect.cpp
+//         ../PitchTrack/PitchTrack.cpp ../FLWT/FLWT.cpp ../PSOLA/PSOLA.cpp ../Frequency/Frequency.cpp
+//         ../KeyDetector/KeyDetector.cpp ../WavFile/WavFile.cpp
+//  Usage: a.out [streams] [threads] [file.wav]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "StreamEngine.h"
+#include <iostream>
+#include <chrono>
+
+using namespace std;
+
+const char* defaultPath = "../Version Final/FinalDemo/cscalesinging.wav";
+int blockLength = DEFAULT_CORRECT_BLOCK_LENGTH;
+int maxPending = 8;             // blocks a stream may have queued in the flood test
+int realTimeBlocks = 200;       // blocks per stream in the paced test
+
+// Signature of the output of each block of each stream
+struct Check {
+    unsigned long* expected;
+    long next;
+    long errors;
+};
+Check checks[MAX_ENGINE_STREAMS];
+
+unsigned long hashBlock(const int16_t* left, const int16_t* right, const PitchFrame& frame) {
+    unsigned long h = 2166136261UL;
+    for (int i = 0; i < blockLength; i++) {
+        h = (h ^ (unsigned long)left[i]) * 16777619UL;
+        if (right) {
+            h = (h ^ (unsigned long)right[i]) * 16777619UL;
+        }
+    }
+    return h ^ (unsigned long)(frame.pitch*100);
+}
+
+// The blocks of a stream are called back one at a time and in order
+void onBlock(int stream, const int16_t* left, const int16_t* right, const PitchFrame& frame, void*) {
+    Check& check = checks[stream];
+    if (check.expected && hashBlock(left, right, frame) != check.expected[check.next]) {
+        check.errors++;
+    }
+    check.next++;
+}
+
+// Block b of stream s: the recording rotated by s seconds
+void streamBlock(const MappedWav& wav, int s, long b, int16_t* left, int16_t* right) {
+    long blocks = wav.getFrames()/blockLength;
+    long start = ((b + s*wav.getSampleRate()/blockLength) % blocks)*blockLength;
+    wav.read(start, left, right, blockLength);
+}
+
+void configure(PitchCorrector* corrector, int s) {
+    if (s % 4 == 3) {
+        corrector->setAutoKey(true);
+    } else {
+        corrector->setScale(A_SCALE + (s % 12), (s & 1) ? MINOR_SCALE : MAJOR_SCALE);
+    }
+}
+
+void printStats(const char* name, StreamEngine& engine, long fs) {
+    EngineStats stats;
+    engine.getStats(stats);
+    printf("%s: %ld blocks in %.2f s, %.0f blocks/s (%.0fx real time in total)\n",
+           name, stats.blocks, stats.seconds, stats.blocksPerSecond, stats.samplesPerSecond/fs);
+    printf("    latency p50=%ldus p95=%ldus p99=%ldus p99.9=%ldus max=%ldus, %ld missed deadlines, %ld steals\n",
+           stats.p50Us, stats.p95Us, stats.p99Us, stats.p999Us, stats.maxUs, stats.missed, stats.steals);
+}
+
+int main(int argc, char** argv) {
+    cout<<endl<<"StreamEngine Testing: "<<endl<<endl;
+    int numStreams = (argc > 1) ? atoi(argv[1]) : 16;
+    int threads = (argc > 2) ? atoi(argv[2]) : 0;
+    const char* path = (argc > 3) ? argv[3] : defaultPath;
+    MappedWav wav;
+    if (wav.open(path) || numStreams < 1 || numStreams > MAX_ENGINE_STREAMS) {
+        printf("usage: %s [streams] [threads] [file.wav]\n", argv[0]);
+        return 1;
+    }
+    long blocks = wav.getFrames()/blockLength;
+    int16_t* left = new int16_t[blockLength];
+    int16_t* right = new int16_t[blockLength];
+
+    // Reference: every stream through its own PitchCorrector
+    for (int s = 0; s < numStreams; s++) {
+        checks[s].expected = new unsigned long[blocks + realTimeBlocks];
+        PitchCorrector corrector(wav.getSampleRate(), blockLength);
+        configure(&corrector, s);
+        for (long b = 0; b < blocks + realTimeBlocks; b++) {
+            PitchFrame frame;
+            streamBlock(wav, s, b, left, right);
+            corrector.process(left, right, frame);
+            checks[s].expected[b] = hashBlock(left, right, frame);
+        }
+    }
+
+    long errors = 0;
+    {
+        StreamEngine engine(threads, blockLength);
+        engine.setCallback(onBlock, 0);
+        for (int s = 0; s < numStreams; s++) {
+            engine.addStream(wav.getSampleRate(), true);
+            configure(engine.getCorrector(s), s);
+        }
+        printf("%d streams at %ld Hz, %d threads\n", numStreams, wav.getSampleRate(), engine.getThreads());
+
+        // Flood: every stream keeps up to maxPending blocks queued
+        engine.resetStats();
+        for (long b = 0; b < blocks; b++) {
+            for (int s = 0; s < numStreams; s++) {
+                while (engine.getPending(s) >= maxPending) {
+                    this_thread::yield();
+                }
+                streamBlock(wav, s, b, left, right);
+                engine.submit(s, left, right);
+            }
+        }
+        engine.drain();
+        printStats("flood", engine, wav.getSampleRate());
+
+        // Real time: one block per stream every block period
+        engine.resetStats();
+        chrono::microseconds period((long)blockLength*1000000/wav.getSampleRate());
+        chrono::steady_clock::time_point tick = chrono::steady_clock::now();
+        for (long b = blocks; b < blocks + realTimeBlocks; b++) {
+            for (int s = 0; s < numStreams; s++) {
+                streamBlock(wav, s, b, left, right);
+                engine.submit(s, left, right);
+            }
+            tick += period;
+            this_thread::sleep_until(tick);
+        }
+        engine.drain();
+        printStats("real time", engine, wav.getSampleRate());
+    }
+    for (int s = 0; s < numStreams; s++) {
+        errors += checks[s].errors + (checks[s].next != blocks + realTimeBlocks);
+        delete[] checks[s].expected;
+    }
+    delete[] left;
+    delete[] right;
+    printf("per-stream output %s\n", errors ? "DIFFERS from the serial run: FAIL" : "identical to the serial run: PASS");
+    return errors ? 1 : 0;
+}
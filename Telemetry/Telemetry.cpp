@@ -0,0 +1,368 @@
+/**
+ *   @mainpage Per-Frame Telemetry
+ *
+ *   \section desc_sec Description
+ *   Records what the processing did with every frame (detected pitch, the
+ *      pitch and key it was corrected to, the FLWT level that found the
+ *      pitch, the quality level and the time spent detecting, quantizing
+ *      and correcting) so that the behavior of a real performance can be
+ *      looked at afterwards in every mode, not only in PITCH_DETECT.
+ *
+ *  @n The audio path only copies a TelemetryFrame into a TelemetryRing, a
+ *      single-producer/single-consumer ring like AudioRing. It never waits:
+ *      when the consumer falls behind, frames are dropped and counted. A
+ *      consumer outside of the audio path (loop() on the C5535, a thread of
+ *      TelemetryLog on the host) drains the ring into a binary log.
+ *
+ *  @n The log starts with an 8 byte header ("PVTL", version, record size)
+ *      followed by one 22 byte little endian record per frame:
+ *
+ *      <ol>
+ *         <li> frame number (32 bits)
+ *         <li> mode, quality (8 bits each)
+ *         <li> pitch, target in hundredths of Hz (32 bits each)
+ *         <li> key, level (8 bits each)
+ *         <li> detect, quantize and correct time in us (16 bits each, saturated)
+ *      </ol>
+ *
+ *  @n The record is built one byte at a time so that it comes out the same
+ *      on the C5535 (16-bit char) as on the host, and the pitches are fixed
+ *      point because the two do not share a float layout to copy.
+ *
+ *  \section contents_sec Table of Contents
+ *    Telemetry.cpp
+ *
+ *    Telemetry.h
+ *
+ *    main.cpp
+ *
+ */
+
+/**
+ *  @file Telemetry.cpp
+ *  @brief Source file for TelemetryRing and TelemetryLog
+ *  @file Telemetry.h
+ *  @brief Header file for TelemetryRing and TelemetryLog
+ */
+
+#include "Telemetry.h"
+#if __cplusplus >= 201103L
+#include <chrono>
+#endif
+
+/** ==============================================================================
+ * @brief       Allocates the ring.
+ *
+ * @param       depth           Number of frames the ring can hold
+ * ================================================================================
+ */
+TelemetryRing::TelemetryRing(int depth) {
+    // Error Handle
+    if (depth < 1) {
+        depth = DEFAULT_TELEMETRY_DEPTH;
+    }
+    _slots = depth + 1;
+    _frames = new TelemetryFrame[_slots];
+    TELEMETRY_STORE(_head, 0);
+    TELEMETRY_STORE(_tail, 0);
+    _dropped = 0;
+}
+
+/** Standard destructor */
+TelemetryRing::~TelemetryRing() {
+    delete[] _frames;
+}
+
+/** ====================================================
+ * @brief       Queues a frame (producer side).
+ *
+ * @param       frame       Frame to copy into the ring
+ *
+ * @return      0, or -1 if the ring was full and the frame was dropped
+ * ======================================================
+ */
+int TelemetryRing::push(const TelemetryFrame& frame) {
+    int head = TELEMETRY_LOAD(_head);
+    if (next(head) == TELEMETRY_LOAD(_tail)) {
+        _dropped++;
+        return -1;
+    }
+    _frames[head] = frame;
+    TELEMETRY_STORE(_head, next(head));
+    return 0;
+}
+
+/** ====================================================
+ * @brief       Takes the oldest frame (consumer side).
+ *
+ * @param       frame       Receives the frame
+ *
+ * @return      0, or -1 if the ring is empty
+ * ======================================================
+ */
+int TelemetryRing::pop(TelemetryFrame& frame) {
+    int tail = TELEMETRY_LOAD(_tail);
+    if (tail == TELEMETRY_LOAD(_head)) {
+        return -1;
+    }
+    frame = _frames[tail];
+    TELEMETRY_STORE(_tail, next(tail));
+    return 0;
+}
+
+/** Number of frames waiting to be popped */
+int TelemetryRing::count() const {
+    int n = TELEMETRY_LOAD(_head) - TELEMETRY_LOAD(_tail);
+    return (n < 0) ? n + _slots : n;
+}
+
+static int putBytes(unsigned char* out, unsigned long value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out[i] = (unsigned char)((value >> (8*i)) & 0xFF);
+    }
+    return bytes;
+}
+
+static unsigned long getBytes(const unsigned char* in, int bytes) {
+    unsigned long value = 0;
+    for (int i = bytes - 1; i >= 0; i--) {
+        value = (value << 8) | (in[i] & 0xFF);
+    }
+    return value;
+}
+
+static unsigned long saturate(unsigned long value, unsigned long max) {
+    return (value > max) ? max : value;
+}
+
+static unsigned long toCentiHz(float hz) {
+    return (hz > 0) ? (unsigned long)(hz*100 + 0.5) : 0;
+}
+
+/** ====================================================
+ * @brief       Encodes the header of a log.
+ *
+ * @param       out         TELEMETRY_HEADER_BYTES bytes
+ *
+ * @return      Number of bytes written
+ * ======================================================
+ */
+int encodeTelemetryHeader(unsigned char* out) {
+    out[0] = 'P';
+    out[1] = 'V';
+    out[2] = 'T';
+    out[3] = 'L';
+    putBytes(out + 4, TELEMETRY_VERSION, 2);
+    putBytes(out + 6, TELEMETRY_RECORD_BYTES, 2);
+    return TELEMETRY_HEADER_BYTES;
+}
+
+/** ====================================================
+ * @brief       Encodes one frame as a log record.
+ *
+ * @param       frame       Frame to encode
+ * @param       out         TELEMETRY_RECORD_BYTES bytes
+ *
+ * @return      Number of bytes written
+ * ======================================================
+ */
+int encodeTelemetryFrame(const TelemetryFrame& frame, unsigned char* out) {
+    int n = 0;
+    n += putBytes(out + n, frame.frame & 0xFFFFFFFFUL, 4);
+    n += putBytes(out + n, saturate(frame.mode, 255), 1);
+    n += putBytes(out + n, saturate(frame.quality, 255), 1);
+    n += putBytes(out + n, toCentiHz(frame.pitch), 4);
+    n += putBytes(out + n, toCentiHz(frame.target), 4);
+    n += putBytes(out + n, saturate(frame.key, 255), 1);
+    n += putBytes(out + n, saturate(frame.level, 255), 1);
+    n += putBytes(out + n, saturate(frame.detectUs, TELEMETRY_MAX_US), 2);
+    n += putBytes(out + n, saturate(frame.quantizeUs, TELEMETRY_MAX_US), 2);
+    n += putBytes(out + n, saturate(frame.correctUs, TELEMETRY_MAX_US), 2);
+    return n;
+}
+
+/** Checks the header of a log, returns 0 if it can be read */
+int decodeTelemetryHeader(const unsigned char* in) {
+    if (in[0] != 'P' || in[1] != 'V' || in[2] != 'T' || in[3] != 'L') {
+        return -1;
+    }
+    if (getBytes(in + 4, 2) != TELEMETRY_VERSION || getBytes(in + 6, 2) != TELEMETRY_RECORD_BYTES) {
+        return -1;
+    }
+    return 0;
+}
+
+/** Decodes a record written by encodeTelemetryFrame() */
+void decodeTelemetryFrame(const unsigned char* in, TelemetryFrame& frame) {
+    frame.frame = getBytes(in, 4);
+    frame.mode = (int)getBytes(in + 4, 1);
+    frame.quality = (int)getBytes(in + 5, 1);
+    frame.pitch = getBytes(in + 6, 4)/100.0f;
+    frame.target = getBytes(in + 10, 4)/100.0f;
+    frame.key = (int)getBytes(in + 14, 1);
+    frame.level = (int)getBytes(in + 15, 1);
+    frame.detectUs = getBytes(in + 16, 2);
+    frame.quantizeUs = getBytes(in + 18, 2);
+    frame.correctUs = getBytes(in + 20, 2);
+}
+
+/** Standard constructor */
+TelemetryLog::TelemetryLog() {
+    _file = 0;
+    _records = 0;
+#if __cplusplus >= 201103L
+    _ring = 0;
+    _running = false;
+#endif
+}
+
+/** Standard destructor */
+TelemetryLog::~TelemetryLog() {
+    close();
+}
+
+/** ====================================================
+ * @brief       Creates a log.
+ *
+ * @param       path        File to write
+ *
+ * @return      0 on success, -1 if the file cannot be written
+ * ======================================================
+ */
+int TelemetryLog::open(const char* path) {
+    close();
+    _file = fopen(path, "wb");
+    if (!_file) {
+        return -1;
+    }
+    unsigned char header[TELEMETRY_HEADER_BYTES];
+    encodeTelemetryHeader(header);
+    fwrite(header, 1, TELEMETRY_HEADER_BYTES, _file);
+    _records = 0;
+    return 0;
+}
+
+/** Stops the background drain and closes the log */
+void TelemetryLog::close() {
+#if __cplusplus >= 201103L
+    stop();
+#endif
+    if (_file) {
+        fclose(_file);
+        _file = 0;
+    }
+}
+
+/** ====================================================
+ * @brief       Writes every queued frame to the log (consumer side).
+ *
+ * @param       ring        Ring to drain
+ *
+ * @return      Number of frames written
+ * ======================================================
+ */
+int TelemetryLog::drain(TelemetryRing& ring) {
+    TelemetryFrame frame;
+    unsigned char record[TELEMETRY_RECORD_BYTES];
+    int written = 0;
+    while (ring.pop(frame) == 0) {
+        if (_file) {
+            encodeTelemetryFrame(frame, record);
+            fwrite(record, 1, TELEMETRY_RECORD_BYTES, _file);
+            written++;
+        }
+    }
+    _records += written;
+    return written;
+}
+
+#if __cplusplus >= 201103L
+/** ====================================================
+ * @brief       Drains a ring into the log on a background thread.
+ *
+ * @details     The thread is the only consumer of the ring until
+ *              TelemetryLog::stop().
+ *
+ * @param       ring        Ring to drain
+ * @param       periodMs    Time between two drains
+ *
+ * @return      0, or -1 if the log is not open or already draining
+ * ======================================================
+ */
+int TelemetryLog::start(TelemetryRing* ring, int periodMs) {
+    if (!_file || _running) {
+        return -1;
+    }
+    _ring = ring;
+    _running = true;
+    _thread = std::thread([this, periodMs]() {
+        while (_running) {
+            drain(*_ring);
+            std::this_thread::sleep_for(std::chrono::milliseconds(periodMs));
+        }
+        drain(*_ring);
+    });
+    return 0;
+}
+
+/** Drains what is left and stops the background thread */
+void TelemetryLog::stop() {
+    if (_thread.joinable()) {
+        _running = false;
+        _thread.join();
+    }
+    if (_file) {
+        fflush(_file);
+    }
+}
+#endif
+
+/** Standard constructor */
+TelemetryLogReader::TelemetryLogReader() {
+    _file = 0;
+}
+
+/** Standard destructor */
+TelemetryLogReader::~TelemetryLogReader() {
+    close();
+}
+
+/** ====================================================
+ * @brief       Opens a log written by TelemetryLog.
+ *
+ * @param       path        File to read
+ *
+ * @return      0 on success, -1 if it cannot be read or is not a telemetry log
+ * ======================================================
+ */
+int TelemetryLogReader::open(const char* path) {
+    close();
+    _file = fopen(path, "rb");
+    if (!_file) {
+        return -1;
+    }
+    unsigned char header[TELEMETRY_HEADER_BYTES];
+    if (fread(header, 1, TELEMETRY_HEADER_BYTES, _file) != TELEMETRY_HEADER_BYTES ||
+        decodeTelemetryHeader(header)) {
+        close();
+        return -1;
+    }
+    return 0;
+}
+
+void TelemetryLogReader::close() {
+    if (_file) {
+        fclose(_file);
+        _file = 0;
+    }
+}
+
+/** Reads the next frame, returns -1 at the end of the log */
+int TelemetryLogReader::read(TelemetryFrame& frame) {
+    unsigned char record[TELEMETRY_RECORD_BYTES];
+    if (!_file || fread(record, 1, TELEMETRY_RECORD_BYTES, _file) != TELEMETRY_RECORD_BYTES) {
+        return -1;
+    }
+    decodeTelemetryFrame(record, frame);
+    return 0;
+}
@@ -0,0 +1,109 @@
+//
+//  main.cpp
+//
+//
+//  Detects and quantizes the pitch of a WAV file frame by frame like the
+//  PHASE_VOCODER mode, queues the telemetry of every frame and logs it on a
+//  background thread, then reads the log back and checks it.
+//  Build: g++ -std=c++11 -O2 -pthread -I../FLWT -I../Profiler -I../CostModel -I../Arena -I../Frequency -I../WavFile main.cpp Telemetry.cpp
+//         ../FLWT/FLWT.cpp ../Frequency/Frequency.cpp ../WavFile/WavFile.cpp
+//  Usage: a.out [file.wav] [log]
+//
+
+#include <stdio.h>
+#include "Telemetry.h"
+#include "FLWT.h"
+#include "Frequency.h"
+#include "WavFile.h"
+#include <iostream>
+#include <chrono>
+
+using namespace std;
+
+const char* defaultPath = "../Version Final/FinalDemo/cscalesinging.wav";
+const char* defaultLog = "telemetry.bin";
+const int blockLength = 512;
+const int levels = 6;
+
+unsigned long microsSince(chrono::steady_clock::time_point start) {
+    return (unsigned long)chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    cout<<endl<<"Telemetry Testing: "<<endl<<endl;
+    const char* path = (argc > 1) ? argv[1] : defaultPath;
+    const char* logPath = (argc > 2) ? argv[2] : defaultLog;
+    WavReader wav;
+    if (wav.open(path)) {
+        printf("cannot read %s\n", path);
+        return 1;
+    }
+    TelemetryRing ring;
+    TelemetryLog log;
+    if (log.open(logPath) || log.start(&ring, 5)) {
+        printf("cannot write %s\n", logPath);
+        return 1;
+    }
+
+    FLWT flwt(levels, blockLength);
+    Frequency f;
+    int block[blockLength];
+    float pitches[4096];
+    unsigned long frames = 0;
+    while (wav.read(block, 0, blockLength) == blockLength && frames < 4096) {
+        TelemetryFrame frame;
+        frame.frame = frames;
+        frame.mode = 1;
+        frame.quality = 0;
+        frame.key = 0;
+        frame.target = 0;
+        frame.quantizeUs = 0;
+        frame.correctUs = 0;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        frame.pitch = flwt.getPitchWithMedian5(block, blockLength, wav.getSampleRate());
+        frame.level = flwt.getFoundLevel();
+        frame.detectUs = microsSince(start);
+        if (frame.pitch) {
+            start = chrono::steady_clock::now();
+            frame.key = f.getClosestKeyNumInScale(frame.pitch, C_SCALE, MAJOR_SCALE);
+            frame.target = f.getFreqOfKeyNum(frame.key);
+            frame.quantizeUs = microsSince(start);
+        }
+        pitches[frames++] = frame.pitch;
+        // Producer side: never waits on the logger
+        ring.push(frame);
+        // Pace like a slow audio callback so the logger keeps up
+        this_thread::sleep_for(chrono::microseconds(200));
+    }
+    log.close();
+    printf("%lu frames, %ld logged, %ld dropped by the ring\n", frames, log.getRecords(), ring.getDropped());
+
+    TelemetryLogReader reader;
+    if (reader.open(logPath)) {
+        printf("cannot read back %s\n", logPath);
+        return 1;
+    }
+    long levelHistogram[levels + 1] = {0};
+    long records = 0;
+    long errors = 0;
+    long lastFrame = -1;
+    TelemetryFrame frame;
+    while (reader.read(frame) == 0) {
+        records++;
+        if ((long)frame.frame <= lastFrame || frame.frame >= frames ||
+            (long)(frame.pitch*100 + 0.5f) != (long)(pitches[frame.frame]*100 + 0.5f)) {
+            errors++;
+        }
+        lastFrame = frame.frame;
+        if (frame.level >= 0 && frame.level <= levels) {
+            levelHistogram[frame.level]++;
+        }
+    }
+    printf("read back %ld records, %ld bad\n", records, errors);
+    printf("pitch found at level:");
+    for (int l = 0; l <= levels; l++) {
+        printf(" %d=%ld", l, levelHistogram[l]);
+    }
+    printf(" (0 = pitchless)\n");
+    return errors ? 1 : 0;
+}
@@ -1094,7 +1094,7 @@ int AudioClass::write(void)
  *
  *  ===========================================================================
  */
-void AudioClass::attachIntr(void *function)
+void AudioClass::attachIntr(AudioIsr function)
 {
     attachInterrupt(INTERRUPT_DMA, (INTERRUPT_IsrPtr)function, 0);
     enableInterrupt(INTERRUPT_DMA);
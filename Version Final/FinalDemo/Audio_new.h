@@ -75,6 +75,9 @@ extern "C" {
 #define CHANNEL_MONO   (1)  /**< Macro to indicate the Channel type as Mono   */
 #define CHANNEL_STEREO (2)  /**< Macro to indicate the Channel type as Stereo */
 
+/** DMA interrupt service routine given to attachIntr() */
+typedef void (*AudioIsr)(void);
+
 /**
   * \brief Audio Class
   *
@@ -147,7 +150,7 @@ class AudioClass {
         /** Right sample */
         int sampleRight;
         int  close();
-        void attachIntr(void *function);
+        void attachIntr(AudioIsr function);
         void detachIntr(void);
         int  read(void);
         int  write(void);
@@ -0,0 +1,149 @@
+/**
+ *   @mainpage Lock-Free Control Plane
+ *
+ *   \section desc_sec Description
+ *   Carries the parameters the user controls (mode, key, reference pitch,
+ *      quality limit) from the command parser to the audio processing. The
+ *      parser publishes a complete ControlParams snapshot; the audio side
+ *      picks it up at the start of a block, so a block is always processed
+ *      with one consistent set of parameters and never with half of an
+ *      update (e.g. the scale of one command and the mode of the previous).
+ *
+ *  @n The snapshot is guarded by a sequence lock. The writer makes the
+ *      sequence odd, copies the parameters and makes it even again; the
+ *      reader copies the parameters and keeps them only if the sequence was
+ *      even and did not move meanwhile. A reader that meets a publish in
+ *      progress (e.g. the DMA interrupt preempting parse()) does not wait:
+ *      it keeps the snapshot it already has and gets the new one on the next
+ *      block. Neither side ever blocks, and when nothing changed the reader
+ *      costs one comparison per block.
+ *
+ *  @n A sequence lock was picked over swapping a pointer to an immutable
+ *      snapshot because the C5535 toolchain has no atomic exchange, and the
+ *      writer would need a pool of snapshots to know when an old one is no
+ *      longer being read. On the C5535 the interrupt and loop() share one
+ *      core, and a volatile sequence with volatile parameter fields keeps
+ *      the compiler from moving the copy out of the odd/even window; on a
+ *      host with C++11 the sequence and the fields are atomics with fences
+ *      so the control plane also works between threads.
+ *
+ *  \section contents_sec Table of Contents
+ *    ControlPlane.cpp
+ *
+ *    ControlPlane.h
+ *
+ *    main.cpp
+ *
+ */
+
+/**
+ *  @file ControlPlane.cpp
+ *  @brief Source file for ControlPlane
+ *  @file ControlPlane.h
+ *  @brief Header file for ControlPlane
+ */
+
+#include "ControlPlane.h"
+
+/** ==============================================================================
+ * @brief       Initializes the control plane with nothing published.
+ *
+ * @details     The parameters are zeroed; the first ControlPlane::acquire()
+ *              after the first ControlPlane::publish() returns them.
+ * ================================================================================
+ */
+ControlPlane::ControlPlane() {
+    _published.mode = 0;
+    _published.scale = 0;
+    _published.majorOrMinor = 0;
+    _published.autoKey = 0;
+    _published.referencePitch = 0;
+    _published.qualityLimit = 0;
+    store(_published);
+    CONTROL_STORE(_sequence, 0);
+    _acquired = 0;
+    _retries = 0;
+}
+
+/** ====================================================
+ * @brief       Publishes a new snapshot (writer side).
+ *
+ * @details     Only one writer may publish at a time.
+ *
+ * @param       params      The complete new set of parameters
+ * ======================================================
+ */
+void ControlPlane::publish(const ControlParams& params) {
+    unsigned sequence = CONTROL_LOAD(_sequence);
+    CONTROL_STORE(_sequence, sequence + 1);
+    CONTROL_FENCE();
+    store(params);
+    _published = params;
+    CONTROL_STORE(_sequence, sequence + 2);
+}
+
+/** ====================================================
+ * @brief       Picks up the current snapshot (reader side).
+ *
+ * @details     Call once at the start of every block. When nothing was
+ *              published since the last call, or a publish is in progress,
+ *              params is left alone.
+ *
+ * @param       params      Snapshot held by the reader, updated in place
+ *
+ * @return      1 if params changed, 0 otherwise
+ * ======================================================
+ */
+int ControlPlane::acquire(ControlParams& params) {
+    unsigned before = CONTROL_LOAD(_sequence);
+    if (before == _acquired) {
+        return 0;
+    }
+    if (before & 1) {
+        _retries++;
+        return 0;
+    }
+    ControlParams copy;
+    load(copy);
+    CONTROL_FENCE();
+    if (CONTROL_LOAD(_sequence) != before) {
+        _retries++;
+        return 0;
+    }
+    params = copy;
+    _acquired = before;
+    return 1;
+}
+
+/** ====================================================
+ * @brief       Copies params into the shared snapshot, field by field.
+ *
+ * @param       params      Parameters to share
+ * ======================================================
+ */
+void ControlPlane::store(const ControlParams& params) {
+    CONTROL_SET(_params.mode, params.mode);
+    CONTROL_SET(_params.scale, params.scale);
+    CONTROL_SET(_params.majorOrMinor, params.majorOrMinor);
+    CONTROL_SET(_params.autoKey, params.autoKey);
+    CONTROL_SET(_params.referencePitch, params.referencePitch);
+    CONTROL_SET(_params.qualityLimit, params.qualityLimit);
+}
+
+/** ====================================================
+ * @brief       Copies the shared snapshot into params, field by field.
+ *
+ * @details     The copy may be torn; ControlPlane::acquire() checks the
+ *              sequence before keeping it.
+ *
+ * @param       params      Receives the shared parameters
+ * ======================================================
+ */
+void ControlPlane::load(ControlParams& params) const {
+    params.mode = CONTROL_GET(_params.mode);
+    params.scale = CONTROL_GET(_params.scale);
+    params.majorOrMinor = CONTROL_GET(_params.majorOrMinor);
+    params.autoKey = CONTROL_GET(_params.autoKey);
+    params.referencePitch = CONTROL_GET(_params.referencePitch);
+    params.qualityLimit = CONTROL_GET(_params.qualityLimit);
+}
@@ -0,0 +1,192 @@
+/**
+ *   @mainpage Operation Count Cost Model
+ *
+ *   \section desc_sec Description
+ *   Estimates the cycles the C5535 spends on FLWT::getPitch(),
+ *      Frequency::getClosestKeyNumInScale() and PSOLA::pitchCorrect() from a
+ *      run on the host. Timing the host says little about the device: it has
+ *      an FPU and a 32 bit int, the C5535 has neither, so a float multiply
+ *      that is free on the host is a library call on the device.
+ *
+ *  @n The hot paths of these modules hold their data in CostInt, CostLong,
+ *      CostFloat and CostIntArray. Without PV_COST these are int, long,
+ *      float and int*, so the production build is unchanged. Built with
+ *      PV_COST defined (host only, C++11), they are wrappers that count every
+ *      operation they take part in into costCounts, by kind (add, multiply,
+ *      divide, compare and branch, per 16 bit, 32 bit and float operands),
+ *      plus integer/float conversions, library calls and array accesses.
+ *      The Q15 multiply of PSOLA is counted as the single 16x16 -> 32 bit
+ *      multiply the device does for it (costWideMul()).
+ *
+ *  @n The counts of a buffer times the cycles per operation of a CostTable
+ *      estimate the cycles of the buffer on that target, to be compared with
+ *      costBudget(), the cycles that the target has per buffer in real time.
+ *      Loop counters and array indices stay plain ints: the address units
+ *      and the zero overhead loops of the C55x take care of them.
+ *
+ *  @n The cycles per operation are rough figures from the instruction set
+ *      and the run-time support library of each target; calibrate them with
+ *      a profiled run on the board (see Profiler.h) before trusting more than
+ *      the first digit of an estimate. The estimate is best used to compare
+ *      two versions of a kernel.
+ *
+ *  \section contents_sec Table of Contents
+ *    CostModel.cpp
+ *
+ *    CostModel.h
+ *
+ *    main.cpp
+ *
+ */
+
+/**
+ *  @file CostModel.cpp
+ *  @brief Source file for the cost model
+ *  @file CostModel.h
+ *  @brief Header file for the cost model and the Cost* types
+ */
+
+#include "CostModel.h"
+
+#ifdef PV_COST
+/** Operations counted by the Cost* types */
+CostCounts costCounts;
+#endif
+
+/** Names of the COST_* operations */
+static const char* const opNames[COST_NUM_OPS] = {
+    "add 16", "add 32", "float add",
+    "multiply 16", "multiply 32", "float multiply",
+    "divide 16", "divide 32", "float divide",
+    "branch 16", "branch 32", "float branch",
+    "int <-> float", "library call", "memory"
+};
+
+/** ====================================================
+ * @brief       C5535 at 100 MHz.
+ *
+ * @details     The ALU and the MAC units do 16 bit (and, with the 40 bit
+ *              accumulators, 32 bit) adds and 16x16 multiplies in a cycle,
+ *              but a 32 bit multiply, every divide and every float operation
+ *              is a call into the run-time support library. A taken branch
+ *              flushes part of the pipeline.
+ * ======================================================
+ */
+const CostTable costTableC5535 = {
+    "C5535", 100e6,
+    {
+        1, 1, 60,       // add
+        1, 10, 50,      // multiply
+        25, 80, 150,    // divide
+        4, 4, 30,       // compare and branch
+        35,             // int <-> float
+        100,            // floor() and the like on floats
+        1               // memory
+    }
+};
+
+/** Cortex-M4F at 100 MHz: 32 bit int, single precision FPU, hardware divide */
+const CostTable costTableCortexM4F = {
+    "Cortex-M4F", 100e6,
+    {
+        1, 1, 1,        // add
+        1, 1, 1,        // multiply
+        7, 7, 14,       // divide
+        3, 3, 4,        // compare and branch
+        1,              // int <-> float
+        10,             // floor() and the like on floats
+        2               // memory
+    }
+};
+
+/** Clears the counts */
+void CostCounts::reset() {
+    for (int op = 0; op < COST_NUM_OPS; op++) {
+        ops[op] = 0;
+    }
+}
+
+/** Adds other to the counts */
+void CostCounts::add(const CostCounts& other) {
+    for (int op = 0; op < COST_NUM_OPS; op++) {
+        ops[op] += other.ops[op];
+    }
+}
+
+/** Number of operations of every kind */
+unsigned long CostCounts::getTotal() const {
+    unsigned long total = 0;
+    for (int op = 0; op < COST_NUM_OPS; op++) {
+        total += ops[op];
+    }
+    return total;
+}
+
+/** Name of a COST_* operation */
+const char* costOpName(int op) {
+    return (op >= 0 && op < COST_NUM_OPS) ? opNames[op] : "?";
+}
+
+/** ====================================================
+ * @brief       Estimates the cycles of some operations on a target.
+ *
+ * @param       counts      Operations
+ * @param       target      Cycles per operation
+ *
+ * @return      Cycles
+ * ======================================================
+ */
+double costCycles(const CostCounts& counts, const CostTable& target) {
+    double cycles = 0;
+    for (int op = 0; op < COST_NUM_OPS; op++) {
+        cycles += counts.ops[op]*target.cycles[op];
+    }
+    return cycles;
+}
+
+/** ====================================================
+ * @brief       Cycles a target has to process a buffer in real time.
+ *
+ * @param       target      Target (its clock rate)
+ * @param       samples     Samples in the buffer
+ * @param       fs          Sampling frequency
+ *
+ * @return      Cycles, 0 if fs is not positive
+ * ======================================================
+ */
+double costBudget(const CostTable& target, long samples, long fs) {
+    // Error Handle
+    if (fs <= 0) {
+        return 0;
+    }
+    return target.clockHz*samples/fs;
+}
+
+/** ====================================================
+ * @brief       Prints the operations and their estimated cycles.
+ *
+ * @param       out         Where to print
+ * @param       title       First line
+ * @param       counts      Operations of units units
+ * @param       target      Cycles per operation
+ * @param       units       Number of units (e.g. buffers) counts are spread over
+ * @param       unitName    Name of a unit
+ * ======================================================
+ */
+void costPrint(FILE* out, const char* title, const CostCounts& counts, const CostTable& target,
+               long units, const char* unitName) {
+    // Error Handle
+    if (units < 1) {
+        units = 1;
+    }
+    double total = costCycles(counts, target);
+    fprintf(out, "%s: %.0f %s cycles per %s\n", title, total/units, target.name, unitName);
+    for (int op = 0; op < COST_NUM_OPS; op++) {
+        if (!counts.ops[op]) {
+            continue;
+        }
+        double cycles = counts.ops[op]*target.cycles[op];
+        fprintf(out, "  %-16s %12.1f ops %12.0f cycles %5.1f%%\n", opNames[op], (double)counts.ops[op]/units,
+                cycles/units, total ? 100*cycles/total : 0.0);
+    }
+}
@@ -0,0 +1,274 @@
+//
+//  CostModel.h
+//
+//
+//  Operation counts of the fixed point kernels, to estimate their cycles on
+//  the device from a host run. Built with PV_COST defined (host, C++11), the
+//  Cost* types count every operation they take part in; without it they are
+//  the plain types and cost nothing.
+//
+//
+
+#ifndef ____CostModel__
+#define ____CostModel__
+
+#include <stdio.h>
+
+// Operations counted, per kind of operand: 16 bit integer (int on the device),
+//  32 bit integer (long) and float (software on the C5535)
+#define COST_ADD16          0   // add, subtract, negate, shift, logic
+#define COST_ADD32          1
+#define COST_FADD           2
+#define COST_MUL16          3   // includes 16x16 -> 32 bit multiplies (costWideMul())
+#define COST_MUL32          4
+#define COST_FMUL           5
+#define COST_DIV16          6   // divide, modulo
+#define COST_DIV32          7
+#define COST_FDIV           8
+#define COST_BRANCH16       9   // compare (or test) and branch
+#define COST_BRANCH32       10
+#define COST_FBRANCH        11
+#define COST_CONVERT        12  // integer <-> float
+#define COST_CALL           13  // floor(), ceil(), round() and the like
+#define COST_MEMORY         14  // load or store through a CostArray
+#define COST_NUM_OPS        15
+
+// Operation counts, e.g. of one buffer
+struct CostCounts {
+    unsigned long ops[COST_NUM_OPS];
+    CostCounts() { reset(); }
+    void reset();
+    void add(const CostCounts& other);
+    unsigned long getTotal() const;
+};
+
+// Cycles per operation on a target, see costTableC5535
+struct CostTable {
+    const char* name;
+    double clockHz;
+    double cycles[COST_NUM_OPS];
+};
+
+extern const CostTable costTableC5535;
+extern const CostTable costTableCortexM4F;
+
+const char* costOpName(int op);
+// Estimated cycles of counts on target
+double costCycles(const CostCounts& counts, const CostTable& target);
+// Cycles available to process samples samples at fs on target (the real-time budget)
+double costBudget(const CostTable& target, long samples, long fs);
+// One line per operation: count and cycles per unit (e.g. per buffer), then the total
+void costPrint(FILE* out, const char* title, const CostCounts& counts, const CostTable& target,
+               long units = 1, const char* unitName = "buffer");
+
+#ifdef PV_COST
+#include <math.h>
+#include <type_traits>
+#include <utility>
+
+// Every Cost operation adds to these
+extern CostCounts costCounts;
+
+template<class T> class Cost;
+
+template<class T> struct CostTraits {
+    typedef T Raw;
+    static const bool counted = false;
+};
+template<class T> struct CostTraits<Cost<T> > {
+    typedef T Raw;
+    static const bool counted = true;
+};
+
+// Operation of the given family (COST_ADD16, COST_MUL16, ...) on operands of type T
+template<class T> inline void costCount(int family) {
+    costCounts.ops[family + (std::is_floating_point<T>::value ? 2 : (sizeof(T) > sizeof(int) ? 1 : 0))]++;
+}
+
+template<class A, class B> inline void costCountMixed() {
+    if (std::is_floating_point<A>::value != std::is_floating_point<B>::value) {
+        costCounts.ops[COST_CONVERT]++;
+    }
+}
+
+// A value that counts the operations it takes part in
+template<class T> class Cost {
+public:
+    Cost() : _value() {}
+    Cost(T value) : _value(value) {}
+    template<class U> Cost(const Cost<U>& other) : _value((T)other.value()) { costCountMixed<T, U>(); }
+    T value() const { return _value; }
+    template<class U> explicit operator U() const {
+        costCountMixed<T, U>();
+        return (U)_value;
+    }
+    explicit operator bool() const {
+        costCount<T>(COST_BRANCH16);
+        return _value != 0;
+    }
+    Cost operator-() const {
+        costCount<T>(COST_ADD16);
+        return Cost(-_value);
+    }
+    Cost operator~() const {
+        costCount<T>(COST_ADD16);
+        return Cost(~_value);
+    }
+    Cost& operator++() {
+        costCount<T>(COST_ADD16);
+        ++_value;
+        return *this;
+    }
+    Cost& operator--() {
+        costCount<T>(COST_ADD16);
+        --_value;
+        return *this;
+    }
+    Cost operator++(int) {
+        Cost old = *this;
+        ++*this;
+        return old;
+    }
+    Cost operator--(int) {
+        Cost old = *this;
+        --*this;
+        return old;
+    }
+    template<class U> Cost& operator+=(const U& x) { return *this = *this + x; }
+    template<class U> Cost& operator-=(const U& x) { return *this = *this - x; }
+    template<class U> Cost& operator*=(const U& x) { return *this = *this*x; }
+    template<class U> Cost& operator/=(const U& x) { return *this = *this/x; }
+    template<class U> Cost& operator>>=(const U& x) { return *this = *this >> x; }
+    template<class U> Cost& operator<<=(const U& x) { return *this = *this << x; }
+
+private:
+    T _value;
+};
+
+// The value of an operand
+template<class T> inline const T& costRaw(const T& x) { return x; }
+template<class T> inline T costRaw(const Cost<T>& x) { return x.value(); }
+
+// Binary operators between a Cost and a Cost or a plain value. The plain
+//  types are only looked at when one operand is a Cost, so that the
+//  operators of everything else (e.g. enums of the standard library) are left alone.
+template<class A, class B, bool counted = CostTraits<A>::counted || CostTraits<B>::counted> struct CostOperands {};
+template<class A, class B> struct CostOperands<A, B, true> {
+    typedef typename CostTraits<A>::Raw RawA;
+    typedef typename CostTraits<B>::Raw RawB;
+    typedef bool Bool;
+};
+
+#define COST_ARITHMETIC(op, family) \
+template<class A, class B> inline \
+Cost<decltype(std::declval<typename CostOperands<A, B>::RawA>() op std::declval<typename CostOperands<A, B>::RawB>())> \
+operator op(const A& a, const B& b) { \
+    typedef decltype(costRaw(a) op costRaw(b)) R; \
+    costCount<R>(family); \
+    costCountMixed<typename CostTraits<A>::Raw, typename CostTraits<B>::Raw>(); \
+    return Cost<R>(costRaw(a) op costRaw(b)); \
+}
+#define COST_COMPARISON(op) \
+template<class A, class B> inline typename CostOperands<A, B>::Bool operator op(const A& a, const B& b) { \
+    costCount<decltype(costRaw(a) + costRaw(b))>(COST_BRANCH16); \
+    costCountMixed<typename CostTraits<A>::Raw, typename CostTraits<B>::Raw>(); \
+    return costRaw(a) op costRaw(b); \
+}
+
+COST_ARITHMETIC(+, COST_ADD16)
+COST_ARITHMETIC(-, COST_ADD16)
+COST_ARITHMETIC(*, COST_MUL16)
+COST_ARITHMETIC(/, COST_DIV16)
+COST_ARITHMETIC(%, COST_DIV16)
+COST_ARITHMETIC(<<, COST_ADD16)
+COST_ARITHMETIC(>>, COST_ADD16)
+COST_ARITHMETIC(&, COST_ADD16)
+COST_ARITHMETIC(|, COST_ADD16)
+COST_ARITHMETIC(^, COST_ADD16)
+COST_COMPARISON(<)
+COST_COMPARISON(<=)
+COST_COMPARISON(>)
+COST_COMPARISON(>=)
+COST_COMPARISON(==)
+COST_COMPARISON(!=)
+
+#undef COST_ARITHMETIC
+#undef COST_COMPARISON
+
+// Library calls on a Cost (the result is a double like the <math.h> functions of an integer)
+#define COST_CALL_FUNCTION(name) \
+template<class T> inline Cost<double> name(const Cost<T>& x) { \
+    costCounts.ops[COST_CALL]++; \
+    costCountMixed<T, double>(); \
+    return Cost<double>(::name((double)x.value())); \
+}
+COST_CALL_FUNCTION(floor)
+COST_CALL_FUNCTION(ceil)
+COST_CALL_FUNCTION(round)
+#undef COST_CALL_FUNCTION
+
+// Array of T that counts every access
+template<class T> class CostArray {
+public:
+    CostArray(T* data = 0) : _data(data) {}
+    template<class I> T& operator[](const I& index) const {
+        costCounts.ops[COST_MEMORY]++;
+        return _data[costRaw(index)];
+    }
+    operator T*() const { return _data; }
+
+private:
+    T* _data;
+};
+
+// The Cost type of a T and an array of them, for code templated on its types
+template<class T> struct CostType {
+    typedef Cost<T> Value;
+    typedef CostArray<Cost<T> > Array;
+};
+
+typedef Cost<int> CostInt;
+typedef Cost<long> CostLong;
+typedef Cost<float> CostFloat;
+typedef CostArray<CostInt> CostIntArray;
+typedef CostArray<const float> CostConstFloatArray;
+
+// Plain value of a Cost (or of a plain value)
+template<class T> inline T costValue(const T& x) { return x; }
+template<class T> inline T costValue(const Cost<T>& x) { return x.value(); }
+
+// Counting view of a plain array (a Cost<T> is laid out like its T), so that
+//  headers can keep plain pointers and only the code counts
+template<class T> inline CostArray<Cost<T> > costArray(T* data) {
+    static_assert(sizeof(Cost<T>) == sizeof(T), "Cost<T> must be laid out like T");
+    return CostArray<Cost<T> >((Cost<T>*)data);
+}
+
+// 16x16 -> 32 bit multiply, a single instruction on the device
+inline CostLong costWideMul(const CostInt& x, const CostInt& y) {
+    costCounts.ops[COST_MUL16]++;
+    return CostLong((long)x.value()*(long)y.value());
+}
+// The same multiply when FixedPoint.h forms a product of counting types
+template<class Wide> inline CostLong fixedWideMul(const CostInt& x, const CostInt& y) {
+    return costWideMul(x, y);
+}
+#else
+template<class T> struct CostType {
+    typedef T Value;
+    typedef T* Array;
+};
+
+typedef int CostInt;
+typedef long CostLong;
+typedef float CostFloat;
+typedef int* CostIntArray;
+typedef const float* CostConstFloatArray;
+
+template<class T> inline T costValue(T x) { return x; }
+template<class T> inline T* costArray(T* data) { return data; }
+
+inline long costWideMul(int x, int y) { return (long)x*(long)y; }
+#endif
+
+#endif /* defined(____CostModel__) */
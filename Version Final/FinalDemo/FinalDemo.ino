@@ -13,6 +13,12 @@
 #include "FLWT.h"
 #include "PSOLA.h"
 #include "Frequency.h"
+#include "KeyDetector.h"
+#include "AudioRing.h"
+#include "QualityScheduler.h"
+#include "Resampler.h"
+#include "ControlPlane.h"
+#include "Telemetry.h"
 
 //===============================================================
 // Helper Functions/Function Definitions ========================
@@ -63,7 +69,6 @@ PSOLA psola(BufferLength);
 // DIP switch flags and parameters ==============================
 //===============================================================
 enum STATUS {NORMAL_MODE,PHASE_VOCODER,OCTAVE_UP,OCTAVE_DOWN,PITCH_DETECT};
-volatile int CURRENT_STATUS = NORMAL_MODE;
 
 const long NORMAL_MODE_SAMPLING_RATE =   SAMPLING_RATE_48_KHZ;
 const long PHASE_VOCODER_SAMPLING_RATE = SAMPLING_RATE_32_KHZ; // need to figure this out @@
@@ -85,8 +90,49 @@ Frequency f;
 volatile float freq;
 volatile int closestKeyNum;
 volatile float closestFreq;
-const int activeScale = C_SCALE;
-const int activeMajorOrMinor = MAJOR_SCALE;
+// Key the audio side corrects to: the one the user picked, or the detected one
+int activeScale = C_SCALE;
+int activeMajorOrMinor = MAJOR_SCALE;
+// Frequency of A4 (Hz) at start-up
+const float REFERENCE_PITCH = 440;
+// Reference pitch of the user over the one of the tuning of f
+float referenceRatio = 1;
+//===============================================================
+// Key Detection Module =========================================
+//===============================================================
+// true = follow the key of the singer, false = always use the scale of the user (at start-up)
+const int AUTO_DETECT_KEY = true;
+KeyDetector keyDetector;
+//===============================================================
+// Quality Scheduler ============================================
+//===============================================================
+// FLWT levels searched at QUALITY_REDUCED_LEVELS
+const int reducedLevels = 4;
+// Time available for one PHASE_VOCODER frame (one buffer period)
+const unsigned long PhaseVocoderBudgetUs = (unsigned long)(1000000.0*BufferLength/PHASE_VOCODER_SAMPLING_RATE);
+QualityScheduler scheduler(PhaseVocoderBudgetUs);
+//===============================================================
+// Control Plane ================================================
+//===============================================================
+// parse() publishes what the user asks for (mode, key, reference pitch,
+//  quality limit) and the audio side picks it up between two blocks, so a
+//  block never sees half of a command
+ControlPlane control;
+// Parameters of the block being processed (audio side only)
+ControlParams params;
+//===============================================================
+// Telemetry ====================================================
+//===============================================================
+// processData() queues what it did with every frame (see Telemetry.h); the
+//  ring drops frames instead of waiting when nobody drains it
+const int TelemetryDepth = 32;
+TelemetryRing telemetry(TelemetryDepth);
+// Frame being processed (audio side only)
+TelemetryFrame frameTelemetry;
+unsigned long telemetryFrames = 0;
+// true = loop() sends the queued records over serial (not while MATLAB
+//  expects the PITCH_DETECT arrays)
+const int SEND_TELEMETRY = false;
 //===============================================================
 //===============================================================
 
@@ -115,6 +161,72 @@ int OutputRight[BufferLength];
 // New declarations
 int window[BufferLength];
 
+//===============================================================
+// Deferred processing ==========================================
+//===============================================================
+// true = dmaIsr() only moves blocks through the rings and loop() processes them,
+// false = processData() runs inside dmaIsr()
+const int DEFERRED_PROCESSING = true;
+// Blocks each ring can hold (absorbs bursts of slow frames)
+const int ProcessingQueueDepth = 4;
+// Silent blocks queued before the first output: each one adds BufferLength/fs
+//  of latency and lets a block take one more period to process
+const int ProcessingLatencyBlocks = 1;
+AudioRing inputRing(ProcessingQueueDepth, BufferLength);
+AudioRing outputRing(ProcessingQueueDepth, BufferLength);
+
+//===============================================================
+// Software resampling ==========================================
+//===============================================================
+// true = the codec always runs at CODEC_SAMPLING_RATE and each mode resamples
+//  to its own rate, so switching modes never reconfigures the codec
+// false = parse() reconfigures the codec to the rate of the new mode
+const int SOFTWARE_RESAMPLING = true;
+const long CODEC_SAMPLING_RATE = SAMPLING_RATE_48_KHZ;
+const int NumStatus = PITCH_DETECT + 1;
+// Codec rate to working rate and back, per mode (0 if the mode works at the codec rate)
+Resampler *toWorkingLeft[NumStatus];
+Resampler *toWorkingRight[NumStatus];
+Resampler *toCodecLeft[NumStatus];
+Resampler *toCodecRight[NumStatus];
+// Mode the resamplers are running for; processData() follows this one
+volatile int workingStatus = NORMAL_MODE;
+// Working rate samples collected for the next block
+int workInLeft[BufferLength];
+int workInRight[BufferLength];
+int workInFill = 0;
+int workOutLeft[BufferLength];
+int workOutRight[BufferLength];
+// Working rate samples of one codec block
+int decimatedLeft[BufferLength + 1];
+int decimatedRight[BufferLength + 1];
+// Codec rate samples waiting to be played
+int *playLeft;
+int *playRight;
+int playFill = 0;
+int playLength = 0;
+volatile long resampleUnderruns = 0;
+volatile long resampleOverruns = 0;
+
+/** \brief Sampling rate a mode processes at */
+long workingRateOf(int status)
+{
+  switch(status) {
+    case PHASE_VOCODER : return PHASE_VOCODER_SAMPLING_RATE;
+    case OCTAVE_UP :     return OCTAVE_UP_SAMPLING_RATE;
+    case OCTAVE_DOWN :   return OCTAVE_DOWN_SAMPLING_RATE;
+    case PITCH_DETECT :  return PITCH_DETECT_SAMPLING_RATE;
+    default :            return NORMAL_MODE_SAMPLING_RATE;
+  }
+}
+
+/** \brief Codec rate samples that one working rate block turns into */
+int codecSamplesPerBlock(int status)
+{
+  long rate = workingRateOf(status);
+  return (int)(((long)BufferLength*CODEC_SAMPLING_RATE + rate - 1)/rate);
+}
+
 /** \brief Setup function
  * 
  * Allocate memory for input/output arrays.
@@ -144,6 +256,42 @@ void setup()
   // Audio library is configured for non-loopback mode
   status = AudioC.Audio(TRUE, BufferLength);
 
+  // Buy the processing loop some headroom
+  outputRing.prime(ProcessingLatencyBlocks);
+
+  // Design every resampler up front so that a mode switch only resets them
+  for (int s = 0; s < NumStatus; s++) {
+    toWorkingLeft[s] = 0;
+    toWorkingRight[s] = 0;
+    toCodecLeft[s] = 0;
+    toCodecRight[s] = 0;
+    long rate = workingRateOf(s);
+    if (SOFTWARE_RESAMPLING && rate != CODEC_SAMPLING_RATE) {
+      toWorkingLeft[s] = new Resampler(CODEC_SAMPLING_RATE, rate);
+      toWorkingRight[s] = new Resampler(CODEC_SAMPLING_RATE, rate);
+      toCodecLeft[s] = new Resampler(rate, CODEC_SAMPLING_RATE);
+      toCodecRight[s] = new Resampler(rate, CODEC_SAMPLING_RATE);
+      // Primed latency plus one processed block
+      int len = 2*codecSamplesPerBlock(s) + 2*BufferLength + 2;
+      if (len > playLength) {
+        playLength = len;
+      }
+    }
+  }
+  playLeft = new int[playLength + 1];
+  playRight = new int[playLength + 1];
+
+  ControlParams initial;
+  initial.mode = NORMAL_MODE;
+  initial.scale = activeScale;
+  initial.majorOrMinor = activeMajorOrMinor;
+  initial.autoKey = AUTO_DETECT_KEY;
+  initial.referencePitch = REFERENCE_PITCH;
+  initial.qualityLimit = QUALITY_FULL;
+  control.publish(initial);
+  control.acquire(params);
+  startWorkingRate(params.mode);
+
   // Set codec sampling rate:
   //   SAMPLING_RATE_8_KHZ
   //   SAMPLING_RATE_11_KHZ
@@ -154,7 +302,7 @@ void setup()
   //   SAMPLING_RATE_32_KHZ
   //   SAMPLING_RATE_44_KHZ
   //   SAMPLING_RATE_48_KHZ (default)
-  AudioC.setupCodec(fs_default);
+  AudioC.setupCodec(SOFTWARE_RESAMPLING ? CODEC_SAMPLING_RATE : fs_default);
 
   if (status == 0)
   {
@@ -188,12 +336,180 @@ void setup()
  */
 void loop() {
     int command;
-    cmd.recv();        
-    command = cmd.getCmd();
-    parse(command);   
+    if (!DEFERRED_PROCESSING) {
+        cmd.recv();        
+        command = cmd.getCmd();
+        parse(command);   
+        return;
+    }
+    // Only wait for a command once one has started arriving so that the
+    //  queued blocks keep being processed
+    if (Serial.available()) {
+        cmd.recv();
+        command = cmd.getCmd();
+        parse(command);
+    }
+    processQueuedBlocks();
+    if (SEND_TELEMETRY) {
+        sendTelemetry();
+    }
+}
+
+/** \brief Sends the queued telemetry records over serial
+ *
+ * Runs in loop(), the only consumer of the telemetry ring.
+ */
+void sendTelemetry()
+{
+  unsigned char record[TELEMETRY_RECORD_BYTES];
+  TelemetryFrame frame;
+  while (telemetry.pop(frame) == 0) {
+    encodeTelemetryFrame(frame, record);
+    serial_send_array((char*)record, TELEMETRY_RECORD_BYTES);
+  }
+}
+
+/** \brief Processes every block that the ISR queued
+ *
+ * Runs outside of the ISR, so a slow frame only uses up the latency that
+ * was primed into outputRing instead of delaying the next DMA transfer.
+ */
+void processQueuedBlocks()
+{
+  while (inputRing.count() > 0 && outputRing.space() > 0) {
+    const int *input = inputRing.readSlot();
+    int *output = outputRing.writeSlot();
+    processCodecBlock(input, input + BufferLength, output, output + BufferLength);
+    outputRing.commitWrite();
+    inputRing.commitRead();
+  }
+}
+
+/** \brief Resets the resampling for a new mode
+ *
+ * The play queue is primed with one working block (plus one codec block of
+ * slack) of silence: a block is only processed once enough codec blocks have
+ * been collected for it, and its output has to last until the next one is.
+ *
+ * \param status is the new mode
+ *
+ */
+void startWorkingRate(int status)
+{
+  workingStatus = status;
+  workInFill = 0;
+  playFill = 0;
+  if (toWorkingLeft[status]) {
+    toWorkingLeft[status]->reset();
+    toWorkingRight[status]->reset();
+    toCodecLeft[status]->reset();
+    toCodecRight[status]->reset();
+    playFill = codecSamplesPerBlock(status) + BufferLength;
+    for (int n = 0; n < playFill; n++) {
+      playLeft[n] = 0;
+      playRight[n] = 0;
+    }
+  }
+}
+
+/** \brief Applies the parameters of a new control snapshot
+ *
+ * Called between two blocks on the audio side, so the state of a mode is
+ * only ever reset while no block is using it.
+ *
+ */
+void applyParams()
+{
+  if (params.mode != workingStatus) {
+    startWorkingRate(params.mode);
+    if (params.mode == PHASE_VOCODER) {
+      // start learning the key of the new performance
+      keyDetector.reset();
+      // and start again at the best quality allowed
+      scheduler.reset();
+    } else if (params.mode == PITCH_DETECT) {
+      numOfBufferReads = 0;
+      // the scheduler may have left the FLWT with fewer levels
+      flwt.setLevels(levels);
+    }
+  }
+  if (!params.autoKey) {
+    activeScale = params.scale;
+    activeMajorOrMinor = params.majorOrMinor;
+  }
+  referenceRatio = params.referencePitch/f.getTuning()->referencePitch;
+  // the singer is tuned to the user's A4, so bin the pitch classes against it
+  keyDetector.setReference(params.referencePitch);
+  scheduler.setLimit(params.qualityLimit);
+}
+
+/** \brief Runs one codec block through the current mode
+ *
+ * Modes that work at the codec rate go straight to processData(). The others
+ * decimate the block to their working rate, call processData() on every
+ * complete BufferLength block and interpolate the result back into the play
+ * queue, from which one codec block is returned.
+ *
+ * Picks up the parameters parse() published since the last block first.
+ *
+ * \param inputLeft is a pointer to the codec input of the left channel
+ * \param inputRight is a pointer to the codec input of the right channel
+ * \param outputLeft is a pointer to the codec output of the left channel
+ * \param outputRight is a pointer to the codec output of the right channel
+ *
+ */
+void processCodecBlock(const int *inputLeft, const int *inputRight, int *outputLeft, int *outputRight)
+{
+  if (control.acquire(params)) {
+    applyParams();
+  }
+  int status = workingStatus;
+  if (!toWorkingLeft[status]) {
+    processData(inputLeft, inputRight, outputLeft, outputRight);
+    return;
+  }
+
+  int decimated = toWorkingLeft[status]->process(inputLeft, BufferLength, decimatedLeft);
+  toWorkingRight[status]->process(inputRight, BufferLength, decimatedRight);
+  for (int i = 0; i < decimated; i++) {
+    workInLeft[workInFill] = decimatedLeft[i];
+    workInRight[workInFill] = decimatedRight[i];
+    workInFill++;
+    if (workInFill == BufferLength) {
+      workInFill = 0;
+      processData(workInLeft, workInRight, workOutLeft, workOutRight);
+      if (playFill + toCodecLeft[status]->getMaxOutput(BufferLength) > playLength) {
+        resampleOverruns++;
+        continue;
+      }
+      toCodecLeft[status]->process(workOutLeft, BufferLength, playLeft + playFill);
+      playFill += toCodecRight[status]->process(workOutRight, BufferLength, playRight + playFill);
+    }
+  }
+
+  // Play the oldest codec block
+  int available = (playFill < BufferLength) ? playFill : BufferLength;
+  for (int n = 0; n < available; n++) {
+    outputLeft[n] = playLeft[n];
+    outputRight[n] = playRight[n];
+  }
+  for (int n = available; n < BufferLength; n++) {
+    outputLeft[n] = 0;
+    outputRight[n] = 0;
+  }
+  if (available < BufferLength) {
+    resampleUnderruns++;
+  }
+  for (int n = available; n < playFill; n++) {
+    playLeft[n - available] = playLeft[n];
+    playRight[n - available] = playRight[n];
+  }
+  playFill -= available;
 }
 
 /** \brief Main processing function
+ * 
+ * Queues the telemetry of the frame once it is processed.
  * 
  * \param inputLeft is a pointer to the input data array for the left channel
  * \param inputRight is a pointer to the input data array for the right channel
@@ -203,40 +519,57 @@ void loop() {
  */
 void processData(const int *inputLeft, const int *inputRight, int *outputLeft, int *outputRight)
 {
+  frameTelemetry.frame = telemetryFrames++;
+  frameTelemetry.mode = workingStatus;
+  frameTelemetry.quality = QUALITY_FULL;
+  frameTelemetry.pitch = 0;
+  frameTelemetry.target = 0;
+  frameTelemetry.key = 0;
+  frameTelemetry.level = 0;
+  frameTelemetry.detectUs = 0;
+  frameTelemetry.quantizeUs = 0;
+  frameTelemetry.correctUs = 0;
+  unsigned long start;
+
   for(int n = 0; n < BufferLength; n++)
   {
     outputLeft[n]  = inputLeft[n]*window[n];
     outputRight[n] = inputRight[n]*window[n];
   }
   
-  switch(CURRENT_STATUS) {
+  switch(workingStatus) {
    case NORMAL_MODE :
        // don't need to do anything
        break;
    case PHASE_VOCODER :
-       freq = flwt.getPitchWithMedian5(outputLeft,BufferLength,PHASE_VOCODER_SAMPLING_RATE);
-       if (freq) {
-         closestFreq = f.getClosestKeyFreqInScale(freq,activeScale,activeMajorOrMinor);
-         psola.pitchCorrect(outputLeft,PHASE_VOCODER_SAMPLING_RATE,freq,closestFreq);
-         psola.pitchCorrect(outputRight,PHASE_VOCODER_SAMPLING_RATE,freq,closestFreq);
-       } 
+       phaseVocoder(outputLeft,outputRight);
        break;
    case OCTAVE_UP :
        // Double the frequency
        freq = OCTAVE_UP_APPARENT_FREQ;
+       start = micros();
        psola.pitchCorrect(outputLeft,OCTAVE_UP_SAMPLING_RATE,freq,freq*2);
        psola.pitchCorrect(outputRight,OCTAVE_UP_SAMPLING_RATE,freq,freq*2);
+       frameTelemetry.correctUs = micros() - start;
+       frameTelemetry.target = freq*2;
        break;
    case OCTAVE_DOWN :
        // Half the frequency
        freq = OCTAVE_DOWN_APPARENT_FREQ;
+       start = micros();
        psola.pitchCorrect(outputLeft,OCTAVE_DOWN_SAMPLING_RATE,freq,freq/2);
        psola.pitchCorrect(outputRight,OCTAVE_DOWN_SAMPLING_RATE,freq,freq/2);
+       frameTelemetry.correctUs = micros() - start;
+       frameTelemetry.target = freq/2;
        //psola.pitchCorrect(outputLeft,fs_default,freq,freq/2);
        //psola.pitchCorrect(outputRight,fs_default,freq,freq/2);
        break;
    case PITCH_DETECT :
+       start = micros();
        un.freqF[numOfBufferReads] = flwt.getPitchWithMedian5(outputLeft,BufferLength,PITCH_DETECT_SAMPLING_RATE);
+       frameTelemetry.detectUs = micros() - start;
+       frameTelemetry.pitch = un.freqF[numOfBufferReads];
+       frameTelemetry.level = flwt.getFoundLevel();
        numOfBufferReads++;
        if(numOfBufferReads >= MaxNumOfBufferReads) {
            serial_send_array(un.freqL,MaxNumOfBufferReads);
@@ -248,13 +581,70 @@ void processData(const int *inputLeft, const int *inputRight, int *outputLeft, i
        disp.setline(0); disp.print("INVALID");
        disp.setline(1); disp.print("STATUS");
    }
+  telemetry.push(frameTelemetry);
+}
+
+/** \brief Pitch corrects a frame at the quality picked by the scheduler
+ *
+ * Times the frame and reports it to the scheduler, which steps the quality
+ * down when frames get close to the buffer period and back up once there is
+ * headroom again (see QualityScheduler.h for the ladder).
+ *
+ * \param outputLeft is the left channel, corrected in place
+ * \param outputRight is the right channel, corrected in place
+ *
+ */
+void phaseVocoder(int *outputLeft, int *outputRight)
+{
+  int quality = scheduler.getLevel();
+  unsigned long start = micros();
+  unsigned long stage = start;
+  frameTelemetry.quality = quality;
+
+  if (quality < QUALITY_CACHED_PITCH) {
+    flwt.setLevels((quality == QUALITY_FULL) ? levels : reducedLevels);
+    freq = flwt.getPitchWithMedian5(outputLeft,BufferLength,PHASE_VOCODER_SAMPLING_RATE);
+    frameTelemetry.level = flwt.getFoundLevel();
+    if (freq && params.autoKey) {
+      keyDetector.addPitch(freq);
+      activeScale = keyDetector.getScale();
+      activeMajorOrMinor = keyDetector.getMajorOrMinor();
+    }
+    unsigned long now = micros();
+    frameTelemetry.detectUs = now - stage;
+    stage = now;
+  }
+  // Otherwise freq still holds the pitch of the last detected frame
+  frameTelemetry.pitch = freq;
+
+  if (freq && quality < QUALITY_BYPASS) {
+    // Look the pitch up as if the user tuned to the reference pitch of f
+    closestKeyNum = f.getClosestKeyNumInScale(freq/referenceRatio,activeScale,activeMajorOrMinor);
+    closestFreq = referenceRatio*f.getFreqOfKeyNum(closestKeyNum);
+    unsigned long now = micros();
+    frameTelemetry.quantizeUs = now - stage;
+    stage = now;
+    psola.pitchCorrect(outputLeft,PHASE_VOCODER_SAMPLING_RATE,freq,closestFreq);
+    if (quality < QUALITY_MONO) {
+      psola.pitchCorrect(outputRight,PHASE_VOCODER_SAMPLING_RATE,freq,closestFreq);
+    } else {
+      for (int n = 0; n < BufferLength; n++) {
+        outputRight[n] = outputLeft[n];
+      }
+    }
+    frameTelemetry.correctUs = micros() - stage;
+    frameTelemetry.target = closestFreq;
+    frameTelemetry.key = closestKeyNum;
+  }
+
+  scheduler.frameDone(micros() - start);
 }
 
 /** \brief DMA Interrupt Service Routine
  * 
  * Manage ping-pong input/output buffers.
  * 
- * Calls processData() on input/output buffers.
+ * Calls processCodecBlock() on input/output buffers.
  * 
  */
 interrupt void dmaIsr(void)
@@ -277,15 +667,53 @@ interrupt void dmaIsr(void)
     /* Data read from codec is copied to process input buffers.
      Processing is done after configuring DMA for next block of transfer
      ensuring no data loss */
-    copyShortBuf(AudioC.audioInLeft[AudioC.activeInBuf],
-    InputLeft, BufferLength);
-    copyShortBuf(AudioC.audioInRight[AudioC.activeInBuf],
-    InputRight, BufferLength);
-    readyToProcess = 1;
+    if (DEFERRED_PROCESSING)
+    {
+      /* Queue the block for loop(); a full ring drops it (overrun) */
+      int *block = inputRing.writeSlot();
+      if (block)
+      {
+        copyShortBuf(AudioC.audioInLeft[AudioC.activeInBuf],
+        block, BufferLength);
+        copyShortBuf(AudioC.audioInRight[AudioC.activeInBuf],
+        block + BufferLength, BufferLength);
+        inputRing.commitWrite();
+      }
+    }
+    else
+    {
+      copyShortBuf(AudioC.audioInLeft[AudioC.activeInBuf],
+      InputLeft, BufferLength);
+      copyShortBuf(AudioC.audioInRight[AudioC.activeInBuf],
+      InputRight, BufferLength);
+      readyToProcess = 1;
+    }
   }
   else if ((ifrValue >> DMA_CHAN_WriteR) & 0x01)
   {
-    if (outputBufAvailable)
+    if (DEFERRED_PROCESSING)
+    {
+      /* Play the oldest processed block; an empty ring plays silence (underrun) */
+      writeBufIndex = (AudioC.activeOutBuf == FALSE)? TRUE: FALSE;
+      const int *block = outputRing.readSlot();
+      if (block)
+      {
+        copyShortBuf(block, AudioC.audioOutLeft[writeBufIndex],
+        BufferLength);
+        copyShortBuf(block + BufferLength, AudioC.audioOutRight[writeBufIndex],
+        BufferLength);
+        outputRing.commitRead();
+      }
+      else
+      {
+        for (int n = 0; n < BufferLength; n++)
+        {
+          AudioC.audioOutLeft[writeBufIndex][n] = 0;
+          AudioC.audioOutRight[writeBufIndex][n] = 0;
+        }
+      }
+    }
+    else if (outputBufAvailable)
     {
       /* Processed buffers need to be copied to audio out buffers as
        audio library is configured for non-loopback mode */
@@ -308,67 +736,121 @@ interrupt void dmaIsr(void)
   {
     readyToProcess = 0;
 
-    processData(InputLeft, InputRight, OutputLeft, OutputRight);
+    processCodecBlock(InputLeft, InputRight, OutputLeft, OutputRight);
 
     outputBufAvailable = 1;
   }
 }
 
+/** \brief Switches the codec to the rate of a new mode
+ *
+ * Only needed without SOFTWARE_RESAMPLING; otherwise the codec keeps its rate
+ * and processCodecBlock() picks up the new mode on the next block.
+ */
+void setModeSamplingRate(long rate)
+{
+  if (!SOFTWARE_RESAMPLING) {
+    AudioC.setupCodec(rate);
+  }
+}
+
+/** \brief Carries out a command from MATLAB
+ *
+ * Only publishes the new parameters (see ControlPlane.h); the audio side
+ * applies them before its next block.
+ *
+ * Commands 0-4 switch modes. Command 5 sets the key to data[0] (A_SCALE...
+ * Gs_SCALE, 0 = follow the singer) and data[1] (MAJOR_SCALE or
+ * MINOR_SCALE), command 6 sets A4 to data[0] tenths of Hz and command 7
+ * limits the quality to data[0] (QUALITY_FULL... QUALITY_BYPASS).
+ *
+ * \param c is the command
+ *
+ */
 void parse(int c) {
-    const int *input;
-    int dataLength;
+    const int *input = cmd.getDataIntPointer();
+    ControlParams next = control.getPublished();
     switch(c) {
         case 0: // normal mode
             disp.clear();
             disp.setline(0); disp.print("Cmd 0:");
             disp.setline(1); disp.print("NORM MODE");            
-            if (CURRENT_STATUS != NORMAL_MODE) {
-                AudioC.setupCodec(NORMAL_MODE_SAMPLING_RATE);
+            if (next.mode != NORMAL_MODE) {
+                setModeSamplingRate(NORMAL_MODE_SAMPLING_RATE);
             }
-            CURRENT_STATUS = NORMAL_MODE;
+            next.mode = NORMAL_MODE;
             break;
         case 1: // phase vocoder
             disp.clear();
             disp.setline(0); disp.print("Cmd 1:");
             disp.setline(1); disp.print("PHASE VOC");   
-            if (CURRENT_STATUS != PHASE_VOCODER) {
-                AudioC.setupCodec(PHASE_VOCODER_SAMPLING_RATE);
+            if (next.mode != PHASE_VOCODER) {
+                setModeSamplingRate(PHASE_VOCODER_SAMPLING_RATE);
             }
-            CURRENT_STATUS = PHASE_VOCODER;
+            next.mode = PHASE_VOCODER;
             break;
         case 2: // octave up
             disp.clear();
             disp.setline(0); disp.print("Cmd 2:");
             disp.setline(1); disp.print("OCTAVE UP");   
-            if (CURRENT_STATUS != OCTAVE_UP) {
-                AudioC.setupCodec(OCTAVE_UP_SAMPLING_RATE);
+            if (next.mode != OCTAVE_UP) {
+                setModeSamplingRate(OCTAVE_UP_SAMPLING_RATE);
             }
-            CURRENT_STATUS = OCTAVE_UP;
+            next.mode = OCTAVE_UP;
             break;
         case 3: // octave down
             disp.clear();
             disp.setline(0); disp.print("Cmd 3:");
             disp.setline(1); disp.print("OCTAVE DOWN");   
-            if (CURRENT_STATUS != OCTAVE_DOWN) {
-                AudioC.setupCodec(OCTAVE_DOWN_SAMPLING_RATE);
+            if (next.mode != OCTAVE_DOWN) {
+                setModeSamplingRate(OCTAVE_DOWN_SAMPLING_RATE);
             }
-            CURRENT_STATUS = OCTAVE_DOWN;
+            next.mode = OCTAVE_DOWN;
             break;
         case 4: // pitch detect
             disp.clear();
             disp.setline(0); disp.print("Cmd 4:");
             disp.setline(1); disp.print("PITCH DETEC");   
-            if (CURRENT_STATUS != PITCH_DETECT) {
-                AudioC.setupCodec(PITCH_DETECT_SAMPLING_RATE);
+            if (next.mode != PITCH_DETECT) {
+                setModeSamplingRate(PITCH_DETECT_SAMPLING_RATE);
+            }
+            next.mode = PITCH_DETECT;
+            break;
+        case 5: // key
+            disp.clear();
+            disp.setline(0); disp.print("Cmd 5:");
+            disp.setline(1); disp.print("KEY");
+            if (input[0] >= A_SCALE && input[0] <= Gs_SCALE) {
+                next.autoKey = false;
+                next.scale = input[0];
+                next.majorOrMinor = (input[1] == MINOR_SCALE) ? MINOR_SCALE : MAJOR_SCALE;
+            } else {
+                next.autoKey = true;
+            }
+            break;
+        case 6: // reference pitch
+            disp.clear();
+            disp.setline(0); disp.print("Cmd 6:");
+            disp.setline(1); disp.print("TUNING");
+            // Error Handle (about a semitone around 440 Hz)
+            if (input[0] >= 4150 && input[0] <= 4660) {
+                next.referencePitch = input[0]/10.0;
+            }
+            break;
+        case 7: // quality limit
+            disp.clear();
+            disp.setline(0); disp.print("Cmd 7:");
+            disp.setline(1); disp.print("QUALITY");
+            if (input[0] >= QUALITY_FULL && input[0] <= QUALITY_BYPASS) {
+                next.qualityLimit = input[0];
             }
-            CURRENT_STATUS = PITCH_DETECT;
-            numOfBufferReads = 0;
             break;
         default:
             disp.clear();
             disp.setline(0);
             disp.print("Unknown Command");
-            CURRENT_STATUS = NORMAL_MODE; // just incase
+            next.mode = NORMAL_MODE; // just incase
             break;
     }
+    control.publish(next);
 }
@@ -1,31 +1,47 @@
 /**
- *   @mainpage "@mainpage" TAG WRITES HERE
- *   @author Terry Kong
- *   @date Feb. 28, 2014
+ *   @mainpage Piano Frequency Utility Class
+ *   @author Terry Kong (Stanford University)
+ *   @date Mar. 9, 2015
  *
  *   \section desc_sec Description
- *   need to finish writing the description
+ *   This class provides a few functions to automate the mapping of an
+ *      arbitrary frequency to the set 88 piano key frequencies. Depending
+ *      on the platform it may be simpler to use the names of keys, e.g.,
+ *      C4 or G6, instead of frequencies or key numbers. This class allows 
+ *      the user to reference a key by frequency, key number, or key name.
+ *      It's primary purpose is to be a helper class for a pitch correction
+ *      module in order to simplify the process of determining the final
+ *      intended pitch.
  *
  *  \section contents_sec Table of Contents
  *    Frequency.cpp
  *
+ *    Frequency.h
  *
  */
 
 /**
- *  @file Frequency.cpp ("@file" TAG WRITES HERE)
- *  @brief ("@brief" TAG WRITES HERE)
- *  @details    More verbose file description.
+ *  @file Frequency.cpp
+ *  @brief Source file for Frequency class.
+ *  @file Frequency.h
+ *  @brief Header file for Frequency class.
  */
 
 
 #include <math.h>
 #include "Frequency.h"
+#include "CostModel.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #define NUM_PIANO_KEYS          88
 #define FIRST_KEY               1
 #define NUM_OF_KEYS_IN_OCTAVE   12
 #define NUM_OF_KEYS_IN_SCALE    8
+#define MAX_DIVISIONS           32
+#define QUANTIZE_CHUNK          64
+#define MAX_QUANTIZE_KEYS       256
 
 /** 
  The first index is "-" so that the index corresponds to the key number
@@ -38,14 +54,29 @@ const char *keys[NUM_PIANO_KEYS+1] = {"-","A0","A0s","B0","C1","C1s","D1","D1s",
 const float keyFreq[NUM_PIANO_KEYS+1] = {-1.0,27.500,29.135,30.868,32.703,34.648,36.708,38.891,41.203,43.654,46.249,48.999,51.913,55.000,58.270,61.735,65.406,69.296,73.416,77.782,82.407,87.307,92.499,97.999,103.826,110.000,116.541,123.471,130.813,138.591,146.832,155.563,164.814,174.614,184.997,195.998,207.652,220.000,233.082,246.942,261.626,277.183,293.665,311.127,329.628,349.228,369.994,391.995,415.305,440.000,466.164,493.883,523.251,554.365,587.330,622.254,659.255,698.456,739.989,783.991,830.609,880.000,932.328,987.767,1046.502,1108.731,1174.659,1244.508,1318.510,1396.913,1479.978,1567.982,1661.219,1760.000,1864.655,1975.533,2093.005,2217.461,2349.318,2489.016,2637.020,2793.826,2959.955,3135.963,3322.438,3520.000,3729.310,3951.066,4186.009};
 
 /**
- Major scale progression
+ The standard piano (A4 = 440 Hz, 12 keys per octave) used when no tuning is given
  */
-const int majorStep[NUM_OF_KEYS_IN_SCALE - 1] = {2,2,1,2,2,2,1};
+const TuningTable standardTuning = {440.0f, A4_KEY, NUM_OF_KEYS_IN_OCTAVE, NUM_PIANO_KEYS, SCALE_MASK_MAJOR, keyFreq, 0};
 
-/**
- Minor scale progression
+/** ==============================================================================
+ * @brief       Initializes the module with a tuning.
+ *
+ * @details     The tuning only holds pointers to tables that already exist, so
+ *              switching between tunings costs nothing at runtime. The tables
+ *              are usually generated at compile time with the Tuning template
+ *              declared in Tuning.h.
+ *
+ * @param       tuning      Tuning to use (0 = standard A4 = 440 Hz piano)
+ * ================================================================================
  */
-const int minorStep[NUM_OF_KEYS_IN_SCALE - 1] = {2,1,2,2,1,2,2};
+Frequency::Frequency(const TuningTable* tuning) {
+    setTuning(tuning);
+}
+
+/** Selects the tuning (0 = standard A4 = 440 Hz piano) */
+void Frequency::setTuning(const TuningTable* tuning) {
+    _tuning = tuning ? tuning : &standardTuning;
+}
 
 /** ====================================================
  * @brief       Returns the key number.
@@ -59,13 +90,15 @@ const int minorStep[NUM_OF_KEYS_IN_SCALE - 1] = {2,1,2,2,1,2,2};
  * ======================================================
  */
 int Frequency::getClosestKeyNum(float freq) {
-    if (freq > keyFreq[NUM_PIANO_KEYS]) {
-        return NUM_PIANO_KEYS;
+    const float* keyFreq = _tuning->keyFreq;
+    int numKeys = _tuning->numKeys;
+    if (freq > keyFreq[numKeys]) {
+        return numKeys;
     } else if (freq < 0) {
         return FIRST_KEY;
     }
     float minDist;
-    for (int i = FIRST_KEY; i <= NUM_PIANO_KEYS; i++) {
+    for (int i = FIRST_KEY; i <= numKeys; i++) {
         minDist = freq - keyFreq[i];
         // Keep increasing until hit the closest
         if (minDist == 0.0) {
@@ -85,7 +118,11 @@ int Frequency::getClosestKeyNum(float freq) {
 /** ====================================================
  * @brief       Returns the closest key number restricted to a scale
  *
- * @details     Returns the key number restricted to a scale: if bigger than max or smaller than min, returns NUM_OF_KEYS or 0 respectively.
+ * @details     Returns the key number restricted to a scale: if bigger than max 
+ *              or smaller than min, returns NUM_OF_KEYS or 0 respectively.
+ *              The key that specifies the beginning of the scale can be anywhere
+ *              between 1 and 88, but the value returned can be anywhere between 1
+ *              and 88.
  *
  * @param       freq                   frequency
  * @param       keyThatBeginsScale     Pick a key on the piano that begins the scale
@@ -96,50 +133,110 @@ int Frequency::getClosestKeyNum(float freq) {
  * ======================================================
  */
 int Frequency::getClosestKeyNumInScale(float freq, int keyThatBeginsScale, int majorOrMinor) {
-    if (freq > keyFreq[NUM_PIANO_KEYS]) {
-        return NUM_PIANO_KEYS;
-    } else if (freq < 0) {
-        return FIRST_KEY;
-    }
     // Pick either major or minor
-    const int* stepProgression;
-    if (majorOrMinor == MAJOR_SCALE) {
-        stepProgression = majorStep;
-    } else if (majorOrMinor == MINOR_SCALE) {
-        stepProgression = minorStep;
-    } else {
-        // assume this is what the user wants
-        stepProgression = majorStep;
+    if (majorOrMinor == MINOR_SCALE) {
+        return getClosestKeyNumInScaleMask(freq, keyThatBeginsScale, SCALE_MASK_MINOR);
+    }
+    // assume major is what the user wants
+    return getClosestKeyNumInScaleMask(freq, keyThatBeginsScale, SCALE_MASK_MAJOR);
+}
+
+/** ====================================================
+ * @brief       Returns the closest key number restricted to an arbitrary scale
+ *
+ * @details     Same as Frequency::getClosestKeyNumInScale, but the scale is
+ *              given as a mask: bit n is set if the key n steps above the
+ *              tonic belongs to the scale (see the SCALE_MASK_ definitions).
+ *              A mask of 0 is treated as the chromatic scale.
+ *
+ * @param       frequency              frequency
+ * @param       keyThatBeginsScale     Pick a key on the piano that begins the scale
+ * @param       scaleMask              Keys of the scale relative to the tonic
+ *
+ * @return      Key number
+ *
+ * ======================================================
+ */
+int Frequency::getClosestKeyNumInScaleMask(float frequency, int keyThatBeginsScale, unsigned long scaleMask) {
+    CostFloat freq = frequency;
+    CostConstFloatArray keyFreq = _tuning->keyFreq;
+    int numKeys = _tuning->numKeys;
+    CostInt divisions = _tuning->divisions;
+    if (scaleMask == 0) {
+        scaleMask = ~0UL;
     }
     // Figure out what the lowest key that keyThatBeginsScale refers to
-    keyThatBeginsScale = ((keyThatBeginsScale - 1) % 12) + 1;
-    int i = keyThatBeginsScale;
-    int indexInScale = 0;
-    float minDist;
-    while (i <= NUM_PIANO_KEYS) {
+    keyThatBeginsScale = costValue(((keyThatBeginsScale - 1) % divisions) + 1);
+    // Find the lowest and highest keys in the scale
+    int first = FIRST_KEY;
+    while (first <= numKeys && !((scaleMask >> ((first - keyThatBeginsScale + divisions) % divisions)) & 1)) {
+        first++;
+    }
+    int last = numKeys;
+    while (last > first && !((scaleMask >> ((last - keyThatBeginsScale + divisions) % divisions)) & 1)) {
+        last--;
+    }
+    if (first > numKeys) {
+        // Something really went wrong
+        return -1;
+    }
+    if (freq >= keyFreq[last]) {
+        return last;
+    } else if (freq <= keyFreq[first]) {
+        return first;
+    }
+    int previous = first;
+    CostInt degree = (first - keyThatBeginsScale + divisions) % divisions;
+    CostFloat minDist;
+    for (int i = first + 1; i <= last; i++) {
+        degree++;
+        if (degree == divisions) {
+            degree = 0;
+        }
+        if (!((scaleMask >> degree) & 1)) {
+            continue;
+        }
         minDist = freq - keyFreq[i];
         // Keep increasing until hit the closest
         if (minDist == 0.0) {
             return i;
         } else if (minDist < 0.0) {
-            if (-minDist > (freq - keyFreq[i-1])) {
-                return i-1; // the last one is closer
+            if (-minDist > (freq - keyFreq[previous])) {
+                return previous; // the last one in the scale is closer
             } else {
                 return i; // this current one is closer
             }
         }
-        i += stepProgression[indexInScale];
-        indexInScale++;
-        indexInScale = indexInScale % NUM_OF_KEYS_IN_SCALE;
+        previous = i;
     }
-    // Something really went wrong
-    return -1;
+    return last;
+}
+
+/** ====================================================
+ * @brief       Returns the closest key number restricted to the tuning's scale
+ *
+ * @details     Uses the scale mask that was compiled into the tuning, so each
+ *              stream can carry its own scale along with its reference pitch.
+ *
+ * @param       freq                   frequency
+ * @param       keyThatBeginsScale     Pick a key on the piano that begins the scale
+ *
+ * @return      Key number
+ *
+ * ======================================================
+ */
+int Frequency::getClosestKeyNumInTuningScale(float freq, int keyThatBeginsScale) {
+    return getClosestKeyNumInScaleMask(freq, keyThatBeginsScale, _tuning->scaleMask);
 }
 
 /** ====================================================
  * @brief       Returns the closest key frequency restricted to a scale
  *
- * @details     Returns the key number restricted to a scale: if bigger than max or smaller than min, returns NUM_OF_KEYS or 0 respectively.
+ * @details     Returns the key number restricted to a scale: if bigger than 
+ *              max or smaller than min, returns NUM_OF_KEYS or 0 respectively.
+ *              The key that specifies the beginning of the scale can be anywhere
+ *              between 1 and 88, but the frequency returned can be anywhere between
+ *              the highest and lowest frequency piano key frequency.
  *
  * @param       freq                   frequency
  * @param       keyThatBeginsScale     Pick a key on the piano that begins the scale
@@ -151,7 +248,7 @@ int Frequency::getClosestKeyNumInScale(float freq, int keyThatBeginsScale, int m
  */
 float Frequency::getClosestKeyFreqInScale(float freq, int keyThatBeginsScale, int majorOrMinor) {
     int keyNum = getClosestKeyNumInScale(freq, keyThatBeginsScale, majorOrMinor);
-    return keyFreq[keyNum];
+    return getFreqOfKeyNum(keyNum);
 }
 
 
@@ -167,6 +264,11 @@ float Frequency::getClosestKeyFreqInScale(float freq, int keyThatBeginsScale, in
  * ======================================================
  */
 const char* Frequency::getKeyName(int keynum) {
+    if (_tuning->divisions != NUM_OF_KEYS_IN_OCTAVE || _tuning->numKeys != NUM_PIANO_KEYS ||
+        keynum < FIRST_KEY || keynum > NUM_PIANO_KEYS) {
+        // Only the 12 key piano has names
+        return keys[0];
+    }
     return keys[keynum];
 }
 
@@ -182,11 +284,216 @@ const char* Frequency::getKeyName(int keynum) {
  * ======================================================
  */
 float Frequency::getFreqOfKeyNum(int key) {
-    if (key > NUM_PIANO_KEYS) {
-        return keyFreq[NUM_PIANO_KEYS];
+    const float* keyFreq = _tuning->keyFreq;
+    if (key > _tuning->numKeys) {
+        return keyFreq[_tuning->numKeys];
     } else if (key < FIRST_KEY) {
         return keyFreq[FIRST_KEY];
     }
     return keyFreq[key];
 }
 
+/** ====================================================
+ * @brief       Returns the period of a key in samples
+ *
+ * @details     Uses the period table of the tuning if it has one, which avoids
+ *              a division on devices without floating point hardware. Keys
+ *              outside of the tuning are clamped like Frequency::getFreqOfKeyNum.
+ *
+ * @param       key           Key number
+ * @param       fs            Sampling frequency
+ *
+ * @return      Key period (in samples)
+ *
+ * ======================================================
+ */
+float Frequency::getPeriodOfKeyNum(int key, long fs) {
+    if (key > _tuning->numKeys) {
+        key = _tuning->numKeys;
+    } else if (key < FIRST_KEY) {
+        key = FIRST_KEY;
+    }
+    if (_tuning->keyPeriod) {
+        return fs*_tuning->keyPeriod[key];
+    }
+    return fs/_tuning->keyFreq[key];
+}
+
+
+// Fast log2 =============================
+
+// log2 of a positive float: exponent from the bits, mantissa from an atanh series
+static inline float fastLog2(float x) {
+    union { float f; int i; } u;
+    u.f = x;
+    float e = (float)(((u.i >> 23) & 0xFF) - 127);
+    u.i = (u.i & 0x007FFFFF) | 0x3F800000; // mantissa in [1,2)
+    float t = (u.f - 1.0f)/(u.f + 1.0f);
+    float t2 = t*t;
+    float p = 0.11111111f;
+    p = p*t2 + 0.14285714f;
+    p = p*t2 + 0.2f;
+    p = p*t2 + 0.33333333f;
+    p = p*t2 + 1.0f;
+    return e + 2.88539008f*t*p; // 2/ln(2)
+}
+
+#if defined(__SSE2__)
+// Same arithmetic as fastLog2(), four lanes at a time
+static inline __m128 fastLog2x4(__m128 x) {
+    __m128i bits = _mm_castps_si128(x);
+    __m128 e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(bits, 23), _mm_set1_epi32(0xFF)), _mm_set1_epi32(127)));
+    __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000)));
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 t = _mm_div_ps(_mm_sub_ps(m, one), _mm_add_ps(m, one));
+    __m128 t2 = _mm_mul_ps(t, t);
+    __m128 p = _mm_set1_ps(0.11111111f);
+    p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(0.14285714f));
+    p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(0.2f));
+    p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(0.33333333f));
+    p = _mm_add_ps(_mm_mul_ps(p, t2), one);
+    return _mm_add_ps(e, _mm_mul_ps(_mm_set1_ps(2.88539008f), _mm_mul_ps(t, p)));
+}
+#endif
+
+/** ====================================================
+ * @brief       Quantizes a whole pitch track to a scale.
+ *
+ * @details     Batch version of Frequency::getClosestKeyNumInScaleMask meant
+ *              for offline pitch tracks. Every frequency is converted to a
+ *              fractional key number with a polynomial log2 approximation
+ *              (four at a time with SSE2 when available), and snapped to the
+ *              scale with two tables of the closest scale keys below and
+ *              above every key, built once per call, so there are no
+ *              searches, divisions or data-dependent branches in the inner
+ *              loops. Only the log2 step is SIMD: the snap is a scalar loop
+ *              with four table loads per frequency. Tunings of more than
+ *              256 keys or 32 divisions fall back to
+ *              Frequency::getClosestKeyNumInScaleMask, one frequency at a
+ *              time.
+ *
+ *              Like Frequency::getClosestKeyNumInScaleMask, the closest key
+ *              is chosen in Hz (a frequency halfway between two keys goes
+ *              to the upper one), so both return the same keys. Frequencies
+ *              <= 0 (pitchless frames) produce key 0, frequency 0 and 0
+ *              cents.
+ *
+ * @param       in                     Input frequencies (Hz)
+ * @param       n                      Number of frequencies
+ * @param       keyThatBeginsScale     Pick a key on the piano that begins the scale
+ * @param       scaleMask              Keys of the scale relative to the tonic (0 = chromatic)
+ * @param       outFreq                Frequency of the closest key in the scale (may be 0)
+ * @param       outKey                 Closest key number in the scale (may be 0)
+ * @param       outCents               Deviation of the input from that key in cents (may be 0)
+ *
+ * ======================================================
+ */
+void Frequency::quantizeBatch(const float* in, int n, int keyThatBeginsScale, unsigned long scaleMask,
+                              float* outFreq, int* outKey, float* outCents) {
+    const float* keyFreq = _tuning->keyFreq;
+    int numKeys = _tuning->numKeys;
+    int divisions = _tuning->divisions;
+    if (n <= 0) {
+        return;
+    }
+    if (divisions > MAX_DIVISIONS || numKeys > MAX_QUANTIZE_KEYS) {
+        // Too large for the tables: one search per frequency
+        for (int i = 0; i < n; i++) {
+            int key = (in[i] > 0.0f) ? getClosestKeyNumInScaleMask(in[i], keyThatBeginsScale, scaleMask) : 0;
+            key = (key < 0) ? 0 : key;
+            if (outKey) {
+                outKey[i] = key;
+            }
+            if (outFreq) {
+                outFreq[i] = key ? keyFreq[key] : 0.0f;
+            }
+            if (outCents) {
+                outCents[i] = key ? 1200.0f*(fastLog2(in[i]) - fastLog2(keyFreq[key])) : 0.0f;
+            }
+        }
+        return;
+    }
+    if (scaleMask == 0) {
+        scaleMask = ~0UL;
+    }
+    keyThatBeginsScale = ((keyThatBeginsScale - 1) % divisions) + 1;
+    
+    // Distance from every key of an octave down (up) to the closest key of the scale
+    int down[MAX_DIVISIONS];
+    int up[MAX_DIVISIONS];
+    for (int d = 0; d < divisions; d++) {
+        down[d] = 0;
+        while (!((scaleMask >> ((d - down[d] + divisions) % divisions)) & 1) && down[d] < divisions) {
+            down[d]++;
+        }
+        up[d] = 0;
+        while (!((scaleMask >> ((d + up[d]) % divisions)) & 1) && up[d] < divisions) {
+            up[d]++;
+        }
+    }
+    // Lowest and highest keys in the scale bound the result
+    int first = FIRST_KEY + up[(FIRST_KEY - keyThatBeginsScale + divisions) % divisions];
+    int last = numKeys - down[(numKeys - keyThatBeginsScale + divisions) % divisions];
+    // key(f) = referenceKey + divisions*log2(f/referencePitch)
+    float scale = (float)divisions;
+    float offset = _tuning->referenceKey - scale*fastLog2(_tuning->referencePitch);
+    // Shifting by whole octaves keeps the key degree positive
+    int octaveBias = divisions*(numKeys/divisions + 2) - keyThatBeginsScale;
+    float centsPerKey = 1200.0f/divisions;
+    // Closest key of the scale at or below every key, and the next one above it
+    //  (the lower one past the last key), so snapping is two loads per frequency
+    short lowerKey[MAX_QUANTIZE_KEYS + 1];
+    short upperKey[MAX_QUANTIZE_KEYS + 1];
+    for (int key = first; key <= last; key++) {
+        lowerKey[key] = key - down[(key + octaveBias) % divisions];
+        int next = (key + 1) + up[(key + 1 + octaveBias) % divisions];
+        upperKey[key] = (next > last) ? lowerKey[key] : next;
+    }
+    
+    float x[QUANTIZE_CHUNK];
+    for (int start = 0; start < n; start += QUANTIZE_CHUNK) {
+        int len = (n - start < QUANTIZE_CHUNK) ? n - start : QUANTIZE_CHUNK;
+        const float* src = in + start;
+        
+        // Fractional key numbers
+        int i = 0;
+#if defined(__SSE2__)
+        __m128 vScale = _mm_set1_ps(scale);
+        __m128 vOffset = _mm_set1_ps(offset);
+        __m128 vTiny = _mm_set1_ps(1e-30f);
+        for (; i + 4 <= len; i += 4) {
+            __m128 f = _mm_max_ps(_mm_loadu_ps(src + i), vTiny);
+            _mm_storeu_ps(x + i, _mm_add_ps(_mm_mul_ps(fastLog2x4(f), vScale), vOffset));
+        }
+#endif
+        for (; i < len; i++) {
+            float f = (src[i] > 1e-30f) ? src[i] : 1e-30f;
+            x[i] = fastLog2(f)*scale + offset;
+        }
+        
+        // Snap to the scale
+        for (i = 0; i < len; i++) {
+            float k = x[i];
+            k = (k < first) ? (float)first : k;
+            k = (k > last) ? (float)last : k;
+            int below = (int)k;
+            int lower = lowerKey[below];
+            int upper = upperKey[below];
+            // Nearest in Hz, ties going up, like getClosestKeyNumInScaleMask()
+            float lowerFreq = keyFreq[lower];
+            float upperFreq = keyFreq[upper];
+            int down = src[i] - lowerFreq < upperFreq - src[i];
+            int key = down ? lower : upper;
+            int voiced = src[i] > 0.0f;
+            if (outKey) {
+                outKey[start + i] = voiced ? key : 0;
+            }
+            if (outFreq) {
+                outFreq[start + i] = voiced ? (down ? lowerFreq : upperFreq) : 0.0f;
+            }
+            if (outCents) {
+                outCents[start + i] = voiced ? (x[i] - key)*centsPerKey : 0.0f;
+            }
+        }
+    }
+}
@@ -0,0 +1,246 @@
+/**
+ *   @mainpage Streaming Key Detection Module
+ *
+ *   \section desc_sec Description
+ *   This module estimates the key (tonic and major/minor) of a performance
+ *      from the output of a pitch detector, so the pitch correction does not
+ *      need to be told which scale to snap to. Every voiced frame adds its
+ *      pitch class to a histogram whose older entries decay exponentially,
+ *      which lets the estimate follow a key change.
+ *
+ *  @n The histogram is compared against the Krumhansl-Kessler key profiles
+ *      of all 24 major and minor keys, and the key with the highest
+ *      correlation wins. The cost of a frame is constant: 12 multiplies to
+ *      decay the histogram and, every few frames, 24 correlations of 12
+ *      terms each.
+ *
+ *  \section contents_sec Table of Contents
+ *    KeyDetector.cpp
+ *
+ *    KeyDetector.h
+ *
+ */
+
+/**
+ *  @file KeyDetector.cpp
+ *  @brief Source file for KeyDetector
+ *  @file KeyDetector.h
+ *  @brief Header file for KeyDetector
+ */
+
+#include "KeyDetector.h"
+#include "Frequency.h"
+#include <math.h>
+
+/** Key number of the reference pitch, used to find the pitch class */
+#define REFERENCE_KEY           A4_KEY
+
+/** A new key has to beat the current one by this much correlation to replace it */
+#define KEY_SWITCH_MARGIN       0.05
+
+/** Histogram is rescaled when it grows past this value */
+#define HISTOGRAM_LIMIT         1.0e6
+
+/**
+ Krumhansl-Kessler major profile, mean removed and normalized to unit length.
+ Index 0 is the tonic.
+ */
+const float majorProfile[NUM_PITCH_CLASSES] = {0.6553,-0.2862,-0.0006,-0.2634,0.2051,0.1388,-0.2200,0.3902,-0.2497,0.0406,-0.2725,-0.1377};
+
+/**
+ Krumhansl-Kessler minor profile, mean removed and normalized to unit length.
+ Index 0 is the tonic.
+ */
+const float minorProfile[NUM_PITCH_CLASSES] = {0.6551,-0.2572,-0.0473,0.4176,-0.2772,-0.0448,-0.2922,0.2602,0.0677,-0.2547,-0.0923,-0.1348};
+
+/** Names of the pitch classes, indexed by the *_SCALE constants */
+const char* const scaleNames[NUM_PITCH_CLASSES + 1] = {"?", "A", "A#", "B", "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#"};
+
+/** ==============================================================================
+ * @brief       Initializes the key detector.
+ *
+ * @details     The detector reports C major until it has seen
+ *              DEFAULT_MIN_VOICED_FRAMES voiced frames.
+ *
+ * @param       decay              Histogram decay per voiced frame (0 < decay <= 1)
+ * @param       framesPerUpdate    Number of voiced frames between key correlations
+ * ================================================================================
+ */
+KeyDetector::KeyDetector(float decay, int framesPerUpdate) {
+    // Error Handle
+    if (decay <= 0 || decay > 1) {
+        _decay = DEFAULT_KEY_DECAY;
+    } else {
+        _decay = decay;
+    }
+    if (framesPerUpdate < 1) {
+        _framesPerUpdate = DEFAULT_FRAMES_PER_UPDATE;
+    } else {
+        _framesPerUpdate = framesPerUpdate;
+    }
+    _referencePitch = DEFAULT_KEY_REFERENCE;
+    reset();
+}
+
+/** ====================================================
+ * @brief       Sets the frequency of A4 the pitches are binned against.
+ *
+ * @details     With a reference other than the one the singer is tuned to,
+ *              every pitch class drifts by the difference, up to a semitone.
+ *              Takes effect on the next pitch; the histogram is kept.
+ *
+ * @param       referencePitch     Frequency of A4 (Hz), <= 0 for DEFAULT_KEY_REFERENCE
+ *
+ * ======================================================
+ */
+void KeyDetector::setReference(float referencePitch) {
+    // Error Handle
+    if (referencePitch <= 0) {
+        _referencePitch = DEFAULT_KEY_REFERENCE;
+    } else {
+        _referencePitch = referencePitch;
+    }
+}
+
+/** Forgets everything that was learned and goes back to C major */
+void KeyDetector::reset() {
+    for (int i = 0; i < NUM_PITCH_CLASSES; i++) {
+        _histogram[i] = 0.0;
+    }
+    _framesSinceUpdate = 0;
+    _voicedFrames = 0;
+    _scale = C_SCALE;
+    _majorOrMinor = MAJOR_SCALE;
+    _confidence = 0.0;
+}
+
+/** ====================================================
+ * @brief       Adds a detected pitch to the histogram.
+ *
+ * @details     Decays the histogram, adds the pitch class of freq and, once
+ *              every framesPerUpdate voiced frames, correlates the histogram
+ *              against all 24 keys.
+ *
+ * @param       freq        Output of the pitch detector (0.0 = pitchless)
+ *
+ * ======================================================
+ */
+void KeyDetector::addPitch(float freq) {
+    if (freq <= 0) {
+        return;
+    }
+    // Pitch class relative to A (0 = A, 1 = A#, ..., 11 = G#)
+    int key = (int)floor(NUM_PITCH_CLASSES*log(freq/_referencePitch)/log(2.0) + 0.5) + REFERENCE_KEY;
+    int pitchClass = (key - 1) % NUM_PITCH_CLASSES;
+    if (pitchClass < 0) {
+        pitchClass += NUM_PITCH_CLASSES;
+    }
+
+    // Exponential decay
+    for (int i = 0; i < NUM_PITCH_CLASSES; i++) {
+        _histogram[i] *= _decay;
+    }
+    _histogram[pitchClass] += 1.0;
+
+    if (_voicedFrames < DEFAULT_MIN_VOICED_FRAMES) {
+        _voicedFrames++;
+    }
+    _framesSinceUpdate++;
+    if (_framesSinceUpdate >= _framesPerUpdate && _voicedFrames >= DEFAULT_MIN_VOICED_FRAMES) {
+        _framesSinceUpdate = 0;
+        correlate();
+    }
+}
+
+// Correlate the histogram with every major and minor key
+void KeyDetector::correlate() {
+    float mean = 0.0;
+    for (int i = 0; i < NUM_PITCH_CLASSES; i++) {
+        mean += _histogram[i];
+    }
+    mean /= NUM_PITCH_CLASSES;
+    float norm = 0.0;
+    float centered[NUM_PITCH_CLASSES];
+    for (int i = 0; i < NUM_PITCH_CLASSES; i++) {
+        centered[i] = _histogram[i] - mean;
+        norm += centered[i]*centered[i];
+    }
+    if (norm <= 0.0) {
+        return;
+    }
+    norm = sqrt(norm);
+
+    // The profiles have zero mean and unit length, so the dot product with the
+    //  centered histogram divided by its length is the Pearson correlation
+    float bestCorr = -2.0;
+    int bestTonic = 0;
+    int bestMode = MAJOR_SCALE;
+    float currentCorr = -2.0;
+    for (int tonic = 0; tonic < NUM_PITCH_CLASSES; tonic++) {
+        float major = 0.0;
+        float minor = 0.0;
+        int degree = NUM_PITCH_CLASSES - tonic;
+        for (int i = 0; i < NUM_PITCH_CLASSES; i++) {
+            if (degree == NUM_PITCH_CLASSES) {
+                degree = 0;
+            }
+            major += centered[i]*majorProfile[degree];
+            minor += centered[i]*minorProfile[degree];
+            degree++;
+        }
+        major /= norm;
+        minor /= norm;
+        if (major > bestCorr) {
+            bestCorr = major;
+            bestTonic = tonic;
+            bestMode = MAJOR_SCALE;
+        }
+        if (minor > bestCorr) {
+            bestCorr = minor;
+            bestTonic = tonic;
+            bestMode = MINOR_SCALE;
+        }
+        if (tonic + 1 == _scale) {
+            currentCorr = (_majorOrMinor == MAJOR_SCALE) ? major : minor;
+        }
+    }
+
+    // Only switch keys when the new one is clearly better
+    if (bestCorr > currentCorr + KEY_SWITCH_MARGIN || _confidence == 0.0) {
+        _scale = bestTonic + 1;
+        _majorOrMinor = bestMode;
+        _confidence = bestCorr;
+    } else {
+        _confidence = currentCorr;
+    }
+
+    // Keep the histogram in range when the decay is close to 1
+    if (mean*NUM_PITCH_CLASSES > HISTOGRAM_LIMIT) {
+        for (int i = 0; i < NUM_PITCH_CLASSES; i++) {
+            _histogram[i] /= HISTOGRAM_LIMIT;
+        }
+    }
+}
+
+/** Returns the detected tonic as one of the *_SCALE constants (A_SCALE ... Gs_SCALE) */
+int KeyDetector::getScale() {
+    return _scale;
+}
+
+/** Returns MAJOR_SCALE or MINOR_SCALE */
+int KeyDetector::getMajorOrMinor() {
+    return _majorOrMinor;
+}
+
+/** Returns the correlation of the histogram with the detected key (0.0 until a key has been detected) */
+float KeyDetector::getConfidence() {
+    return _confidence;
+}
+
+/** Returns the name of the pitch class of a *_SCALE constant, without an octave */
+const char* KeyDetector::getScaleName(int scale) {
+    if (scale < A_SCALE || scale > Gs_SCALE) {
+        return scaleNames[0];
+    }
+    return scaleNames[scale];
+}
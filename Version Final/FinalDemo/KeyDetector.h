@@ -0,0 +1,53 @@
+//
+//  KeyDetector.h
+//
+//
+//  Streaming key/scale detection from detected pitches.
+//
+//
+
+#ifndef ____KeyDetector__
+#define ____KeyDetector__
+
+#include <stdio.h>
+
+#define NUM_PITCH_CLASSES           12
+#define DEFAULT_KEY_DECAY           0.995
+#define DEFAULT_FRAMES_PER_UPDATE   4
+#define DEFAULT_MIN_VOICED_FRAMES   32
+#define DEFAULT_KEY_REFERENCE       440.0   // A4 (Hz)
+
+class KeyDetector {
+public:
+    // decay is applied to the histogram on every voiced frame (0 < decay <= 1)
+    KeyDetector(float decay = DEFAULT_KEY_DECAY, int framesPerUpdate = DEFAULT_FRAMES_PER_UPDATE);
+    // Feed one detector output; pitchless frames (freq <= 0) are ignored
+    void addPitch(float freq);
+    // Frequency of A4 the pitches are binned against, e.g. the referencePitch of the
+    //  TuningTable in use (kept by reset(); <= 0 goes back to DEFAULT_KEY_REFERENCE)
+    void setReference(float referencePitch);
+    float getReference() const { return _referencePitch; }
+    // Returns one of the *_SCALE constants in Frequency.h
+    int getScale();
+    // Returns MAJOR_SCALE or MINOR_SCALE
+    int getMajorOrMinor();
+    // Correlation of the histogram with the detected key (-1 to 1)
+    float getConfidence();
+    // Pitch class name of a *_SCALE constant ("A" ... "G#"), "?" if out of range
+    static const char* getScaleName(int scale);
+    void reset();
+
+private:
+    void correlate();
+    float _histogram[NUM_PITCH_CLASSES];
+    float _decay;
+    float _referencePitch;
+    int _framesPerUpdate;
+    int _framesSinceUpdate;
+    int _voicedFrames;
+    int _scale;
+    int _majorOrMinor;
+    float _confidence;
+};
+
+#endif /* defined(____KeyDetector__) */
@@ -1,55 +1,60 @@
 /**
- *   @mainpage "@mainpage" TAG WRITES HERE
+ *   @mainpage Time-Domain Pitch Synchronous Overlap and Add Method (TD-PSOLA)
  *   @author Terry Kong
- *   @date Feb. 28, 2014
+ *   @date Mar. 9, 2015
  *
  *   \section desc_sec Description
- *   need to finish writing the description
+ *   This is a crude implementation of the well known Time-Domain Pitch 
+ *      Synchronous and Add method used for pitch shifting. This implementation
+ *      does not deal with the phase inconsistencies that are introduced when 
+ *      pitch correcting window by window. If your application deals with
+ *      very short windows relative to your sampling frequency, there will be a
+ *      significant "talking-into-a-fan" effect. My advice would be to use this
+ *      on a significantly long piece of audio. 
+ *
+ *  @n This implementation uses Q15 arithmetic, which on the C5535 is represented
+ *      as an int.
+ *
+ *  @n Generally this algorithm involves locating all the time epochs in the
+ *      analysis window and mapping them to the synthesis epochs. This
+ *      implementation does not locate the time epochs in the analysis window.
+ *      This makes the algorithm less robust, and generally causes a degredation
+ *      in the signal quality as well as introducting some distortion. 
+ *
+ *  @n Future work includes implementing a peak finding algorithm. However,
+ *      depending on your application this might not be desirable since 
+ *      peak finding algorithms add a significant overhead to this algorithm.
+
  *
  *  \section contents_sec Table of Contents
  *    PSOLA.cpp
  *
+ *    PSOLA.h
+ *
  *
  */
 
 /**
- *  @file PSOLA.cpp ("@file" TAG WRITES HERE)
- *  @brief ("@brief" TAG WRITES HERE)
- *  @details    More verbose file description.
+ *  @file PSOLA.cpp
+ *  @brief Source file for PSOLA algorithm
+ *  @file PSOLA.h
+ *  @brief Header file for PSOLA algorithm
  */
 
 #include "PSOLA.h"
+#include "FixedPoint.h"
+#include "CostModel.h"
 #include <math.h>
+#include <limits.h>
 
 #define DEFAULT_BUFFER_SIZE 512
-#define FIXED_BITS        16
-#define FIXED_WBITS       0
-#define FIXED_FBITS       15
-#define Q15_RESOLUTION   (1 << (FIXED_FBITS - 1))
-#define LARGEST_Q15_NUM   32767
-
-// Some helper functions ==================
-
-// Q15 multiplication
-int Q15mult(int x, int y) {
-    long temp = (long)x * (long)y;
-    temp += Q15_RESOLUTION;
-    return temp >> FIXED_FBITS;
-}
-
-// Q15 wrapped addition
-int Q15addWrap(int x, int y) {
-    return x + y;
-}
-
-// Q15 saturation addition
-int Q15addSat(int x, int y) {
-    long temp = (long)x+(long)y;
-    if (temp > 0x7FFFFFFF) temp = 0x7FFFFFFF;
-    if (temp < -1*0x7FFFFFFF) temp = -1*0x7FFFFFFF;
-    return (int)temp;
-}
 
+#ifdef PV_PROFILE
+/** Names of the PSOLA_PROFILE_* slots */
+static const char* const profileNames[PSOLA_PROFILE_SLOTS] = {
+    "storage", "window", "overlap and add", "write back"
+};
+#endif
 
 /** ==============================================================================
  * @brief       Function initializes the pitch correction module.
@@ -60,27 +65,89 @@ int Q15addSat(int x, int y) {
  *
  * @param       bufferLen       Number of data the module expects when pitchCorrect() is called in order to optimize performance.
  *
- * @see         
+ * @see
  *              E.moulines and W. Verhelst. Time-domain and frequency-domain techniques for prosodic modifications of speech. In W. Bastiaan Kleijn and K.K. Paliwal, editors, Speech Coding and Synthesis, chapter 15, pages 519-555. Elsevier, 1995.
  * ================================================================================
  */
-PSOLA::PSOLA(int bufferLen) {
+template<class SampleT, class AccT>
+BasicPSOLA<SampleT, AccT>::BasicPSOLA(int bufferLen) {
+    init(bufferLen, 0);
+}
+
+/** ====================================================
+ * @brief       Initializes a pitch correction module whose buffers are in an arena.
+ *
+ * @details     Same as the other constructor, but the buffers are taken from
+ *              arena, so creating the module allocates nothing and destroying
+ *              it frees nothing. Falls back to the heap if the arena has less
+ *              than getArenaSize() bytes left.
+ *
+ * @param       bufferLen       Number of data the module expects when pitchCorrect() is called
+ * @param       arena           Arena to take the buffers from; must outlive the module
+ * ======================================================
+ */
+template<class SampleT, class AccT>
+BasicPSOLA<SampleT, AccT>::BasicPSOLA(int bufferLen, Arena& arena) {
+    init(bufferLen, (arena.getRemaining() >= getArenaSize(bufferLen)) ? &arena : 0);
+}
+
+// n Ts from the arena, or from the heap if there is none (not initialized)
+template<class T> static T* psolaAllocate(Arena* arena, int n) {
+    return arena ? arena->allocateArray<T>(n) : new T[n];
+}
+
+/** Initializes the module, taking its buffers from arena (0 = the heap) */
+template<class SampleT, class AccT>
+void BasicPSOLA<SampleT, AccT>::init(int bufferLen, Arena* arena) {
     if (bufferLen < 1) {
         _bufferLen = DEFAULT_BUFFER_SIZE;
     } else {
         _bufferLen = bufferLen;
     }
-    _buffer = new int[2*bufferLen];
+    // allow for twice the room to deal with the case when the end of the buffer may not be sufficient
+    _workingBuffer = psolaAllocate<SampleT>(arena, 2*_bufferLen);
+    // allow for twice the room so we can move new data into this buffer
+    _storageBuffer = psolaAllocate<SampleT>(arena, 2*_bufferLen);
     // allocates maximum size for window to avoid reinitialization cost
-    _window = new int[bufferLen];
+    _window = psolaAllocate<SampleT>(arena, _bufferLen);
+    // Overlap and add accumulates into the working buffer and the first call
+    //  slides the storage buffer, so both start silent (the window is built
+    //  before every use)
+    for (int i = 0; i < 2*_bufferLen; i++) {
+        _workingBuffer[i] = 0;
+        _storageBuffer[i] = 0;
+    }
+    _ownsBuffers = !arena;
+    PV_PROFILE_ONLY(_profile.setSlots(profileNames, PSOLA_PROFILE_SLOTS));
 }
 
-/** Standard destructor */
-PSOLA::~PSOLA() {
-    delete[] _buffer;
+/** Standard destructor (the buffers in an arena go away with the arena) */
+template<class SampleT, class AccT>
+BasicPSOLA<SampleT, AccT>::~BasicPSOLA() {
+    if (!_ownsBuffers) {
+        return;
+    }
+    delete[] _workingBuffer;
+    delete[] _storageBuffer;
     delete[] _window;
 }
 
+/** ====================================================
+ * @brief       Bytes of an arena the buffers of a pitch correction module take.
+ *
+ * @param       bufferLen       Number of data given to the constructor
+ *
+ * @return      Size to reserve in an arena for a module built with bufferLen
+ * ======================================================
+ */
+template<class SampleT, class AccT>
+size_t BasicPSOLA<SampleT, AccT>::getArenaSize(int bufferLen) {
+    if (bufferLen < 1) {
+        bufferLen = DEFAULT_BUFFER_SIZE;
+    }
+    return 2*Arena::sizeOfArray<SampleT>(2*bufferLen) + Arena::sizeOfArray<SampleT>(bufferLen);
+}
+
 /** ====================================================
  * @brief       Corrects the pitch of the input
  *
@@ -95,25 +162,53 @@ PSOLA::~PSOLA() {
  *
  * ======================================================
  */
-void PSOLA::pitchCorrect(int* input, int Fs, float inputPitch, float desiredPitch) {
+template<class SampleT, class AccT>
+void BasicPSOLA<SampleT, AccT>::pitchCorrect(SampleT* input, int Fs, float inputPitch, float desiredPitch) {
+    // Counted views of the pitches and buffers when built with PV_COST
+    typedef typename CostType<SampleT>::Value Sample;
+    typedef typename CostType<AccT>::Value Acc;
+    typename CostType<SampleT>::Array workingBuffer = costArray(_workingBuffer);
+    typename CostType<SampleT>::Array storageBuffer = costArray(_storageBuffer);
+    typename CostType<SampleT>::Array window = costArray(_window);
+    CostFloat analysisPitch = inputPitch;
+    CostFloat synthesisPitch = desiredPitch;
+    PV_PROFILE_START(watch);
+    // Move things into the storage buffer
+    for (int i = 0; i < _bufferLen; i++) {
+        //slide the past data into the front
+        storageBuffer[i] = storageBuffer[i + _bufferLen];
+        //load up next set of data
+        storageBuffer[i + _bufferLen] = input[i];
+    }
+    PV_PROFILE_LAP(_profile, PSOLA_PROFILE_STORAGE, watch);
+    // Nothing to do without a pitch
+    if (analysisPitch <= 0 || synthesisPitch <= 0) {
+        return;
+    }
     // Percent change of frequency
-    float scalingFactor = 1 + (inputPitch - desiredPitch)/desiredPitch;
+    CostFloat scalingFactor = 1 + (analysisPitch - synthesisPitch)/synthesisPitch;
     // PSOLA constants
-    int analysisShift = ceil(Fs/inputPitch);
-    int analysisShiftHalfed = round(analysisShift/2);
-    int synthesisShift = round(analysisShift*scalingFactor);
+    int analysisShift = costValue(ceil(Fs/analysisPitch));
+    int analysisShiftHalfed = costValue(round(analysisShift/2));
+    int synthesisShift = costValue(round(analysisShift*scalingFactor));
     int analysisIndex = -1;
     int synthesisIndex = 0;
     int analysisBlockStart;
     int analysisBlockEnd;
     int synthesisBlockEnd;
+    int tailEnd = _bufferLen;   // one past the last sample the overlap and add touched
     int analysisLimit = _bufferLen - analysisShift - 1;
     // Window declaration
     int winLength = analysisShift + analysisShiftHalfed + 1;
-    int windowIndex;
+    // The window must fit in the buffer (pitch too low for this buffer length)
+    if (winLength > _bufferLen) {
+        return;
+    }
     bartlett(_window,winLength);
+    PV_PROFILE_LAP(_profile, PSOLA_PROFILE_WINDOW, watch);
     // PSOLA Algorithm
-    while (analysisIndex < analysisLimit) {
+    // Synthesis past the end of the buffer is never written back
+    while (analysisIndex < analysisLimit && synthesisIndex < _bufferLen) {
         // Analysis blocks are two pitch periods long
         analysisBlockStart = (analysisIndex + 1) - analysisShiftHalfed;
         if (analysisBlockStart < 0) {
@@ -125,10 +220,14 @@ void PSOLA::pitchCorrect(int* input, int Fs, float inputPitch, float desiredPitc
         }
         // Overlap and add
         synthesisBlockEnd = synthesisIndex + analysisBlockEnd - analysisBlockStart;
+        if (synthesisBlockEnd >= tailEnd) {
+            tailEnd = synthesisBlockEnd + 1;
+        }
         int inputIndex = analysisBlockStart;
         int windowIndex = 0;
         for (int j = synthesisIndex; j <= synthesisBlockEnd; j++) {
-            _buffer[j] = Q15addWrap(_buffer[j], Q15mult(input[inputIndex],_window[windowIndex]) );
+            // Not saturated: the window is never -1, so the product always fits
+            workingBuffer[j] = q15AddWrapRaw<Sample>(workingBuffer[j], q15MulRoundRaw<Acc>((Sample)input[inputIndex], window[windowIndex]));
             inputIndex++;
             windowIndex++;
         }
@@ -136,12 +235,35 @@ void PSOLA::pitchCorrect(int* input, int Fs, float inputPitch, float desiredPitc
         analysisIndex += analysisShift;
         synthesisIndex += synthesisShift;
     }
+    PV_PROFILE_LAP(_profile, PSOLA_PROFILE_OLA, watch);
     // Write back to input
     for (int i = 0; i < _bufferLen; i++) {
-        input[i] = _buffer[i];
+        input[i] = costValue(workingBuffer[i]);
         // clean out the buffer
-        _buffer[i] = 0;
+        workingBuffer[i] = 0;
+    }
+    // The overlap past the end of the buffer is not written back either; left
+    //  there it would pile up from call to call until it overflowed
+    for (int i = _bufferLen; i < tailEnd; i++) {
+        workingBuffer[i] = 0;
     }
+    PV_PROFILE_LAP(_profile, PSOLA_PROFILE_WRITE_BACK, watch);
+}
+
+/** Time spent in each phase of PSOLA::pitchCorrect(), 0 unless built with PV_PROFILE */
+template<class SampleT, class AccT>
+const Profile* BasicPSOLA<SampleT, AccT>::getProfile() const {
+#ifdef PV_PROFILE
+    return &_profile;
+#else
+    return 0;
+#endif
+}
+
+/** Clears the profile */
+template<class SampleT, class AccT>
+void BasicPSOLA<SampleT, AccT>::resetProfile() {
+    PV_PROFILE_ONLY(_profile.reset());
 }
 
 /** ====================================================
@@ -149,7 +271,7 @@ void PSOLA::pitchCorrect(int* input, int Fs, float inputPitch, float desiredPitc
  *
  * @details     Computes a bartlett window in-place with Q15 coefficients quickly
  *
- * @param       window           Pointer to array of Q15 data (bufferLen long)
+ * @param       coefficients     Pointer to array of Q15 data (bufferLen long)
  * @param       length           Length of the window
  *
  * @todo        More accurate implementation of bartlett window
@@ -158,7 +280,11 @@ void PSOLA::pitchCorrect(int* input, int Fs, float inputPitch, float desiredPitc
  *
  * ======================================================
  */
-void PSOLA::bartlett(int* window, int length) {
+template<class SampleT, class AccT>
+void BasicPSOLA<SampleT, AccT>::bartlett(SampleT* coefficients, int length) {
+    typedef typename CostType<SampleT>::Value Sample;
+    typedef typename CostType<AccT>::Value Acc;
+    typename CostType<SampleT>::Array window = costArray(coefficients);
     if (length < 1) return;
     if (length == 1) {
         window[0] = 1;
@@ -167,23 +293,25 @@ void PSOLA::bartlett(int* window, int length) {
     
     int N = length - 1;
     int middle = N >> 1;
-    int slope = round( ((float)(1<<(FIXED_FBITS-1)))/N*4 );
+    Sample slope = (int)round( ((float)Q15_ROUND)/N*4 );
+    // The rounded slope can overshoot the largest Q15 number near the middle,
+    //  which would wrap to a negative coefficient in 16 bits
     if (N%2 == 0) {
         // N even = L odd
         window[0] = 0;
         for (int i = 1; i <= middle; i++) {
-            window[i] = window[i-1] + slope;
+            window[i] = q15AddSatRaw<Acc>(window[i-1], slope);
         }
         for (int i = middle+1; i <= N; i++) {
             window[i] = window[N - i];
         }
         // double check that the middle value is the maximum Q15 number
-        window[middle] = LARGEST_Q15_NUM;
+        window[middle] = Q15_MAX;
     } else {
         // N odd = L even
         window[0] = 0;
         for (int i = 1; i <= middle; i++) {
-            window[i] = window[i-1] + slope;
+            window[i] = q15AddSatRaw<Acc>(window[i-1], slope);
         }
         window[middle + 1] = window[middle];
         for (int i = middle+1; i <= N; i++) {
@@ -191,3 +319,10 @@ void PSOLA::bartlett(int* window, int length) {
         }
     }
 }
+
+// The instantiations in use (see FLWT.cpp)
+template class BasicPSOLA<int, long>;
+#if INT_MAX > 32767 && !defined(PV_COST)
+template class BasicPSOLA<int16_t, int32_t>;
+template class BasicPSOLA<float, float>;
+#endif
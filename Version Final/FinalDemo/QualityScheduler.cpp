@@ -0,0 +1,229 @@
+/**
+ *   @mainpage Load-Shedding Quality Scheduler
+ *
+ *   \section desc_sec Description
+ *   Keeps the pitch correction inside its time budget when the processor
+ *      falls behind. Instead of letting a late frame glitch the output, the
+ *      scheduler measures every frame against the time available for it
+ *      (one buffer period) and steps the processing down a quality ladder:
+ *
+ *      <ol>
+ *         <li> QUALITY_FULL : FLWT with all levels, PSOLA on both channels
+ *         <li> QUALITY_REDUCED_LEVELS : FLWT searches fewer levels
+ *         <li> QUALITY_CACHED_PITCH : the previous pitch is reused
+ *         <li> QUALITY_MONO : only the left channel is corrected and copied to the right
+ *         <li> QUALITY_BYPASS : the input is passed through
+ *      </ol>
+ *
+ *  @n A frame that uses more than the step down load steps down one level
+ *      (two if it overran the whole budget). Stepping back up needs a run of
+ *      calm frames and a smoothed cost of the level above that is expected
+ *      to fit under the lower step up load, so the ladder does not oscillate
+ *      between two levels. The cost of a level that is not running is slowly
+ *      forgotten so a temporary load does not keep the quality down forever.
+ *      setLimit() keeps the ladder from climbing above a level the user
+ *      picked, e.g. to save power.
+ *
+ *  @n All arithmetic is on integers in microseconds, which suits the C5535.
+ *
+ *  \section contents_sec Table of Contents
+ *    QualityScheduler.cpp
+ *
+ *    QualityScheduler.h
+ *
+ */
+
+/**
+ *  @file QualityScheduler.cpp
+ *  @brief Source file for QualityScheduler
+ *  @file QualityScheduler.h
+ *  @brief Header file for QualityScheduler
+ */
+
+#include "QualityScheduler.h"
+
+/** Smoothing of the cost estimates (new = old + (frame - old)/2^COST_SHIFT) */
+#define COST_SHIFT              3
+
+/** Estimates of levels that are not running lose 1/2^FORGET_SHIFT per calm frame */
+#define FORGET_SHIFT            7
+
+/** ==============================================================================
+ * @brief       Initializes the scheduler at QUALITY_FULL.
+ *
+ * @param       budgetUs        Time available per frame in microseconds
+ * @param       stepDownLoad    Percentage of the budget above which a frame steps down
+ * @param       stepUpLoad      Percentage of the budget the level above must be
+ *                              expected to fit in before stepping up
+ * @param       stepUpFrames    Calm frames needed in a row before stepping up
+ * ================================================================================
+ */
+QualityScheduler::QualityScheduler(unsigned long budgetUs, int stepDownLoad, int stepUpLoad, int stepUpFrames) {
+    // Error Handle
+    if (stepDownLoad < 1 || stepDownLoad > 100) {
+        stepDownLoad = DEFAULT_STEP_DOWN_LOAD;
+    }
+    if (stepUpLoad < 1 || stepUpLoad >= stepDownLoad) {
+        stepUpLoad = (stepDownLoad*DEFAULT_STEP_UP_LOAD)/DEFAULT_STEP_DOWN_LOAD;
+    }
+    if (stepUpFrames < 1) {
+        stepUpFrames = DEFAULT_STEP_UP_FRAMES;
+    }
+    _budgetUs = budgetUs;
+    _stepDownLoad = stepDownLoad;
+    _stepUpLoad = stepUpLoad;
+    _stepUpFrames = stepUpFrames;
+    _limit = QUALITY_FULL;
+    reset();
+}
+
+/** Goes back to the best level allowed and clears the telemetry and cost estimates */
+void QualityScheduler::reset() {
+    _level = _limit;
+    _calmFrames = 0;
+    for (int i = 0; i < NUM_QUALITY_LEVELS; i++) {
+        _cost[i] = 0;
+        _entries[i] = 0;
+        _framesAt[i] = 0;
+    }
+    _frames = 0;
+    _overruns = 0;
+    _stepDowns = 0;
+    _stepUps = 0;
+    _lastUs = 0;
+    _worstUs = 0;
+}
+
+/** ====================================================
+ * @brief       Limits the quality the ladder may climb to.
+ *
+ * @details     A level better than the limit steps down to it at once; the
+ *              ladder still steps down from the limit under load.
+ *
+ * @param       level       Best QUALITY_* level allowed (QUALITY_FULL = no limit)
+ * ======================================================
+ */
+void QualityScheduler::setLimit(int level) {
+    // Error Handle
+    if (level < QUALITY_FULL) {
+        level = QUALITY_FULL;
+    }
+    if (level > QUALITY_BYPASS) {
+        level = QUALITY_BYPASS;
+    }
+    _limit = level;
+    if (_level < level) {
+        _level = level;
+        _entries[level]++;
+        _calmFrames = 0;
+    }
+}
+
+/** Changes the time available per frame (e.g. after a change of sampling rate) */
+void QualityScheduler::setBudget(unsigned long budgetUs) {
+    _budgetUs = budgetUs;
+    _calmFrames = 0;
+}
+
+/** ====================================================
+ * @brief       Accounts for a frame and picks the level of the next one.
+ *
+ * @param       elapsedUs   Time the frame took at getLevel()
+ * ======================================================
+ */
+void QualityScheduler::frameDone(unsigned long elapsedUs) {
+    int level = _level;
+    _frames++;
+    _framesAt[level]++;
+    _lastUs = elapsedUs;
+    if (elapsedUs > _worstUs) {
+        _worstUs = elapsedUs;
+    }
+
+    // Smoothed cost of the current level (the first frame sets it)
+    if (_cost[level] == 0) {
+        _cost[level] = elapsedUs;
+    } else if (elapsedUs >= _cost[level]) {
+        _cost[level] += (elapsedUs - _cost[level]) >> COST_SHIFT;
+    } else {
+        _cost[level] -= (_cost[level] - elapsedUs) >> COST_SHIFT;
+    }
+
+    unsigned long load = elapsedUs*100;
+    if (elapsedUs > _budgetUs) {
+        _overruns++;
+    }
+
+    // Step down
+    if (load > _stepDownLoad*_budgetUs) {
+        _calmFrames = 0;
+        if (level < QUALITY_BYPASS) {
+            // Remember the bad frame so the level is not retried too soon
+            if (elapsedUs > _cost[level]) {
+                _cost[level] = elapsedUs;
+            }
+            level++;
+            // An overrun means one level is unlikely to be enough
+            if (elapsedUs > _budgetUs && level < QUALITY_BYPASS) {
+                level++;
+            }
+            _stepDowns++;
+            _entries[level]++;
+            _level = level;
+        }
+        return;
+    }
+
+    // Step up with hysteresis
+    if (load > _stepUpLoad*_budgetUs) {
+        _calmFrames = 0;
+        return;
+    }
+    _calmFrames++;
+    for (int i = 0; i < level; i++) {
+        // At least 1us so that small estimates are forgotten too
+        unsigned long forget = (_cost[i] >> FORGET_SHIFT) + 1;
+        _cost[i] = (_cost[i] > forget) ? _cost[i] - forget : 0;
+    }
+    if (level > _limit && _calmFrames >= _stepUpFrames &&
+        _cost[level - 1]*100 <= _stepUpLoad*_budgetUs) {
+        level--;
+        _calmFrames = 0;
+        _stepUps++;
+        _entries[level]++;
+        _level = level;
+    }
+}
+
+/** Number of times the ladder entered level */
+long QualityScheduler::getEntries(int level) const {
+    if (level < 0 || level >= NUM_QUALITY_LEVELS) {
+        return 0;
+    }
+    return _entries[level];
+}
+
+/** Number of frames processed at level */
+long QualityScheduler::getFramesAt(int level) const {
+    if (level < 0 || level >= NUM_QUALITY_LEVELS) {
+        return 0;
+    }
+    return _framesAt[level];
+}
+
+/** Smoothed frame time at level in microseconds (0 if unknown) */
+unsigned long QualityScheduler::getCostEstimate(int level) const {
+    if (level < 0 || level >= NUM_QUALITY_LEVELS) {
+        return 0;
+    }
+    return _cost[level];
+}
+
+/** Prints the telemetry */
+void QualityScheduler::print() const {
+    printf("level=%d frames=%ld overruns=%ld down=%ld up=%ld last=%luus worst=%luus budget=%luus\n",
+           _level, _frames, _overruns, _stepDowns, _stepUps, _lastUs, _worstUs, _budgetUs);
+    for (int i = 0; i < NUM_QUALITY_LEVELS; i++) {
+        printf("  level %d: entries=%ld frames=%ld cost=%luus\n", i, _entries[i], _framesAt[i], _cost[i]);
+    }
+}
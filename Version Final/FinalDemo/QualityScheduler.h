@@ -0,0 +1,77 @@
+//
+//  QualityScheduler.h
+//
+//
+//  Per-frame time budget monitor that steps the processing down a quality
+//  ladder under load and back up with hysteresis.
+//
+//
+
+#ifndef ____QualityScheduler__
+#define ____QualityScheduler__
+
+#include <stdio.h>
+
+// Quality ladder, from the most to the least expensive
+#define QUALITY_FULL                0   // full FLWT, PSOLA on both channels
+#define QUALITY_REDUCED_LEVELS      1   // FLWT searches fewer levels
+#define QUALITY_CACHED_PITCH        2   // reuse the previous pitch, no detection
+#define QUALITY_MONO                3   // PSOLA on the left channel, copied to the right
+#define QUALITY_BYPASS              4   // pass the input through
+#define NUM_QUALITY_LEVELS          5
+
+#define DEFAULT_STEP_DOWN_LOAD      85  // percent of the budget
+#define DEFAULT_STEP_UP_LOAD        60  // percent of the budget
+#define DEFAULT_STEP_UP_FRAMES      16
+
+class QualityScheduler {
+public:
+    // budgetUs = time available per frame. A frame above stepDownLoad % of the budget
+    //  steps down one level; stepUpFrames frames in a row whose level above is expected
+    //  to stay below stepUpLoad % step back up.
+    QualityScheduler(unsigned long budgetUs, int stepDownLoad = DEFAULT_STEP_DOWN_LOAD,
+                     int stepUpLoad = DEFAULT_STEP_UP_LOAD, int stepUpFrames = DEFAULT_STEP_UP_FRAMES);
+    // Level to process the next frame at (QUALITY_*)
+    int getLevel() const { return _level; }
+    // Reports how long the frame processed at getLevel() took
+    void frameDone(unsigned long elapsedUs);
+    void setBudget(unsigned long budgetUs);
+    unsigned long getBudget() const { return _budgetUs; }
+    // Best level the ladder may climb to (QUALITY_FULL = no limit), kept across reset()
+    void setLimit(int level);
+    int getLimit() const { return _limit; }
+    // Goes back to the best level allowed and clears the telemetry
+    void reset();
+
+    // Telemetry
+    long getFrames() const { return _frames; }
+    long getOverruns() const { return _overruns; }          // frames over the whole budget
+    long getStepDowns() const { return _stepDowns; }
+    long getStepUps() const { return _stepUps; }
+    long getEntries(int level) const;                       // times the ladder entered level
+    long getFramesAt(int level) const;                      // frames processed at level
+    unsigned long getLastUs() const { return _lastUs; }
+    unsigned long getWorstUs() const { return _worstUs; }
+    unsigned long getCostEstimate(int level) const;         // smoothed frame time at level
+    void print() const;
+
+private:
+    volatile int _level;
+    int _limit;
+    unsigned long _budgetUs;
+    int _stepDownLoad;
+    int _stepUpLoad;
+    int _stepUpFrames;
+    int _calmFrames;
+    unsigned long _cost[NUM_QUALITY_LEVELS];
+    long _entries[NUM_QUALITY_LEVELS];
+    long _framesAt[NUM_QUALITY_LEVELS];
+    long _frames;
+    long _overruns;
+    long _stepDowns;
+    long _stepUps;
+    unsigned long _lastUs;
+    unsigned long _worstUs;
+};
+
+#endif /* defined(____QualityScheduler__) */
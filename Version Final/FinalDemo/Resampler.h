@@ -0,0 +1,45 @@
+//
+//  Resampler.h
+//
+//
+//  Streaming fixed-point polyphase resampler for rational rate changes.
+//
+//
+
+#ifndef ____Resampler__
+#define ____Resampler__
+
+#include <stdio.h>
+
+#define DEFAULT_RESAMPLER_TAPS      16      // taps per phase for every unit of max(up, down)
+#define RESAMPLER_CUTOFF            0.9     // passband edge as a fraction of the lower Nyquist
+#define RESAMPLER_TAP_ALIGN         8       // phases are padded to a multiple of this
+
+class Resampler {
+public:
+    // Converts one channel from inRate to outRate (any ratio of the two is reduced first)
+    Resampler(long inRate, long outRate, int taps = DEFAULT_RESAMPLER_TAPS);
+    ~Resampler();
+    // Consumes inLen samples and returns the number of samples written to out
+    //  (at most getMaxOutput(inLen))
+    int process(const int* in, int inLen, int* out);
+    int getMaxOutput(int inLen) const;
+    // Clears the history so the next call starts from silence
+    void reset();
+    int getUp() const { return _up; }
+    int getDown() const { return _down; }
+    int getPhaseLength() const { return _phaseLen; }
+    // Group delay of the filter in output samples
+    int getDelay() const;
+
+private:
+    int _up;
+    int _down;
+    int _phaseLen;
+    short *_coeffs;     // _up phases of _phaseLen taps, reversed (oldest sample first)
+    short *_history;    // last _phaseLen inputs, stored twice so a window is contiguous
+    int _pos;
+    int _phase;
+};
+
+#endif /* defined(____Resampler__) */
@@ -0,0 +1,121 @@
+//
+//  Telemetry.h
+//
+//
+//  Per-frame telemetry (pitch, key, FLWT level, stage timings) queued by the
+//  audio path in a lock-free ring and drained into a compact binary log.
+//
+//
+
+#ifndef ____Telemetry__
+#define ____Telemetry__
+
+#include <stdio.h>
+
+#if __cplusplus >= 201103L
+#include <atomic>
+#include <thread>
+typedef std::atomic<int> TelemetryIndex;
+#define TELEMETRY_LOAD(index)           (index).load(std::memory_order_acquire)
+#define TELEMETRY_STORE(index, value)   (index).store((value), std::memory_order_release)
+#else
+// One core: the ISR and loop() only need the compiler to not cache the indices
+typedef volatile int TelemetryIndex;
+#define TELEMETRY_LOAD(index)           (index)
+#define TELEMETRY_STORE(index, value)   ((index) = (value))
+#endif
+
+#define DEFAULT_TELEMETRY_DEPTH     64
+#define TELEMETRY_VERSION           1
+#define TELEMETRY_HEADER_BYTES      8       // "PVTL", version, record size (16-bit each)
+#define TELEMETRY_RECORD_BYTES      22
+#define TELEMETRY_MAX_US            65535   // stage timings saturate here in the log
+
+// What happened to one processed frame
+struct TelemetryFrame {
+    unsigned long frame;        // frame number
+    int mode;                   // STATUS of the sketch
+    int quality;                // QUALITY_* level of the frame
+    float pitch;                // detected pitch (Hz), 0 = pitchless or not detected
+    float target;               // pitch corrected to (Hz), 0 = not corrected
+    int key;                    // key number of target, 0 = none
+    int level;                  // FLWT level that found the pitch, 0 = none
+    unsigned long detectUs;     // time spent on each stage
+    unsigned long quantizeUs;
+    unsigned long correctUs;
+};
+
+// Single-producer/single-consumer queue of frames; the producer never waits
+class TelemetryRing {
+public:
+    TelemetryRing(int depth = DEFAULT_TELEMETRY_DEPTH);
+    ~TelemetryRing();
+    // Producer: queues a copy of frame. Returns 0, or -1 if the ring is full (the frame is dropped)
+    int push(const TelemetryFrame& frame);
+    // Consumer: takes the oldest frame. Returns 0, or -1 if the ring is empty
+    int pop(TelemetryFrame& frame);
+    int count() const;
+    int getDepth() const { return _slots - 1; }
+    long getDropped() const { return _dropped; }
+
+private:
+    int next(int index) const { return (index + 1 == _slots) ? 0 : index + 1; }
+    TelemetryFrame* _frames;
+    int _slots;
+    TelemetryIndex _head;       // written by the producer only
+    TelemetryIndex _tail;       // written by the consumer only
+    volatile long _dropped;
+};
+
+// Little endian log format, one byte (0-255) per element of out. Return the bytes written
+int encodeTelemetryHeader(unsigned char* out);
+int encodeTelemetryFrame(const TelemetryFrame& frame, unsigned char* out);
+// Returns 0, or -1 if the header is not a telemetry log this version can read
+int decodeTelemetryHeader(const unsigned char* in);
+void decodeTelemetryFrame(const unsigned char* in, TelemetryFrame& frame);
+
+// Binary log file (host tools only)
+class TelemetryLog {
+public:
+    TelemetryLog();
+    ~TelemetryLog();
+    // Creates the log and writes its header. Returns 0 on success
+    int open(const char* path);
+    // Stops the background drain and closes the log
+    void close();
+    // Writes every frame queued in ring, returns the number written
+    int drain(TelemetryRing& ring);
+#if __cplusplus >= 201103L
+    // Drains ring on a background thread every periodMs until stop() or close()
+    int start(TelemetryRing* ring, int periodMs = 10);
+    // Drains what is left and stops the background thread
+    void stop();
+#endif
+    long getRecords() const { return _records; }
+
+private:
+    FILE* _file;
+    long _records;
+#if __cplusplus >= 201103L
+    TelemetryRing* _ring;
+    std::thread _thread;
+    std::atomic<bool> _running;
+#endif
+};
+
+// Reads back a log written by TelemetryLog
+class TelemetryLogReader {
+public:
+    TelemetryLogReader();
+    ~TelemetryLogReader();
+    // Returns 0 on success, -1 if the file cannot be read or is not a telemetry log
+    int open(const char* path);
+    void close();
+    // Returns 0, or -1 at the end of the log
+    int read(TelemetryFrame& frame);
+
+private:
+    FILE* _file;
+};
+
+#endif /* defined(____Telemetry__) */
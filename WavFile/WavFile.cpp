@@ -0,0 +1,815 @@
+/**
+ *   @mainpage WAV File Module
+ *
+ *   \section desc_sec Description
+ *   Small streaming reader and writer for 16-bit PCM WAV files, used by the
+ *      host-side tools that run the DSP modules off the board. Samples are
+ *      handed out as int, and the file is read in blocks so memory use does not depend on the
+ *      length of the recording.
+ *
+ *  @n MappedWav reads archives too large to stream through stdio comfortably.
+ *      It maps the whole file and only walks the RIFF chunk headers when it
+ *      is opened, so the samples are paged in by the kernel as blocks are
+ *      read (the mapping is marked sequential, so it reads ahead). Besides
+ *      16-bit PCM it takes 24 and 32-bit PCM, 32-bit float (plain or
+ *      WAVE_FORMAT_EXTENSIBLE) and headerless raw files, and converts every
+ *      sample to Q15 on the way out, eight or four at a time with SSE2 (SSSE3
+ *      for 24-bit) when the compiler targets it.
+ *
+ *  @n The host tools run FLWT16 and PSOLA16, so blocks are read as int16_t
+ *      and converted straight into the caller's buffers, with no int stage
+ *      (a mono 16-bit file is a plain copy). PSOLA corrects in place, so its
+ *      samples still land in a block buffer; detection needs no copy at
+ *      all: for 16-bit files MappedWav::view() hands out the samples
+ *      straight from the mapping, and a mono block of them is already an
+ *      FLWT16 input (PitchTracker reads them that way).
+ *
+ *  \section contents_sec Table of Contents
+ *    WavFile.cpp
+ *
+ *    WavFile.h
+ *
+ */
+
+/**
+ *  @file WavFile.cpp
+ *  @brief Source file for WavReader and WavWriter
+ *  @file WavFile.h
+ *  @brief Header file for WavReader and WavWriter
+ */
+
+#include "WavFile.h"
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+#define WAV_HEADER_SIZE         44
+#define WAV_FORMAT_PCM          1
+#define WAV_FORMAT_FLOAT        3
+#define WAV_FORMAT_EXTENSIBLE   0xFFFE
+#define WAV_BITS_PER_SAMPLE     16
+#define MAX_INT16               32767
+#define MIN_INT16               -32768
+
+// Little endian helpers ==================
+
+static unsigned long readLE(const unsigned char* p, int bytes) {
+    unsigned long value = 0;
+    for (int i = bytes - 1; i >= 0; i--) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+static void writeLE(unsigned char* p, unsigned long value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        p[i] = (unsigned char)(value & 0xFF);
+        value >>= 8;
+    }
+}
+
+static short saturate16(int x) {
+    if (x > MAX_INT16) return MAX_INT16;
+    if (x < MIN_INT16) return MIN_INT16;
+    return (short)x;
+}
+
+// WavReader ==============================
+
+WavReader::WavReader() {
+    _file = 0;
+    _sampleRate = 0;
+    _channels = 0;
+    _frames = 0;
+    _framesLeft = 0;
+    _buffer = 0;
+    _bufferFrames = 0;
+}
+
+/** Standard destructor */
+WavReader::~WavReader() {
+    close();
+}
+
+/** ====================================================
+ * @brief       Opens a WAV file and parses its header.
+ *
+ * @details     Walks the RIFF chunks until it finds "fmt " and "data". Only
+ *              16-bit PCM files with one or two channels are accepted.
+ *
+ * @param       path        Path of the file
+ *
+ * @return      Status
+ *
+ * @retval      status
+ *                      <ul>
+ *                         <li> 0 : File is open and positioned at the first sample
+ *                         <li> -1 : File could not be opened or is not a supported WAV file
+ *                      </ul>
+ * ======================================================
+ */
+int WavReader::open(const char* path) {
+    close();
+    _file = fopen(path, "rb");
+    if (!_file) {
+        return -1;
+    }
+    unsigned char header[12];
+    if (fread(header, 1, 12, _file) != 12 || memcmp(header, "RIFF", 4) || memcmp(header + 8, "WAVE", 4)) {
+        close();
+        return -1;
+    }
+    bool haveFormat = false;
+    unsigned char chunk[8];
+    while (fread(chunk, 1, 8, _file) == 8) {
+        unsigned long size = readLE(chunk + 4, 4);
+        if (!memcmp(chunk, "fmt ", 4)) {
+            unsigned char fmt[16];
+            if (size < 16 || fread(fmt, 1, 16, _file) != 16) {
+                break;
+            }
+            if (readLE(fmt, 2) != WAV_FORMAT_PCM || readLE(fmt + 14, 2) != WAV_BITS_PER_SAMPLE) {
+                break;
+            }
+            _channels = (int)readLE(fmt + 2, 2);
+            _sampleRate = (long)readLE(fmt + 4, 4);
+            haveFormat = (_channels == 1 || _channels == 2);
+            // skip the rest of the chunk (chunks are padded to an even size)
+            fseek(_file, (long)(size - 16 + (size & 1)), SEEK_CUR);
+        } else if (!memcmp(chunk, "data", 4)) {
+            if (!haveFormat) {
+                break;
+            }
+            _frames = (long)(size/(2*_channels));
+            _framesLeft = _frames;
+            return 0;
+        } else {
+            fseek(_file, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+    close();
+    return -1;
+}
+
+/** Closes the file */
+void WavReader::close() {
+    if (_file) {
+        fclose(_file);
+        _file = 0;
+    }
+    delete[] _buffer;
+    _buffer = 0;
+    _bufferFrames = 0;
+    _framesLeft = 0;
+}
+
+/** ====================================================
+ * @brief       Reads the next block of samples.
+ *
+ * @param       left        Left channel (frames long)
+ * @param       right       Right channel (frames long, may be 0)
+ * @param       frames      Number of frames to read
+ *
+ * @return      Number of frames read (0 at the end of the file)
+ * ======================================================
+ */
+int WavReader::read(int* left, int* right, int frames) {
+    if (!_file || frames <= 0) {
+        return 0;
+    }
+    if (frames > _framesLeft) {
+        frames = (int)_framesLeft;
+    }
+    if (frames > _bufferFrames) {
+        delete[] _buffer;
+        _buffer = new short[frames*_channels];
+        _bufferFrames = frames;
+    }
+    int got = (int)fread(_buffer, 2*_channels, frames, _file);
+    for (int i = 0; i < got; i++) {
+        const unsigned char* p = (const unsigned char*)(_buffer + i*_channels);
+        left[i] = (short)readLE(p, 2);
+        if (right) {
+            right[i] = (_channels == 2) ? (short)readLE(p + 2, 2) : left[i];
+        }
+    }
+    _framesLeft -= got;
+    return got;
+}
+
+// MappedWav ==============================
+
+static const int bytesPerSample[] = {2, 3, 4, 4};     // indexed by SAMPLE_*
+
+MappedWav::MappedWav() {
+    _map = 0;
+    _mapSize = 0;
+    _data = 0;
+    _sampleRate = 0;
+    _channels = 0;
+    _format = SAMPLE_PCM16;
+    _bytesPerSample = 2;
+    _frames = 0;
+    _position = 0;
+}
+
+/** Standard destructor */
+MappedWav::~MappedWav() {
+    close();
+}
+
+/** Maps a whole file read only, returns 0 on success */
+int MappedWav::map(const char* path) {
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) || st.st_size <= 0) {
+        ::close(fd);
+        return -1;
+    }
+    void* p = mmap(0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        return -1;
+    }
+    madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+    _map = (unsigned char*)p;
+    _mapSize = (unsigned long)st.st_size;
+    return 0;
+}
+
+/** ====================================================
+ * @brief       Maps a WAV file and parses its header.
+ *
+ * @details     Only the chunk headers are touched: the chunks are walked
+ *              until "fmt " and "data" are found. A data chunk whose size
+ *              runs past the end of the file (a truncated file, or one
+ *              written by a streaming recorder that left 0xFFFFFFFF) is
+ *              taken to end with the file.
+ *
+ * @param       path        Path of the file
+ *
+ * @return      Status
+ *
+ * @retval      status
+ *                      <ul>
+ *                         <li> 0 : File is mapped and positioned at the first sample
+ *                         <li> -1 : File could not be mapped or is not a supported WAV file
+ *                      </ul>
+ * ======================================================
+ */
+int MappedWav::open(const char* path) {
+    close();
+    if (map(path)) {
+        return -1;
+    }
+    if (_mapSize < 12 || memcmp(_map, "RIFF", 4) || memcmp(_map + 8, "WAVE", 4)) {
+        close();
+        return -1;
+    }
+    bool haveFormat = false;
+    unsigned long offset = 12;
+    while (offset + 8 <= _mapSize) {
+        const unsigned char* chunk = _map + offset;
+        unsigned long size = readLE(chunk + 4, 4);
+        unsigned long body = offset + 8;
+        if (!memcmp(chunk, "fmt ", 4)) {
+            if (size < 16 || body + 16 > _mapSize) {
+                break;
+            }
+            const unsigned char* fmt = _map + body;
+            unsigned long tag = readLE(fmt, 2);
+            if (tag == WAV_FORMAT_EXTENSIBLE && size >= 40 && body + 40 <= _mapSize) {
+                // The first two bytes of the SubFormat GUID are the format tag
+                tag = readLE(fmt + 24, 2);
+            }
+            int bits = (int)readLE(fmt + 14, 2);
+            if (tag == WAV_FORMAT_PCM && bits == 16) {
+                _format = SAMPLE_PCM16;
+            } else if (tag == WAV_FORMAT_PCM && bits == 24) {
+                _format = SAMPLE_PCM24;
+            } else if (tag == WAV_FORMAT_PCM && bits == 32) {
+                _format = SAMPLE_PCM32;
+            } else if (tag == WAV_FORMAT_FLOAT && bits == 32) {
+                _format = SAMPLE_FLOAT32;
+            } else {
+                break;
+            }
+            _bytesPerSample = bytesPerSample[_format];
+            _channels = (int)readLE(fmt + 2, 2);
+            _sampleRate = (long)readLE(fmt + 4, 4);
+            haveFormat = (_channels >= 1 && _channels <= MAPPED_MAX_CHANNELS
+                          && readLE(fmt + 12, 2) == (unsigned long)(_channels*_bytesPerSample));
+            if (!haveFormat) {
+                break;
+            }
+        } else if (!memcmp(chunk, "data", 4)) {
+            if (!haveFormat) {
+                break;
+            }
+            if (size > _mapSize - body) {
+                size = _mapSize - body;
+            }
+            _data = _map + body;
+            _frames = (long)(size/(_channels*_bytesPerSample));
+            _position = 0;
+            return 0;
+        }
+        // chunks are padded to an even size
+        offset = body + size + (size & 1);
+    }
+    close();
+    return -1;
+}
+
+/** ====================================================
+ * @brief       Maps a headerless file of interleaved samples.
+ *
+ * @param       path            Path of the file
+ * @param       sampleRate      Sampling frequency
+ * @param       channels        1 to MAPPED_MAX_CHANNELS
+ * @param       format          SAMPLE_PCM16, SAMPLE_PCM24, SAMPLE_PCM32 or SAMPLE_FLOAT32 (little endian)
+ *
+ * @return      0 on success, -1 on failure
+ * ======================================================
+ */
+int MappedWav::openRaw(const char* path, long sampleRate, int channels, int format) {
+    close();
+    // Error Handle
+    if (sampleRate <= 0 || channels < 1 || channels > MAPPED_MAX_CHANNELS
+        || format < SAMPLE_PCM16 || format > SAMPLE_FLOAT32) {
+        return -1;
+    }
+    if (map(path)) {
+        return -1;
+    }
+    _sampleRate = sampleRate;
+    _channels = channels;
+    _format = format;
+    _bytesPerSample = bytesPerSample[format];
+    _data = _map;
+    _frames = (long)(_mapSize/(channels*_bytesPerSample));
+    _position = 0;
+    return 0;
+}
+
+/** Unmaps the file */
+void MappedWav::close() {
+    if (_map) {
+        munmap(_map, (size_t)_mapSize);
+        _map = 0;
+    }
+    _mapSize = 0;
+    _data = 0;
+    _frames = 0;
+    _position = 0;
+}
+
+/** Moves the read position to a frame (clamped to the file) */
+void MappedWav::seek(long frame) {
+    if (frame < 0) frame = 0;
+    if (frame > _frames) frame = _frames;
+    _position = frame;
+}
+
+/** ====================================================
+ * @brief       Interleaved 16-bit samples straight from the mapping.
+ *
+ * @details     The pointer stays valid until the file is closed; there are
+ *              getFrames()-start frames behind it. Only 16-bit files on a
+ *              little endian host qualify, whose data chunk starts on an
+ *              even offset (which RIFF padding guarantees).
+ *
+ * @param       start       First frame
+ *
+ * @return      Pointer to the first sample of frame start, or 0
+ * ======================================================
+ */
+const int16_t* MappedWav::view(long start) const {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+    return 0;
+#endif
+    if (!_data || _format != SAMPLE_PCM16 || start < 0 || start >= _frames
+        || ((unsigned long)(_data - _map) & 1)) {
+        return 0;
+    }
+    return (const int16_t*)(_data + (unsigned long)start*_channels*2);
+}
+
+/** ====================================================
+ * @brief       Converts contiguous samples to Q15.
+ *
+ * @details     24 and 32-bit samples are truncated to their top 16 bits.
+ *              Float samples are scaled by 32768, rounded to the nearest
+ *              integer and saturated (NaN reads as full scale), so the SIMD
+ *              and scalar paths give the same result.
+ *
+ * @param       src         First byte of the first sample
+ * @param       samples     Number of samples
+ * @param       dst         Q15 output
+ * ======================================================
+ */
+void MappedWav::convert(const unsigned char* src, int samples, int* dst) const {
+    int i = 0;
+    switch (_format) {
+    case SAMPLE_PCM16:
+#if defined(__SSE2__)
+        for (; i + 8 <= samples; i += 8) {
+            __m128i x = _mm_loadu_si128((const __m128i*)(src + 2*i));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+            _mm_storeu_si128((__m128i*)(dst + i + 4), _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16));
+        }
+#endif
+        for (; i < samples; i++) {
+            dst[i] = (short)readLE(src + 2*i, 2);
+        }
+        break;
+    case SAMPLE_PCM24:
+#if defined(__SSSE3__)
+        {
+            // Moves each 3 byte sample to the top of a 32-bit lane
+            const __m128i spread = _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+            // The load reads 16 bytes for 4 samples (12 bytes), so stop 2 samples early
+            for (; i + 6 <= samples; i += 4) {
+                __m128i x = _mm_loadu_si128((const __m128i*)(src + 3*i));
+                _mm_storeu_si128((__m128i*)(dst + i), _mm_srai_epi32(_mm_shuffle_epi8(x, spread), 16));
+            }
+        }
+#endif
+        for (; i < samples; i++) {
+            dst[i] = (short)readLE(src + 3*i + 1, 2);
+        }
+        break;
+    case SAMPLE_PCM32:
+#if defined(__SSE2__)
+        for (; i + 4 <= samples; i += 4) {
+            __m128i x = _mm_loadu_si128((const __m128i*)(src + 4*i));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_srai_epi32(x, 16));
+        }
+#endif
+        for (; i < samples; i++) {
+            dst[i] = (short)readLE(src + 4*i + 2, 2);
+        }
+        break;
+    case SAMPLE_FLOAT32:
+#if defined(__SSE2__)
+        {
+            const __m128 scale = _mm_set1_ps(32768.0f);
+            const __m128 high = _mm_set1_ps((float)MAX_INT16);
+            const __m128 low = _mm_set1_ps((float)MIN_INT16);
+            for (; i + 4 <= samples; i += 4) {
+                __m128 x = _mm_mul_ps(_mm_loadu_ps((const float*)(src + 4*i)), scale);
+                // min returns its second operand for a NaN
+                x = _mm_max_ps(_mm_min_ps(x, high), low);
+                _mm_storeu_si128((__m128i*)(dst + i), _mm_cvtps_epi32(x));
+            }
+        }
+#endif
+        for (; i < samples; i++) {
+            float x;
+            memcpy(&x, src + 4*i, 4);
+            x *= 32768.0f;
+            if (!(x < MAX_INT16)) x = MAX_INT16;
+            if (!(x > MIN_INT16)) x = MIN_INT16;
+            dst[i] = (int)lrintf(x);
+        }
+        break;
+    }
+}
+
+/** ====================================================
+ * @brief       Converts contiguous samples to 16-bit Q15.
+ *
+ * @details     Same conversion as the int version, written straight into
+ *              16-bit samples: 16-bit PCM is a plain copy and the other
+ *              formats are narrowed eight at a time with SSE2 (SSSE3 for
+ *              24-bit) when the compiler targets it.
+ *
+ * @param       src         First byte of the first sample
+ * @param       samples     Number of samples
+ * @param       dst         Q15 output
+ * ======================================================
+ */
+void MappedWav::convert(const unsigned char* src, int samples, int16_t* dst) const {
+    int i = 0;
+    switch (_format) {
+    case SAMPLE_PCM16:
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        memcpy(dst, src, 2*samples);
+        i = samples;
+#endif
+        for (; i < samples; i++) {
+            dst[i] = (int16_t)readLE(src + 2*i, 2);
+        }
+        break;
+    case SAMPLE_PCM24:
+#if defined(__SSSE3__)
+        {
+            const __m128i spread = _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+            // The second load reads 16 bytes for 4 samples (12 bytes), so stop 2 samples early
+            for (; i + 10 <= samples; i += 8) {
+                __m128i a = _mm_srai_epi32(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + 3*i)), spread), 16);
+                __m128i b = _mm_srai_epi32(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + 3*i + 12)), spread), 16);
+                _mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(a, b));
+            }
+        }
+#endif
+        for (; i < samples; i++) {
+            dst[i] = (int16_t)readLE(src + 3*i + 1, 2);
+        }
+        break;
+    case SAMPLE_PCM32:
+#if defined(__SSE2__)
+        for (; i + 8 <= samples; i += 8) {
+            __m128i a = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)(src + 4*i)), 16);
+            __m128i b = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)(src + 4*i + 16)), 16);
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(a, b));
+        }
+#endif
+        for (; i < samples; i++) {
+            dst[i] = (int16_t)readLE(src + 4*i + 2, 2);
+        }
+        break;
+    case SAMPLE_FLOAT32:
+#if defined(__SSE2__)
+        {
+            const __m128 scale = _mm_set1_ps(32768.0f);
+            const __m128 high = _mm_set1_ps((float)MAX_INT16);
+            const __m128 low = _mm_set1_ps((float)MIN_INT16);
+            for (; i + 8 <= samples; i += 8) {
+                __m128 a = _mm_mul_ps(_mm_loadu_ps((const float*)(src + 4*i)), scale);
+                __m128 b = _mm_mul_ps(_mm_loadu_ps((const float*)(src + 4*i + 16)), scale);
+                // min returns its second operand for a NaN
+                a = _mm_max_ps(_mm_min_ps(a, high), low);
+                b = _mm_max_ps(_mm_min_ps(b, high), low);
+                _mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+            }
+        }
+#endif
+        for (; i < samples; i++) {
+            float x;
+            memcpy(&x, src + 4*i, 4);
+            x *= 32768.0f;
+            if (!(x < MAX_INT16)) x = MAX_INT16;
+            if (!(x > MIN_INT16)) x = MIN_INT16;
+            dst[i] = (int16_t)lrintf(x);
+        }
+        break;
+    }
+}
+
+/** ====================================================
+ * @brief       Converts a block of frames to Q15 without moving the read position.
+ *
+ * @details     The first channel goes to left and the second to right; mono
+ *              files are copied to both channels and channels past the
+ *              second are dropped.
+ *
+ * @param       start       First frame
+ * @param       left        Left channel (frames long)
+ * @param       right       Right channel (frames long, may be 0)
+ * @param       frames      Number of frames
+ *
+ * @return      Number of frames converted (0 past the end of the file)
+ * ======================================================
+ */
+int MappedWav::read(long start, int* left, int* right, int frames) const {
+    if (!_data || start < 0 || start >= _frames || frames <= 0) {
+        return 0;
+    }
+    if (frames > _frames - start) {
+        frames = (int)(_frames - start);
+    }
+    unsigned long frameBytes = (unsigned long)_channels*_bytesPerSample;
+    const unsigned char* src = _data + (unsigned long)start*frameBytes;
+    if (_channels == 1) {
+        convert(src, frames, left);
+        if (right) {
+            memcpy(right, left, frames*sizeof(int));
+        }
+        return frames;
+    }
+    int chunk[MAPPED_CHUNK_FRAMES*MAPPED_MAX_CHANNELS];
+    for (int done = 0; done < frames; done += MAPPED_CHUNK_FRAMES) {
+        int n = frames - done;
+        if (n > MAPPED_CHUNK_FRAMES) {
+            n = MAPPED_CHUNK_FRAMES;
+        }
+        convert(src + done*frameBytes, n*_channels, chunk);
+        for (int i = 0; i < n; i++) {
+            left[done + i] = chunk[i*_channels];
+        }
+        if (right) {
+            for (int i = 0; i < n; i++) {
+                right[done + i] = chunk[i*_channels + 1];
+            }
+        }
+    }
+    return frames;
+}
+
+/** ====================================================
+ * @brief       Converts a block of frames to 16-bit Q15 samples.
+ *
+ * @details     Same as MappedWav::read(long, int*, int*, int) const, but
+ *              every format is converted straight into the 16-bit blocks:
+ *              a mono 16-bit file is copied from the mapping, and other
+ *              files go through an interleaved 16-bit chunk only to be
+ *              split into channels.
+ *
+ * @param       start       First frame
+ * @param       left        Left channel (frames long)
+ * @param       right       Right channel (frames long, may be 0)
+ * @param       frames      Number of frames
+ *
+ * @return      Number of frames converted (0 past the end of the file)
+ * ======================================================
+ */
+int MappedWav::read(long start, int16_t* left, int16_t* right, int frames) const {
+    if (!_data || start < 0 || start >= _frames || frames <= 0) {
+        return 0;
+    }
+    if (frames > _frames - start) {
+        frames = (int)(_frames - start);
+    }
+    unsigned long frameBytes = (unsigned long)_channels*_bytesPerSample;
+    const unsigned char* src = _data + (unsigned long)start*frameBytes;
+    if (_channels == 1) {
+        convert(src, frames, left);
+        if (right) {
+            memcpy(right, left, frames*sizeof(int16_t));
+        }
+        return frames;
+    }
+    int16_t chunk[MAPPED_CHUNK_FRAMES*MAPPED_MAX_CHANNELS];
+    for (int done = 0; done < frames; done += MAPPED_CHUNK_FRAMES) {
+        int n = frames - done;
+        if (n > MAPPED_CHUNK_FRAMES) {
+            n = MAPPED_CHUNK_FRAMES;
+        }
+        convert(src + done*frameBytes, n*_channels, chunk);
+        for (int i = 0; i < n; i++) {
+            left[done + i] = chunk[i*_channels];
+        }
+        if (right) {
+            for (int i = 0; i < n; i++) {
+                right[done + i] = chunk[i*_channels + 1];
+            }
+        }
+    }
+    return frames;
+}
+
+/** Reads the next block of frames, see MappedWav::read(long, int*, int*, int) */
+int MappedWav::read(int* left, int* right, int frames) {
+    int got = read(_position, left, right, frames);
+    _position += got;
+    return got;
+}
+
+/** Reads the next block of 16-bit frames, see MappedWav::read(long, int16_t*, int16_t*, int) */
+int MappedWav::read(int16_t* left, int16_t* right, int frames) {
+    int got = read(_position, left, right, frames);
+    _position += got;
+    return got;
+}
+
+// WavWriter ==============================
+
+WavWriter::WavWriter() {
+    _file = 0;
+    _channels = 0;
+    _frames = 0;
+}
+
+/** Standard destructor */
+WavWriter::~WavWriter() {
+    close();
+}
+
+/** ====================================================
+ * @brief       Creates a 16-bit PCM WAV file.
+ *
+ * @details     The sizes in the header are filled in by WavWriter::close().
+ *
+ * @param       path           Path of the file
+ * @param       sampleRate     Sampling frequency
+ * @param       channels       1 or 2
+ *
+ * @return      0 on success, -1 on failure
+ * ======================================================
+ */
+int WavWriter::open(const char* path, long sampleRate, int channels) {
+    close();
+    if (channels != 1 && channels != 2) {
+        return -1;
+    }
+    _file = fopen(path, "wb");
+    if (!_file) {
+        return -1;
+    }
+    _channels = channels;
+    _frames = 0;
+    unsigned char header[WAV_HEADER_SIZE];
+    memcpy(header, "RIFF", 4);
+    writeLE(header + 4, 36, 4);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    writeLE(header + 16, 16, 4);
+    writeLE(header + 20, WAV_FORMAT_PCM, 2);
+    writeLE(header + 22, channels, 2);
+    writeLE(header + 24, sampleRate, 4);
+    writeLE(header + 28, sampleRate*2*channels, 4);
+    writeLE(header + 32, 2*channels, 2);
+    writeLE(header + 34, WAV_BITS_PER_SAMPLE, 2);
+    memcpy(header + 36, "data", 4);
+    writeLE(header + 40, 0, 4);
+    fwrite(header, 1, WAV_HEADER_SIZE, _file);
+    return 0;
+}
+
+/** Patches the header sizes and closes the file */
+void WavWriter::close() {
+    if (!_file) {
+        return;
+    }
+    unsigned long dataBytes = (unsigned long)_frames*2*_channels;
+    unsigned char size[4];
+    writeLE(size, dataBytes + 36, 4);
+    fseek(_file, 4, SEEK_SET);
+    fwrite(size, 1, 4, _file);
+    writeLE(size, dataBytes, 4);
+    fseek(_file, 40, SEEK_SET);
+    fwrite(size, 1, 4, _file);
+    fclose(_file);
+    _file = 0;
+}
+
+/** Appends frames frames, returns the number written */
+int WavWriter::write(const int* left, const int* right, int frames) {
+    if (!_file) {
+        return 0;
+    }
+    unsigned char block[256*4];
+    int written = 0;
+    while (written < frames) {
+        int n = frames - written;
+        if (n > 256) {
+            n = 256;
+        }
+        for (int i = 0; i < n; i++) {
+            writeLE(block + i*2*_channels, (unsigned short)saturate16(left[written + i]), 2);
+            if (_channels == 2) {
+                int r = right ? right[written + i] : left[written + i];
+                writeLE(block + i*4 + 2, (unsigned short)saturate16(r), 2);
+            }
+        }
+        int w = (int)fwrite(block, 2*_channels, n, _file);
+        written += w;
+        if (w < n) {
+            break;
+        }
+    }
+    _frames += written;
+    return written;
+}
+
+/** Appends frames 16-bit frames, returns the number written */
+int WavWriter::write(const int16_t* left, const int16_t* right, int frames) {
+    if (!_file) {
+        return 0;
+    }
+    unsigned char block[256*4];
+    int written = 0;
+    while (written < frames) {
+        int n = frames - written;
+        if (n > 256) {
+            n = 256;
+        }
+        for (int i = 0; i < n; i++) {
+            writeLE(block + i*2*_channels, (unsigned short)left[written + i], 2);
+            if (_channels == 2) {
+                int16_t r = right ? right[written + i] : left[written + i];
+                writeLE(block + i*4 + 2, (unsigned short)r, 2);
+            }
+        }
+        int w = (int)fwrite(block, 2*_channels, n, _file);
+        written += w;
+        if (w < n) {
+            break;
+        }
+    }
+    _frames += written;
+    return written;
+}
@@ -0,0 +1,108 @@
+//
+//  WavFile.h
+//
+//
+//  Streaming reader/writer for 16-bit PCM WAV files, and a memory-mapped
+//  reader for 16/24/32-bit PCM, float and raw files (host tools only).
+//
+//
+
+#ifndef ____WavFile__
+#define ____WavFile__
+
+#include <stdio.h>
+#include <stdint.h>
+
+class WavReader {
+public:
+    WavReader();
+    ~WavReader();
+    // Returns 0 on success
+    int open(const char* path);
+    void close();
+    // Reads up to frames frames, returns the number read (0 at the end of the file).
+    // Mono files are copied to both channels; right may be 0.
+    int read(int* left, int* right, int frames);
+    long getSampleRate() const { return _sampleRate; }
+    int getChannels() const { return _channels; }
+    long getFrames() const { return _frames; }
+
+private:
+    FILE* _file;
+    long _sampleRate;
+    int _channels;
+    long _frames;
+    long _framesLeft;
+    short* _buffer;
+    int _bufferFrames;
+};
+
+// Sample formats of MappedWav
+#define SAMPLE_PCM16            0
+#define SAMPLE_PCM24            1
+#define SAMPLE_PCM32            2
+#define SAMPLE_FLOAT32          3
+
+#define MAPPED_MAX_CHANNELS     8
+#define MAPPED_CHUNK_FRAMES     256     // frames converted per pass when deinterleaving
+
+class MappedWav {
+public:
+    MappedWav();
+    ~MappedWav();
+    // Maps a WAV file (16/24/32-bit PCM or 32-bit float, plain or extensible). Returns 0 on success
+    int open(const char* path);
+    // Maps a headerless file of little endian samples in one of the SAMPLE_* formats
+    int openRaw(const char* path, long sampleRate, int channels, int format);
+    void close();
+    // Same as WavReader::read(), samples are converted to Q15 (16-bit range)
+    int read(int* left, int* right, int frames);
+    int read(int16_t* left, int16_t* right, int frames);
+    // Converts frames [start, start+frames) without moving the read position
+    int read(long start, int* left, int* right, int frames) const;
+    // The same straight into 16-bit samples, for FLWT16 and PSOLA16
+    int read(long start, int16_t* left, int16_t* right, int frames) const;
+    // Interleaved samples from frame start, straight from the mapping (SAMPLE_PCM16 only, else 0)
+    const int16_t* view(long start) const;
+    void seek(long frame);
+    long tell() const { return _position; }
+    long getSampleRate() const { return _sampleRate; }
+    int getChannels() const { return _channels; }
+    long getFrames() const { return _frames; }
+    int getFormat() const { return _format; }
+
+private:
+    int map(const char* path);
+    void convert(const unsigned char* src, int samples, int* dst) const;
+    void convert(const unsigned char* src, int samples, int16_t* dst) const;
+
+    unsigned char* _map;
+    unsigned long _mapSize;
+    const unsigned char* _data;
+    long _sampleRate;
+    int _channels;
+    int _format;
+    int _bytesPerSample;
+    long _frames;
+    long _position;
+};
+
+class WavWriter {
+public:
+    WavWriter();
+    ~WavWriter();
+    // Returns 0 on success
+    int open(const char* path, long sampleRate, int channels);
+    // Finishes the header; also called by the destructor
+    void close();
+    // Writes frames frames, samples are saturated to 16 bits. right is ignored for mono.
+    int write(const int* left, const int* right, int frames);
+    int write(const int16_t* left, const int16_t* right, int frames);
+
+private:
+    FILE* _file;
+    int _channels;
+    long _frames;
+};
+
+#endif /* defined(____WavFile__) */
@@ -0,0 +1,166 @@
+//
+//  main.cpp
+//
+//
+//  Writes the same signal as 16/24/32-bit PCM, float and raw files and
+//  checks that MappedWav reads them back as WavReader reads the 16-bit one.
+//  Build: g++ -O2 -mssse3 main.cpp WavFile.cpp
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <stdlib.h>
+#include <time.h>
+#include "WavFile.h"
+#include <iostream>
+#include <algorithm>
+
+using namespace std;
+
+long sampleRate = 44100;
+int numFrames = 44100*4 + 13;       // not a multiple of the SIMD width
+int blockLength = 512;
+
+// Writes a header for a WAV file with data of the given format (tag 3 = float, 0xFFFE = extensible)
+void writeHeader(FILE* f, int tag, int subTag, int bits, int channels, long frames) {
+    int fmtSize = (tag == 0xFFFE) ? 40 : 16;
+    unsigned long dataBytes = (unsigned long)frames*channels*(bits/8);
+    unsigned char h[68];
+    memset(h, 0, sizeof(h));
+    unsigned long fields[][3] = {{4, 4 + 8 + fmtSize + 8 + dataBytes, 4}, {16, (unsigned long)fmtSize, 4},
+        {20, (unsigned long)tag, 2}, {22, (unsigned long)channels, 2}, {24, (unsigned long)sampleRate, 4},
+        {28, (unsigned long)sampleRate*channels*(bits/8), 4}, {32, (unsigned long)channels*(bits/8), 2},
+        {34, (unsigned long)bits, 2}, {36, 22, 2}, {38, (unsigned long)bits, 2}, {44, (unsigned long)subTag, 2}};
+    memcpy(h, "RIFF", 4);
+    memcpy(h + 8, "WAVEfmt ", 8);
+    for (unsigned i = 0; i < sizeof(fields)/sizeof(fields[0]); i++) {
+        if (fields[i][0] >= 36 && tag != 0xFFFE) {
+            continue;
+        }
+        for (unsigned long b = 0, v = fields[i][1]; b < fields[i][2]; b++, v >>= 8) {
+            h[fields[i][0] + b] = (unsigned char)(v & 0xFF);
+        }
+    }
+    int dataAt = 20 + fmtSize;
+    memcpy(h + dataAt, "data", 4);
+    for (int b = 0; b < 4; b++) {
+        h[dataAt + 4 + b] = (unsigned char)((dataBytes >> (8*b)) & 0xFF);
+    }
+    fwrite(h, 1, dataAt + 8, f);
+}
+
+// Left: swept sine near full scale, right: a quieter sine
+double sampleAt(int ch, int i) {
+    double t = (double)i/sampleRate;
+    return ch ? 0.3*sin(2*M_PI*440*t) : 0.999*sin(2*M_PI*(100 + 400*t)*t);
+}
+
+// Writes the test signal as a stereo file; 16, 24, 32 bits of PCM or -32 for float
+void writeSignal(const char* path, int bits, bool header, bool extensible) {
+    FILE* f = fopen(path, "wb");
+    int bytes = (bits < 0) ? 4 : bits/8;
+    if (header) {
+        int tag = (bits < 0) ? 3 : 1;
+        if (extensible) {
+            writeHeader(f, 0xFFFE, tag, bytes*8, 2, numFrames);
+        } else {
+            writeHeader(f, tag, 0, bytes*8, 2, numFrames);
+        }
+    }
+    for (int i = 0; i < numFrames; i++) {
+        for (int ch = 0; ch < 2; ch++) {
+            double x = sampleAt(ch, i);
+            unsigned char b[4];
+            if (bits < 0) {
+                float v = (float)x;
+                memcpy(b, &v, 4);
+            } else {
+                long v = (long)floor(x*(1L << (bits - 1)));
+                for (int k = 0; k < bytes; k++) {
+                    b[k] = (unsigned char)((v >> (8*k)) & 0xFF);
+                }
+            }
+            fwrite(b, 1, bytes, f);
+        }
+    }
+    fclose(f);
+}
+
+// Largest difference between the file and the Q15 test signal
+int compare(MappedWav& wav, const char* name) {
+    int left[512], right[512];
+    int worst = 0;
+    long frame = 0;
+    int got;
+    clock_t start = clock();
+    while ((got = wav.read(left, right, blockLength)) > 0) {
+        for (int i = 0; i < got; i++, frame++) {
+            int l = (int)floor(sampleAt(0, (int)frame)*32768);
+            int r = (int)floor(sampleAt(1, (int)frame)*32768);
+            int d = max(abs(left[i] - l), abs(right[i] - r));
+            worst = max(worst, d);
+        }
+    }
+    double seconds = (double)(clock() - start)/CLOCKS_PER_SEC;
+    // The 16-bit read converts on its own and must give the same samples
+    int16_t left16[512], right16[512];
+    long mismatches = 0;
+    for (long f = 0; f < frame; f += blockLength) {
+        got = wav.read(f, left, right, blockLength);
+        wav.read(f, left16, right16, blockLength);
+        for (int i = 0; i < got; i++) {
+            mismatches += (left[i] != left16[i] || right[i] != right16[i]);
+        }
+    }
+    printf("%-12s %6ld frames, max error %d LSB (%.2f ms), %ld 16-bit mismatches\n", name, frame, worst, 1000*seconds, mismatches);
+    return (frame == numFrames && mismatches == 0) ? worst : 99999;
+}
+
+int main() {
+    cout<<endl<<"WavFile Testing: "<<endl<<endl;
+    writeSignal("/tmp/wav16.wav", 16, true, false);
+    writeSignal("/tmp/wav24.wav", 24, true, false);
+    writeSignal("/tmp/wav32.wav", 32, true, true);
+    writeSignal("/tmp/wavf.wav", -32, true, true);
+    writeSignal("/tmp/wav24.raw", 24, false, false);
+
+    MappedWav wav;
+    int worst = 0;
+    const char* files[] = {"/tmp/wav16.wav", "/tmp/wav24.wav", "/tmp/wav32.wav", "/tmp/wavf.wav"};
+    for (int n = 0; n < 4; n++) {
+        if (wav.open(files[n])) {
+            printf("%s: open failed\n", files[n]);
+            return 1;
+        }
+        worst = max(worst, compare(wav, files[n] + 5));
+    }
+    if (wav.openRaw("/tmp/wav24.raw", sampleRate, 2, SAMPLE_PCM24)) {
+        printf("raw open failed\n");
+        return 1;
+    }
+    worst = max(worst, compare(wav, "wav24.raw"));
+
+    // The mapped and streamed readers must agree on a 16-bit file, and the view must match both
+    WavReader reader;
+    reader.open("/tmp/wav16.wav");
+    wav.open("/tmp/wav16.wav");
+    const int16_t* view = wav.view(0);
+    int a[512], b[512], c[512], d[512];
+    long mismatches = 0;
+    long frame = 0;
+    int got;
+    while ((got = reader.read(a, b, blockLength)) > 0) {
+        wav.read(c, d, blockLength);
+        for (int i = 0; i < got; i++, frame++) {
+            if (a[i] != c[i] || b[i] != d[i] || (view && (view[2*frame] != a[i] || view[2*frame + 1] != b[i]))) {
+                mismatches++;
+            }
+        }
+    }
+    printf("WavReader vs MappedWav: %ld mismatches in %ld frames (view %s)\n",
+           mismatches, frame, view ? "checked" : "unavailable");
+    // Float (rounded) and truncated PCM differ from the floor() reference by at most one LSB
+    printf("%s\n", (worst <= 1 && mismatches == 0) ? "PASS" : "FAIL");
+    return (worst <= 1 && mismatches == 0) ? 0 : 1;
+}